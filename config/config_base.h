@@ -48,11 +48,30 @@
 #define CRYPTO_CONC_OPER_NUM                   8
 #endif
 
+/* The max number of concurrent operations a single owner can allocate in Crypto, 0 for no limit */
+#ifndef CRYPTO_CONC_OPER_QUOTA_PER_OWNER
+#define CRYPTO_CONC_OPER_QUOTA_PER_OWNER       0
+#endif
+
+/*
+ * The number of operation allocations and look-ups after which an unused
+ * operation of a non-secure client can be reclaimed by Crypto when all the
+ * operations are in use, 0 to never reclaim operations
+ */
+#ifndef CRYPTO_CONC_OPER_RECLAIM_AGE
+#define CRYPTO_CONC_OPER_RECLAIM_AGE           0
+#endif
+
 /* Enable PSA Crypto random number generator module */
 #ifndef CRYPTO_RNG_MODULE_ENABLED
 #define CRYPTO_RNG_MODULE_ENABLED              1
 #endif
 
+/* Size of the pool of random bytes used to serve small random requests, 0 to disable the pool */
+#ifndef CRYPTO_RNG_POOL_SIZE
+#define CRYPTO_RNG_POOL_SIZE                   0
+#endif
+
 /* Enable PSA Crypto Key module */
 #ifndef CRYPTO_KEY_MODULE_ENABLED
 #define CRYPTO_KEY_MODULE_ENABLED              1
@@ -98,6 +117,11 @@
 #define CRYPTO_IOVEC_BUFFER_SIZE               5120
 #endif
 
+/* Number of keys derived from builtin keys for their users cached by the builtin key loader */
+#ifndef CRYPTO_BUILTIN_KEY_CACHE_NUM
+#define CRYPTO_BUILTIN_KEY_CACHE_NUM           0
+#endif
+
 /* Use stored NV seed to provide entropy */
 #ifndef CRYPTO_NV_SEED
 #define CRYPTO_NV_SEED                         1
@@ -111,6 +135,14 @@
 #define CRYPTO_SINGLE_PART_FUNCS_DISABLED      0
 #endif
 
+/*
+ * Stream the inputs and outputs of single-part Hash, MAC and cipher encryption
+ * calls through the IOVec scratch buffer when they do not fit in it.
+ */
+#ifndef CRYPTO_IOVEC_STREAMING_ENABLED
+#define CRYPTO_IOVEC_STREAMING_ENABLED         1
+#endif
+
 /* The stack size of the Crypto Secure Partition */
 #ifndef CRYPTO_STACK_SIZE
 #define CRYPTO_STACK_SIZE                      0x1B00
@@ -164,11 +196,46 @@
 #define ITS_RAM_FS                             0
 #endif
 
+/* Count the reads, programs and erases done on the emulated RAM flash */
+#ifndef ITS_RAM_FS_STATS
+#define ITS_RAM_FS_STATS                       0
+#endif
+
+/* Append new file versions to the data blocks instead of compacting them */
+#ifndef ITS_LOG_STRUCTURED
+#define ITS_LOG_STRUCTURED                     0
+#endif
+
+/* Percentage of stale space in a data block that triggers its compaction */
+#ifndef ITS_LOG_STRUCTURED_GC_THRESHOLD
+#define ITS_LOG_STRUCTURED_GC_THRESHOLD        50
+#endif
+
 /* Validate filesystem metadata every time it is read from flash */
 #ifndef ITS_VALIDATE_METADATA_FROM_FLASH
 #define ITS_VALIDATE_METADATA_FROM_FLASH       1
 #endif
 
+/* Keep an index of the file IDs in RAM to avoid scanning the metadata in flash */
+#ifndef ITS_RAM_FILE_INDEX
+#define ITS_RAM_FILE_INDEX                     0
+#endif
+
+/* Keep the free file metadata entries and data block space in RAM */
+#ifndef ITS_RAM_FREE_SPACE_MAP
+#define ITS_RAM_FREE_SPACE_MAP                 0
+#endif
+
+/* Support setting and removing several assets in one metadata update */
+#ifndef ITS_TRANSACTION
+#define ITS_TRANSACTION                        0
+#endif
+
+/* The maximum number of operations in one ITS transaction */
+#ifndef ITS_TRANSACTION_MAX_OPS
+#define ITS_TRANSACTION_MAX_OPS                8
+#endif
+
 /* The maximum asset size to be stored in the Internal Trusted Storage */
 #ifndef ITS_MAX_ASSET_SIZE
 #define ITS_MAX_ASSET_SIZE                     512
@@ -202,6 +269,11 @@
 #define TFM_ITS_ENC_NONCE_LENGTH               12
 #endif
 
+/* The plaintext size of the chunks of encrypted ITS files, 0 to encrypt each file as a whole */
+#ifndef ITS_ENCRYPTION_CHUNK_SIZE
+#define ITS_ENCRYPTION_CHUNK_SIZE              0
+#endif
+
 /* PS Partition Configs */
 
 /* Create flash FS if it doesn't exist for Protected Storage partition */
@@ -224,6 +296,21 @@
 #define PS_VALIDATE_METADATA_FROM_FLASH        1
 #endif
 
+/* The number of object table updates coalesced into one table save */
+#ifndef PS_OBJ_TABLE_WRITE_BACK_UPDATES
+#define PS_OBJ_TABLE_WRITE_BACK_UPDATES        1
+#endif
+
+/* Keep a hash index of the object table entries by UID and client ID */
+#ifndef PS_OBJ_TABLE_INDEX
+#define PS_OBJ_TABLE_INDEX                     0
+#endif
+
+/* The size of the chunks of encrypted PS objects, 0 to encrypt each object as a whole */
+#ifndef PS_ENCRYPTION_CHUNK_SIZE
+#define PS_ENCRYPTION_CHUNK_SIZE               0
+#endif
+
 /* The maximum asset size to be stored in the Protected Storage */
 #ifndef PS_MAX_ASSET_SIZE
 #define PS_MAX_ASSET_SIZE                      2048
@@ -256,6 +343,21 @@
 #define MAILBOX_IS_UNCACHED_NS                 1
 #endif
 
+/* The number of mailbox messages handled by SPE mailbox at the same time */
+#ifndef NUM_MAILBOX_SPE_QUEUE_SLOT
+#define NUM_MAILBOX_SPE_QUEUE_SLOT             NUM_MAILBOX_QUEUE_SLOT
+#endif
+
+/* The maximum number of PSA client calls in a batch mailbox message */
+#ifndef MAILBOX_MAX_BATCH_CALLS
+#define MAILBOX_MAX_BATCH_CALLS                16
+#endif
+
+/* The maximum number of mailbox replies notified to NSPE at once */
+#ifndef MAILBOX_REPLY_COALESCE_THRESHOLD
+#define MAILBOX_REPLY_COALESCE_THRESHOLD       1
+#endif
+
 /* SPM Configs */
 
 #ifdef CONFIG_TFM_CONNECTION_POOL_ENABLE
@@ -263,6 +365,26 @@
 #ifndef CONFIG_TFM_CONN_HANDLE_MAX_NUM
 #define CONFIG_TFM_CONN_HANDLE_MAX_NUM          8
 #endif
+
+/* The maximal number of connections held by a secure partition. 0 for no limit */
+#ifndef CONFIG_TFM_CONN_QUOTA_PER_PARTITION
+#define CONFIG_TFM_CONN_QUOTA_PER_PARTITION     0
+#endif
+
+/* The maximal number of connections held by a non-secure client. 0 for no limit */
+#ifndef CONFIG_TFM_CONN_QUOTA_PER_NS_CLIENT
+#define CONFIG_TFM_CONN_QUOTA_PER_NS_CLIENT     0
+#endif
+#endif
+
+/* The number of validated IOVEC regions cached by SPM. 0 disables the cache */
+#ifndef CONFIG_TFM_IOVEC_CHECK_CACHE_NUM
+#define CONFIG_TFM_IOVEC_CHECK_CACHE_NUM        0
+#endif
+
+/* The minimal size in bytes of the SPM copies offloaded to the platform copy engine */
+#ifndef CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE
+#define CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE     1024
 #endif
 
 /* Disable the doorbell APIs */
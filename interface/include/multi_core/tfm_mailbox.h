@@ -54,6 +54,7 @@ extern "C" {
 #define MAILBOX_PSA_CONNECT                 (0x3)
 #define MAILBOX_PSA_CALL                    (0x4)
 #define MAILBOX_PSA_CLOSE                   (0x5)
+#define MAILBOX_PSA_CALL_BATCH              (0x6)
 
 /* Return code of mailbox APIs */
 #define MAILBOX_SUCCESS                     (0)
@@ -66,6 +67,23 @@ extern "C" {
 #define MAILBOX_INIT_ERROR                  (INT32_MIN + 7)
 #define MAILBOX_GENERIC_ERROR               (INT32_MIN + 8)
 
+/*
+ * A psa_call() in a batch of PSA client calls delivered in a single mailbox
+ * message. SPE passes the calls in a batch into SPM one after another.
+ */
+struct mailbox_batch_call_t {
+    psa_handle_t    handle;
+    int32_t         type;
+    const psa_invec *in_vec;
+    size_t          in_len;
+    psa_outvec      *out_vec;
+    size_t          out_len;
+
+    psa_status_t    status;     /* PSA client call return result written by
+                                 * SPE
+                                 */
+};
+
 /*
  * This structure holds the parameters used in a PSA client call.
  */
@@ -92,6 +110,11 @@ struct psa_client_params_t {
         struct {
             psa_handle_t    handle;
         } psa_close_params;
+
+        struct {
+            struct mailbox_batch_call_t *calls;
+            uint32_t                    nr_calls;
+        } psa_call_batch_params;
     };
 };
 
@@ -150,6 +173,55 @@ struct mailbox_status_t {
                                                  */
 } MAILBOX_ALIGN;
 
+#ifdef MAILBOX_RING_TRANSPORT
+/*
+ * Number of entries in a mailbox ring.
+ * A slot sits in at most one ring at a time so that a ring never overflows.
+ */
+#define MAILBOX_RING_SIZE                   NUM_MAILBOX_QUEUE_SLOT
+
+/*
+ * Head and tail indices run from 0 to (2 * MAILBOX_RING_SIZE - 1), so that a
+ * full ring can be told apart from an empty one.
+ */
+#define MAILBOX_RING_NEXT(ring_idx)         \
+            (((ring_idx) + 1) % (2 * MAILBOX_RING_SIZE))
+#define MAILBOX_RING_COUNT(head, tail)      \
+            (((head) + (2 * MAILBOX_RING_SIZE) - (tail)) % (2 * MAILBOX_RING_SIZE))
+#define MAILBOX_RING_ENTRY(ring_idx)        ((ring_idx) % MAILBOX_RING_SIZE)
+
+/*
+ * A ring index.
+ * Each index is written by a single core only and sits in its own cache line,
+ * so that cache maintenance on one core never drops an update from the other.
+ */
+struct mailbox_ring_idx_t {
+    volatile uint32_t val;
+} MAILBOX_ALIGN;
+
+/* Single-producer/single-consumer ring of NSPE mailbox queue slot indices */
+struct mailbox_ring_t {
+    struct mailbox_ring_idx_t head;                     /* Written by producer */
+    struct mailbox_ring_idx_t tail;                     /* Written by consumer */
+    uint8_t entries[MAILBOX_RING_SIZE] MAILBOX_ALIGN;   /* Written by producer */
+} MAILBOX_ALIGN;
+
+/*
+ * NSPE mailbox rings shared between TF-M and mailbox client.
+ * They replace the bitmasks in struct mailbox_status_t, so that neither core
+ * needs a critical section between cores to submit or complete a message.
+ */
+struct mailbox_rings_t {
+    struct mailbox_ring_t req;      /* Slots pending for SPE handling.
+                                     * Produced by NSPE, consumed by SPE.
+                                     */
+    struct mailbox_ring_t reply;    /* Slots containing PSA client call return
+                                     * result.
+                                     * Produced by SPE, consumed by NSPE.
+                                     */
+} MAILBOX_ALIGN;
+#endif /* MAILBOX_RING_TRANSPORT */
+
 /*
  * Data used to send information to mailbox partition about mailbox queue allocated by non-secure image.
  * It's expected that data in this structure is not modified by the secure side.
@@ -163,6 +235,11 @@ struct mailbox_init_t {
 
     /* Pointer to struct mailbox_slot_t[slot_count] allocated by NS */
     struct mailbox_slot_t *slots;
+
+#ifdef MAILBOX_RING_TRANSPORT
+    /* Request and reply rings allocated by NS */
+    struct mailbox_rings_t *rings;
+#endif
 };
 
 #ifdef __cplusplus
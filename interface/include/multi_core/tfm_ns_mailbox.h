@@ -64,6 +64,9 @@ struct ns_mailbox_slot_t {
 struct ns_mailbox_queue_t {
     struct mailbox_status_t status MAILBOX_ALIGN;
     struct mailbox_slot_t slots[NUM_MAILBOX_QUEUE_SLOT];
+#ifdef MAILBOX_RING_TRANSPORT
+    struct mailbox_rings_t rings MAILBOX_ALIGN;
+#endif
 
     /* Following data are not shared with secure */
     struct ns_mailbox_slot_t slots_ns[NUM_MAILBOX_QUEUE_SLOT] MAILBOX_ALIGN;
@@ -116,6 +119,25 @@ int32_t tfm_ns_mailbox_client_call(uint32_t call_type,
                                    int32_t client_id,
                                    int32_t *reply);
 
+/**
+ * \brief Send a batch of psa_call() to SPE in a single mailbox message. SPE
+ *        completes the calls one after another, in order.
+ *
+ * \param[in,out] calls         The calls to be made. The status of each call
+ *                              is written with its PSA client call result.
+ * \param[in] nr_calls          The number of calls. It must not exceed
+ *                              MAILBOX_MAX_BATCH_CALLS set in SPE.
+ *
+ * \retval PSA_SUCCESS          All the calls are completed. Check the status
+ *                              of each call.
+ * \retval PSA_ERROR_INVALID_ARGUMENT
+ *                              The batch is rejected. None of the calls is
+ *                              made.
+ * \retval Other return code    Operation failed with an error code.
+ */
+psa_status_t tfm_psa_call_batch(struct mailbox_batch_call_t *calls,
+                                uint32_t nr_calls);
+
 #ifdef TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD
 /**
  * \brief Handling PSA client calls in a dedicated NS mailbox thread.
@@ -390,6 +412,59 @@ static inline mailbox_queue_status_t clear_queue_slot_all_replied(
     return status;
 }
 
+#ifdef MAILBOX_RING_TRANSPORT
+/*
+ * The following inline functions exchange mailbox queue slots with SPE via
+ * the mailbox rings. NSPE is the only producer of the request ring and the
+ * only consumer of the reply ring.
+ */
+static inline bool push_queue_slot_req(struct ns_mailbox_queue_t *queue_ptr,
+                                       uint8_t idx)
+{
+    struct mailbox_ring_t *ring = &queue_ptr->rings.req;
+    uint32_t head = ring->head.val;
+    uint8_t *entry = &ring->entries[MAILBOX_RING_ENTRY(head)];
+
+    MAILBOX_INVALIDATE_CACHE(&ring->tail, sizeof(ring->tail));
+    if (MAILBOX_RING_COUNT(head, ring->tail.val) >= MAILBOX_RING_SIZE) {
+        return false;
+    }
+
+    /* The entry must reach SPE before the head index moves past it */
+    *entry = idx;
+    MAILBOX_CLEAN_CACHE(entry, sizeof(*entry));
+    __DMB();
+
+    ring->head.val = MAILBOX_RING_NEXT(head);
+    MAILBOX_CLEAN_CACHE(&ring->head, sizeof(ring->head));
+
+    return true;
+}
+
+static inline bool pop_queue_slot_replied(struct ns_mailbox_queue_t *queue_ptr,
+                                          uint8_t *idx)
+{
+    struct mailbox_ring_t *ring = &queue_ptr->rings.reply;
+    uint32_t tail = ring->tail.val;
+    uint8_t *entry = &ring->entries[MAILBOX_RING_ENTRY(tail)];
+
+    MAILBOX_INVALIDATE_CACHE(&ring->head, sizeof(ring->head));
+    if (ring->head.val == tail) {
+        return false;
+    }
+
+    /* Don't read the entry before the head index which covers it */
+    __DMB();
+    MAILBOX_INVALIDATE_CACHE(entry, sizeof(*entry));
+    *idx = *entry;
+
+    ring->tail.val = MAILBOX_RING_NEXT(tail);
+    MAILBOX_CLEAN_CACHE(&ring->tail, sizeof(ring->tail));
+
+    return true;
+}
+#endif /* MAILBOX_RING_TRANSPORT */
+
 #ifdef __cplusplus
 }
 #endif
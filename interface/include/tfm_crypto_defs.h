@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -36,6 +36,16 @@ struct tfm_crypto_aead_pack_input {
     uint32_t nonce_length;
 };
 
+/**
+ * \brief A message in a batch of messages hashed by a single call to
+ *        \ref tfm_crypto_hash_compute_batch. The message is located in the
+ *        data buffer of the batch.
+ */
+struct tfm_crypto_hash_batch_msg {
+    uint32_t offset;         /*!< Offset of the message in the data buffer */
+    uint32_t length;         /*!< Length of the message */
+};
+
 /**
  * \brief Structure used to pack non-pointer types in a call to PSA Crypto APIs
  *
@@ -103,7 +113,8 @@ enum tfm_crypto_group_id_t {
     X(TFM_CRYPTO_HASH_CLONE)                       \
     X(TFM_CRYPTO_HASH_FINISH)                      \
     X(TFM_CRYPTO_HASH_VERIFY)                      \
-    X(TFM_CRYPTO_HASH_ABORT)
+    X(TFM_CRYPTO_HASH_ABORT)                       \
+    X(TFM_CRYPTO_HASH_COMPUTE_BATCH)
 
 #define MAC_FUNCS                                  \
     X(TFM_CRYPTO_MAC_COMPUTE)                      \
@@ -207,6 +218,46 @@ enum tfm_crypto_func_sid_t {
 #define TFM_CRYPTO_GET_GROUP_ID(_function_id) \
     ((enum tfm_crypto_group_id_t)(((uint16_t)(_function_id) >> 8) & 0xFF))
 
+/**
+ * \brief Calculate the hashes of a batch of messages in a single call to the
+ *        TF-M Crypto service. This is equivalent to calling psa_hash_compute()
+ *        on each message, without paying the cost of a call for each.
+ *
+ * \param[in]  alg           The hash algorithm to compute
+ * \param[in]  msgs          Array of messages to hash, located in \p data
+ * \param[in]  msg_count     Number of messages in \p msgs
+ * \param[in]  data          Buffer containing the messages
+ * \param[in]  data_length   Size of the \p data buffer in bytes
+ * \param[out] hashes        Buffer where the hashes are written one after
+ *                           another, in the order of \p msgs. Each hash is
+ *                           PSA_HASH_LENGTH(\p alg) bytes long.
+ * \param[in]  hashes_size   Size of the \p hashes buffer in bytes
+ * \param[out] hashes_length On success, the number of bytes that make up
+ *                           the hashes
+ *
+ * \return Return values as described in \ref psa_status_t. In particular
+ *         PSA_ERROR_INVALID_ARGUMENT is returned if a message is not within
+ *         \p data and PSA_ERROR_BUFFER_TOO_SMALL if \p hashes_size cannot
+ *         hold all the hashes.
+ */
+psa_status_t tfm_crypto_hash_compute_batch(psa_algorithm_t alg,
+                                           const struct tfm_crypto_hash_batch_msg *msgs,
+                                           size_t msg_count,
+                                           const uint8_t *data,
+                                           size_t data_length,
+                                           uint8_t *hashes,
+                                           size_t hashes_size,
+                                           size_t *hashes_length);
+
+/**
+ * \brief Erase the cache of random bytes kept by the client when
+ *        CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE is greater than 0. It must be called
+ *        whenever the contents of the cache could be duplicated or reused,
+ *        e.g. after a fork or a restore from a snapshot. It has no effect if
+ *        the cache is not enabled.
+ */
+void tfm_crypto_random_cache_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,12 @@
 #ifndef __TFM_ITS_DEFS_H__
 #define __TFM_ITS_DEFS_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+#include "psa/storage_common.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,6 +26,71 @@ extern "C" {
 #define TFM_ITS_GET                1002
 #define TFM_ITS_GET_INFO           1003
 #define TFM_ITS_REMOVE             1004
+#define TFM_ITS_TRANSACTION        1005
+
+/* Operation types of the entries of an ITS transaction */
+#define TFM_ITS_TRANSACTION_OP_SET     1
+#define TFM_ITS_TRANSACTION_OP_REMOVE  2
+
+/**
+ * \brief Structure describing one operation of an ITS transaction. The data of
+ *        the set operations is passed separately, concatenated in the order of
+ *        the operations.
+ */
+struct tfm_its_transaction_op_t {
+    psa_storage_uid_t uid;                   /*!< The identifier of the data */
+    uint32_t type;                           /*!< TFM_ITS_TRANSACTION_OP_* */
+    psa_storage_create_flags_t create_flags; /*!< Flags of a set operation */
+    uint32_t data_length;                    /*!< Data size of a set operation */
+};
+
+/**
+ * \brief Sets and removes several uid/value pairs atomically
+ *
+ * Applies all the operations in a single update of the internal trusted
+ * storage: either all of them take effect or none does. Each operation applies
+ * to the uid as left by the earlier operations, so when several operations
+ * refer to the same uid, the last one applies. For instance, a uid set and
+ * then removed by the same call is not stored, and a uid set with
+ * PSA_STORAGE_FLAG_WRITE_ONCE cannot be changed by the later operations.
+ *
+ * \param[in] ops          Array of operations
+ * \param[in] num_ops      Number of operations in `ops`
+ * \param[in] p_data       Data of the set operations, concatenated in the
+ *                         order of the operations
+ * \param[in] data_length  Size in bytes of `p_data`. Must be the sum of the
+ *                         data sizes of the set operations.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_NOT_PERMITTED         The operation failed because one of
+ *                                         the uids was created with
+ *                                         PSA_STORAGE_FLAG_WRITE_ONCE
+ * \retval PSA_ERROR_DOES_NOT_EXIST        The operation failed because a uid
+ *                                         to remove was not found in the
+ *                                         storage
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because
+ *                                         transactions are not enabled, one
+ *                                         of the flags is not supported, or
+ *                                         the assets to replace are spread
+ *                                         over too many data blocks
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because there
+ *                                         was insufficient space on the
+ *                                         storage medium
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because one of
+ *                                         the arguments is invalid, or the
+ *                                         data does not fit in the internal
+ *                                         buffer of the service
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ */
+psa_status_t tfm_its_commit_transaction(
+                                    const struct tfm_its_transaction_op_t *ops,
+                                    size_t num_ops,
+                                    const void *p_data,
+                                    size_t data_length);
 
 #ifdef __cplusplus
 }
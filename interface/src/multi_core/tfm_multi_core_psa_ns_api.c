@@ -116,6 +116,26 @@ psa_status_t psa_call(psa_handle_t handle, int32_t type,
     return status;
 }
 
+psa_status_t tfm_psa_call_batch(struct mailbox_batch_call_t *calls,
+                                uint32_t nr_calls)
+{
+    struct psa_client_params_t params;
+    int32_t ret;
+    psa_status_t status;
+
+    params.psa_call_batch_params.calls = calls;
+    params.psa_call_batch_params.nr_calls = nr_calls;
+
+    ret = tfm_ns_mailbox_client_call(MAILBOX_PSA_CALL_BATCH, &params,
+                                     NON_SECURE_CLIENT_ID,
+                                     (int32_t *)&status);
+    if (ret != MAILBOX_SUCCESS) {
+        status = PSA_INTER_CORE_COMM_ERR;
+    }
+
+    return status;
+}
+
 void psa_close(psa_handle_t handle)
 {
     struct psa_client_params_t params;
@@ -49,7 +49,7 @@ static inline void clear_queue_slot_woken(uint8_t idx)
     }
 }
 
-#ifndef TFM_MULTI_CORE_NS_OS
+#if !defined(TFM_MULTI_CORE_NS_OS) && !defined(MAILBOX_RING_TRANSPORT)
 static inline void clear_queue_slot_replied(uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
@@ -71,7 +71,7 @@ static inline bool is_queue_slot_replied(uint8_t idx)
 
     return false;
 }
-#endif /* !defined TFM_MULTI_CORE_NS_OS */
+#endif /* !defined TFM_MULTI_CORE_NS_OS && !defined MAILBOX_RING_TRANSPORT */
 
 static uint8_t acquire_empty_slot(struct ns_mailbox_queue_t *queue)
 {
@@ -114,6 +114,9 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
     uint8_t idx;
     struct mailbox_msg_t *msg_ptr;
     const void *task_handle;
+#ifdef MAILBOX_RING_TRANSPORT
+    bool is_pushed;
+#endif
 
     idx = acquire_empty_slot(mailbox_queue_ptr);
     if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
@@ -132,6 +135,13 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
     msg_ptr->client_id = client_id;
     MAILBOX_CLEAN_CACHE(msg_ptr, sizeof(*msg_ptr));
 
+    /* SPE reads the calls in a batch from NSPE memory */
+    if (call_type == MAILBOX_PSA_CALL_BATCH) {
+        MAILBOX_CLEAN_CACHE(params->psa_call_batch_params.calls,
+                            params->psa_call_batch_params.nr_calls *
+                            sizeof(*params->psa_call_batch_params.calls));
+    }
+
     /*
      * Fetch the current task handle. The task will be woken up according the
      * handle value set in the owner field.
@@ -139,9 +149,27 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
     task_handle = tfm_ns_mailbox_os_get_task_handle();
     set_msg_owner(idx, task_handle);
 
+#ifdef MAILBOX_RING_TRANSPORT
+    /* NS local lock keeps a single producer on the request ring */
+    tfm_ns_mailbox_os_spin_lock();
+    is_pushed = push_queue_slot_req(mailbox_queue_ptr, idx);
+    tfm_ns_mailbox_os_spin_unlock();
+
+    if (!is_pushed) {
+        /* Only happens if SPE corrupted the request ring tail index */
+        set_msg_owner(idx, NULL);
+
+        tfm_ns_mailbox_os_spin_lock();
+        set_queue_slot_empty(idx);
+        tfm_ns_mailbox_os_spin_unlock();
+
+        return MAILBOX_GENERIC_ERROR;
+    }
+#else
     tfm_ns_mailbox_hal_enter_critical();
     set_queue_slot_pend(mailbox_queue_ptr, idx);
     tfm_ns_mailbox_hal_exit_critical();
+#endif
 
     tfm_ns_mailbox_hal_notify_peer();
 
@@ -207,6 +235,13 @@ int32_t tfm_ns_mailbox_client_call(uint32_t call_type,
         *reply = reply_buf;
     }
 
+    /* SPE has written the results of the calls in a batch */
+    if (call_type == MAILBOX_PSA_CALL_BATCH) {
+        MAILBOX_INVALIDATE_CACHE(params->psa_call_batch_params.calls,
+                                 params->psa_call_batch_params.nr_calls *
+                                 sizeof(*params->psa_call_batch_params.calls));
+    }
+
 exit:
     if (tfm_ns_mailbox_os_lock_release() != MAILBOX_SUCCESS) {
         return MAILBOX_GENERIC_ERROR;
@@ -216,6 +251,48 @@ exit:
 }
 
 #ifdef TFM_MULTI_CORE_NS_OS
+static void mailbox_wake_reply_owner(uint8_t idx)
+{
+    /* Set woken-up flag */
+    tfm_ns_mailbox_os_spin_lock();
+    set_queue_slot_woken(idx);
+    tfm_ns_mailbox_os_spin_unlock();
+
+    tfm_ns_mailbox_os_wake_task_isr(mailbox_queue_ptr->slots_ns[idx].owner);
+}
+
+#ifdef MAILBOX_RING_TRANSPORT
+int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
+{
+    uint8_t idx;
+    bool is_replied = false;
+
+    if (!mailbox_queue_ptr) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    /*
+     * This handler is the only consumer of the reply ring. No critical section
+     * between cores is required.
+     * Drain the whole ring, including the replies pushed by SPE while earlier
+     * ones are handled here.
+     */
+    while (pop_queue_slot_replied(mailbox_queue_ptr, &idx)) {
+        if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
+            continue;
+        }
+
+        mailbox_wake_reply_owner(idx);
+        is_replied = true;
+    }
+
+    if (!is_replied) {
+        return MAILBOX_NO_PEND_EVENT;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+#else /* MAILBOX_RING_TRANSPORT */
 int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
 {
     uint8_t idx;
@@ -233,31 +310,37 @@ int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        /*
-         * The reply has already received from SPE mailbox but
-         * the wake-up signal is not sent yet.
-         */
-        if (!(replied_status & (0x1UL << idx))) {
-            continue;
+    /*
+     * SPE may notify a burst of replies at once and keep replying while they
+     * are handled here. Drain the replied status until it is empty, so that
+     * those replies don't wait for another notification.
+     */
+    do {
+        for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
+            /*
+             * The reply has already received from SPE mailbox but
+             * the wake-up signal is not sent yet.
+             */
+            if (!(replied_status & (0x1UL << idx))) {
+                continue;
+            }
+
+            mailbox_wake_reply_owner(idx);
+
+            replied_status &= ~(0x1UL << idx);
+            if (!replied_status) {
+                break;
+            }
         }
 
-        /* Set woken-up flag */
-        tfm_ns_mailbox_os_spin_lock();
-        set_queue_slot_woken(idx);
-        tfm_ns_mailbox_os_spin_unlock();
-
-        tfm_ns_mailbox_os_wake_task_isr(
-                                     mailbox_queue_ptr->slots_ns[idx].owner);
-
-        replied_status &= ~(0x1UL << idx);
-        if (!replied_status) {
-            break;
-        }
-    }
+        tfm_ns_mailbox_hal_enter_critical_isr();
+        replied_status = clear_queue_slot_all_replied(mailbox_queue_ptr);
+        tfm_ns_mailbox_hal_exit_critical_isr();
+    } while (replied_status);
 
     return MAILBOX_SUCCESS;
 }
+#endif /* MAILBOX_RING_TRANSPORT */
 
 static inline bool mailbox_wait_reply_signal(uint8_t idx)
 {
@@ -274,6 +357,23 @@ static inline bool mailbox_wait_reply_signal(uint8_t idx)
 
     return is_set;
 }
+#elif defined(MAILBOX_RING_TRANSPORT)
+static inline bool mailbox_wait_reply_signal(uint8_t idx)
+{
+    uint8_t replied_idx;
+
+    /* Drain the reply ring since NSPE bare metal polls it as the consumer */
+    while (pop_queue_slot_replied(mailbox_queue_ptr, &replied_idx)) {
+        set_queue_slot_woken(replied_idx);
+    }
+
+    if (is_queue_slot_woken(idx)) {
+        clear_queue_slot_woken(idx);
+        return true;
+    }
+
+    return false;
+}
 #else /* TFM_MULTI_CORE_NS_OS */
 static inline bool mailbox_wait_reply_signal(uint8_t idx)
 {
@@ -340,6 +440,11 @@ int32_t tfm_ns_mailbox_init(struct ns_mailbox_queue_t *queue)
     queue->empty_slots +=
             (mailbox_queue_status_t)(1UL << (NUM_MAILBOX_QUEUE_SLOT - 1));
 
+#ifdef MAILBOX_RING_TRANSPORT
+    /* Both rings start empty */
+    MAILBOX_CLEAN_CACHE(&queue->rings, sizeof(queue->rings));
+#endif
+
     mailbox_queue_ptr = queue;
 
     /* Platform specific initialization. */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -534,6 +534,38 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_compute)(psa_algorithm_t alg,
     return status;
 }
 
+psa_status_t tfm_crypto_hash_compute_batch(psa_algorithm_t alg,
+                                           const struct tfm_crypto_hash_batch_msg *msgs,
+                                           size_t msg_count,
+                                           const uint8_t *data,
+                                           size_t data_length,
+                                           uint8_t *hashes,
+                                           size_t hashes_size,
+                                           size_t *hashes_length)
+{
+    psa_status_t status;
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_HASH_COMPUTE_BATCH_SID,
+        .alg = alg,
+    };
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+        {.base = msgs, .len = msg_count * sizeof(struct tfm_crypto_hash_batch_msg)},
+        {.base = data, .len = data_length},
+    };
+
+    psa_outvec out_vec[] = {
+        {.base = hashes, .len = hashes_size}
+    };
+
+    status = API_DISPATCH(in_vec, out_vec);
+
+    *hashes_length = out_vec[0].len;
+
+    return status;
+}
+
 TFM_CRYPTO_API(psa_status_t, psa_hash_compare)(psa_algorithm_t alg,
                                                const uint8_t *input,
                                                size_t input_length,
@@ -1385,6 +1417,86 @@ TFM_CRYPTO_API(psa_status_t, psa_key_derivation_key_agreement)(
     return API_DISPATCH_NO_OUTVEC(in_vec);
 }
 
+/*!
+ * \def CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE
+ *
+ * \brief By setting this to a value greater than 0, the client keeps a cache
+ *        of random bytes of this size, refilled by a single call to the TF-M
+ *        Crypto service. Requests of up to a quarter of the cache size are
+ *        served from the cache without calling the service. Bytes are erased
+ *        from the cache as soon as they are handed out. The cache must be
+ *        flushed with tfm_crypto_random_cache_flush() whenever its contents
+ *        could be duplicated or reused, e.g. after a fork or a restore from a
+ *        snapshot.
+ *
+ *        The cache is shared by all the callers of psa_generate_random(). The
+ *        integration must define TFM_CRYPTO_RNG_CACHE_LOCK() and
+ *        TFM_CRYPTO_RNG_CACHE_UNLOCK() to serialise the accesses to the cache,
+ *        so that two callers never get the same bytes.
+ *
+ * \note  This config option is not available through the TF-M configuration as
+ *        it's for NS applications and system integrators to enable.
+ */
+#if CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE > 0
+#if !defined(TFM_CRYPTO_RNG_CACHE_LOCK) || !defined(TFM_CRYPTO_RNG_CACHE_UNLOCK)
+#error "TFM_CRYPTO_RNG_CACHE_LOCK() and TFM_CRYPTO_RNG_CACHE_UNLOCK() must be defined to use the random cache"
+#endif
+
+static struct {
+    uint8_t buf[CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE];
+    size_t index;                      /* Index of the first unused byte */
+} rng_cache = {.buf = {0}, .index = CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE};
+
+static psa_status_t tfm_crypto_random_cache_draw(uint8_t *output,
+                                                 size_t output_size)
+{
+    psa_status_t status = PSA_SUCCESS;
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_GENERATE_RANDOM_SID,
+    };
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+    };
+
+    psa_outvec out_vec[] = {
+        {.base = rng_cache.buf, .len = sizeof(rng_cache.buf)},
+    };
+
+    TFM_CRYPTO_RNG_CACHE_LOCK();
+
+    if ((sizeof(rng_cache.buf) - rng_cache.index) < output_size) {
+        /* The unused bytes left are overwritten by the refill */
+        status = API_DISPATCH(in_vec, out_vec);
+        if (status != PSA_SUCCESS) {
+            memset(rng_cache.buf, 0, sizeof(rng_cache.buf));
+            rng_cache.index = sizeof(rng_cache.buf);
+            TFM_CRYPTO_RNG_CACHE_UNLOCK();
+            return status;
+        }
+        rng_cache.index = 0;
+    }
+
+    memcpy(output, &rng_cache.buf[rng_cache.index], output_size);
+    memset(&rng_cache.buf[rng_cache.index], 0, output_size);
+    rng_cache.index += output_size;
+
+    TFM_CRYPTO_RNG_CACHE_UNLOCK();
+
+    return status;
+}
+#endif /* CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE > 0 */
+
+void tfm_crypto_random_cache_flush(void)
+{
+#if CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE > 0
+    TFM_CRYPTO_RNG_CACHE_LOCK();
+    memset(rng_cache.buf, 0, sizeof(rng_cache.buf));
+    rng_cache.index = sizeof(rng_cache.buf);
+    TFM_CRYPTO_RNG_CACHE_UNLOCK();
+#endif
+}
+
 TFM_CRYPTO_API(psa_status_t, psa_generate_random)(uint8_t *output,
                                                   size_t output_size)
 {
@@ -1404,6 +1516,12 @@ TFM_CRYPTO_API(psa_status_t, psa_generate_random)(uint8_t *output,
         return PSA_SUCCESS;
     }
 
+#if CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE > 0
+    if (output_size <= (CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE / 4)) {
+        return tfm_crypto_random_cache_draw(output, output_size);
+    }
+#endif
+
     return API_DISPATCH(in_vec, out_vec);
 }
 
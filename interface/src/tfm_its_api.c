@@ -91,3 +91,22 @@ psa_status_t psa_its_remove(psa_storage_uid_t uid)
 
     return status;
 }
+
+psa_status_t tfm_its_commit_transaction(
+                                    const struct tfm_its_transaction_op_t *ops,
+                                    size_t num_ops,
+                                    const void *p_data,
+                                    size_t data_length)
+{
+    psa_status_t status;
+
+    psa_invec in_vec[] = {
+        { .base = ops, .len = num_ops * sizeof(*ops) },
+        { .base = p_data, .len = data_length }
+    };
+
+    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                      TFM_ITS_TRANSACTION, in_vec, IOVEC_LEN(in_vec), NULL, 0);
+
+    return status;
+}
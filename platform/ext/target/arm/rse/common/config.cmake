@@ -33,6 +33,7 @@ set(PLATFORM_DEFAULT_SYSTEM_RESET_HALT  OFF        CACHE BOOL     "Use default s
 set(PLATFORM_HAS_BOOT_DMA               ON         CACHE BOOL     "Enable dma support for memory transactions for bootloader")
 set(PLATFORM_BOOT_DMA_MIN_SIZE_REQ      0x40       CACHE STRING   "Minimum transaction size (in bytes) required to enable dma support for bootloader")
 set(PLATFORM_SVC_HANDLERS               ON         CACHE BOOL     "Platform supports custom SVC handlers")
+set(CONFIG_TFM_SPM_COPY_ENGINE          ON         CACHE BOOL     "Whether SPM offloads large copies of client data to the platform copy engine")
 set(PLATFORM_ERROR_CODES                ON         CACHE BOOL     "Whether to use platform-specific error codes.")
 
 set(BL1                                 ON         CACHE BOOL     "Whether to build BL1")
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,26 +10,18 @@
 #include "dma350_privileged_config.h"
 #include "dma350_lib.h"
 #include "device_definition.h"
-#include "utilities.h"
+#include "tfm_hal_platform.h"
 
-#ifndef RSE_DMA_MIN_SIZE
-#define RSE_DMA_MIN_SIZE 1024
-#endif /* RSE_DMA_MIN_SIZE */
-
-void *spm_dma_memcpy(void *dest, const void *src, size_t n)
+enum tfm_hal_status_t tfm_hal_copy_engine_memcpy(void *dest, const void *src,
+                                                 size_t n)
 {
     enum dma350_lib_error_t err;
 
-    if (n < RSE_DMA_MIN_SIZE) {
-        return memcpy(dest, src, n);
-    } else {
-        err = dma350_memcpy(&DMA350_DMA0_CH0_DEV_S, (void *)src, dest, n,
-                            DMA350_LIB_EXEC_BLOCKING);
-        if (err != DMA350_LIB_ERR_NONE) {
-            /* Memcpy can't return an error, so this the only option */
-            tfm_core_panic();
-        }
-
-        return dest;
+    err = dma350_memcpy(&DMA350_DMA0_CH0_DEV_S, (void *)src, dest, n,
+                        DMA350_LIB_EXEC_BLOCKING);
+    if (err != DMA350_LIB_ERR_NONE) {
+        return TFM_HAL_ERROR_GENERIC;
     }
+
+    return TFM_HAL_SUCCESS;
 }
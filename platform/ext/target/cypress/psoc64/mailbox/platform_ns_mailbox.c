@@ -85,6 +85,9 @@ int32_t tfm_ns_mailbox_hal_init(struct ns_mailbox_queue_t *queue)
     ns_init.status = &queue->status;
     ns_init.slot_count = NUM_MAILBOX_QUEUE_SLOT;
     ns_init.slots = &queue->slots[0];
+#ifdef MAILBOX_RING_TRANSPORT
+    ns_init.rings = &queue->rings;
+#endif
     platform_mailbox_send_msg_ptr(&ns_init);
 
     /* Wait until SPE mailbox service is ready */
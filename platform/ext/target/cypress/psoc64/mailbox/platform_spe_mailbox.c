@@ -69,6 +69,9 @@ int32_t tfm_mailbox_hal_init(struct secure_mailbox_queue_t *s_queue)
     s_queue->ns_status = ns_init->status;
     s_queue->ns_slot_count = ns_init->slot_count;
     s_queue->ns_slots = ns_init->slots;
+#ifdef MAILBOX_RING_TRANSPORT
+    s_queue->ns_rings = ns_init->rings;
+#endif
 
     mailbox_ipc_config();
 
@@ -10,6 +10,7 @@
 #ifndef __TFM_HAL_MAILBOX_H__
 #define __TFM_HAL_MAILBOX_H__
 
+#include "config_tfm.h"
 #include "tfm_mailbox.h"
 
 /* A handle to a mailbox message in use */
@@ -32,18 +33,41 @@ struct secure_mailbox_slot_t {
 
     uint8_t              ns_slot_idx;
     mailbox_msg_handle_t msg_handle;
+
+    /* Progress of a MAILBOX_PSA_CALL_BATCH message */
+    uint32_t             batch_idx;     /* Index of the call in progress */
+    int32_t              client_id;     /* Translated client ID */
+    bool                 is_batch_pending; /* Next call to be passed in */
 };
 
 struct secure_mailbox_queue_t {
-    mailbox_queue_status_t       empty_slots;      /* bitmask of empty slots */
+    /* Stack of the indices of free slots in queue */
+    uint8_t                      free_slots[NUM_MAILBOX_SPE_QUEUE_SLOT];
+    uint8_t                      nr_free_slots;
 
-    struct secure_mailbox_slot_t queue[NUM_MAILBOX_QUEUE_SLOT];
+    /*
+     * Slots of the mailbox messages in progress. They are independent of the
+     * NSPE mailbox queue slots.
+     */
+    struct secure_mailbox_slot_t queue[NUM_MAILBOX_SPE_QUEUE_SLOT];
     /* Shared data with fixed size */
     struct mailbox_status_t       *ns_status;
     /* Number of slots allocated by NS. */
     uint32_t                     ns_slot_count;
     /* Pointer to struct mailbox_slot_t[slot_count] allocated by NS */
     struct mailbox_slot_t        *ns_slots;
+#ifdef MAILBOX_RING_TRANSPORT
+    /* Request and reply rings allocated by NS */
+    struct mailbox_rings_t       *ns_rings;
+    /*
+     * SPE copies of the ring indices it owns. SPE doesn't read back the
+     * values written to NS memory.
+     */
+    uint32_t                     req_tail;
+    uint32_t                     reply_head;
+    /* NSPE slots whose messages are in progress in SPE */
+    mailbox_queue_status_t       ns_slots_in_flight;
+#endif
 };
 
 /**
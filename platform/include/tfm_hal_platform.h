@@ -37,6 +37,25 @@ void tfm_hal_system_reset(void);
  */
 void tfm_hal_system_halt(void);
 
+/**
+ * \brief Copy memory with a platform copy engine, such as a DMA controller.
+ *
+ * SPM calls it for the copies of at least CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE
+ * bytes. The copy shall be complete when this function returns.
+ *
+ * \param[out] dest                Destination address
+ * \param[in]  src                 Source address
+ * \param[in]  n                   Number of bytes to copy
+ *
+ * \retval TFM_HAL_SUCCESS              The memory is copied.
+ * \retval TFM_HAL_ERROR_NOT_SUPPORTED  The copy engine cannot handle the
+ *                                      given regions. SPM copies them with
+ *                                      the CPU instead.
+ * \retval Other code                   The copy engine failed.
+ */
+enum tfm_hal_status_t tfm_hal_copy_engine_memcpy(void *dest, const void *src,
+                                                 size_t n);
+
 /**
  * \brief Set up the RNG for use with random delays.
  *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,6 +13,38 @@
 
 #define ADDR_WORD_UNALIGNED(x)        ((x) & 0x3)
 
+/* Offset of an address in bits from the word it belongs to */
+#define ADDR_WORD_OFFSET_BITS(x)      (((x) & 0x3) * 8)
+
+/*
+ * Merge two adjacent aligned words into the word starting 'shift' bits into
+ * the lower one. 'shift' must be 8, 16 or 24.
+ * Unaligned word accesses may trap on the target (SCB->CCR.UNALIGN_TRP), so
+ * misaligned buffers are accessed with aligned words merged together.
+ */
+#ifdef __ARM_BIG_ENDIAN
+#define WORD_MERGE(lo, hi, shift)     (((lo) << (shift)) | ((hi) >> (32 - (shift))))
+#else
+#define WORD_MERGE(lo, hi, shift)     (((lo) >> (shift)) | ((hi) << (32 - (shift))))
+#endif
+
+/*
+ * Move 4 words in each iteration of the main loops.
+ * Armv6-M and Armv8-M Baseline only have 8 low registers available to the
+ * loops, so the unrolled loops are only enabled on Armv7-M and Armv8-M
+ * Mainline by default. Define CRT_MEM_UNROLL to 0 or 1 to select a variant.
+ * tools/crt_bench checks both variants against the C library on the host.
+ */
+#ifndef CRT_MEM_UNROLL
+#if defined(__ARM_ARCH_ISA_THUMB) && (__ARM_ARCH_ISA_THUMB == 1)
+#define CRT_MEM_UNROLL                0
+#else
+#define CRT_MEM_UNROLL                1
+#endif
+#endif
+
+#define CRT_MEM_UNROLL_BYTES          (4 * sizeof(uint32_t))
+
 union composite_addr_t {
     uintptr_t uint_addr;        /* Address as integer value  */
     uint8_t   *p_byte;          /* Address in BYTE pointer   */
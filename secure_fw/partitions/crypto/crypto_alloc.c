@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -24,9 +25,23 @@ enum {
 };
 
 /**
- * \brief This value is used to mark an handle for multipart operations as invalid.
+ * \brief Number of bits of an operation handle holding the index of the
+ *        operation context plus one. The remaining bits hold the generation
+ *        of the context, so that a handle of a released context is no longer
+ *        accepted once the context is reused.
  */
-#define TFM_CRYPTO_INVALID_HANDLE (0x0u)
+#define TFM_CRYPTO_HANDLE_INDEX_BITS (8u)
+#define TFM_CRYPTO_HANDLE_INDEX_MASK ((1u << TFM_CRYPTO_HANDLE_INDEX_BITS) - 1)
+#define TFM_CRYPTO_HANDLE_GEN_MASK   (UINT32_MAX >> TFM_CRYPTO_HANDLE_INDEX_BITS)
+
+#if CRYPTO_CONC_OPER_NUM > TFM_CRYPTO_HANDLE_INDEX_MASK
+#error "CRYPTO_CONC_OPER_NUM is too large to be encoded in operation handles."
+#endif
+
+/**
+ * \brief Index marking the end of the list of free contexts
+ */
+#define TFM_CRYPTO_FREE_LIST_END     (CRYPTO_CONC_OPER_NUM)
 
 /**
  * \brief A type describing the context stored in Secure memory by the TF-M Crypto
@@ -38,6 +53,18 @@ struct tfm_crypto_operation_s {
                                      *   the context
                                      */
     enum tfm_crypto_operation_type type; /*!< Type of the operation */
+    uint32_t generation;            /*!< Generation of the context, bumped
+                                     *   each time the context is released
+                                     */
+    uint32_t next_free;             /*!< Index of the next free context if
+                                     *   the context is not in use
+                                     */
+#if CRYPTO_CONC_OPER_RECLAIM_AGE > 0
+    uint32_t last_used;             /*!< Value of the use counter when the
+                                     *   context was last allocated or looked
+                                     *   up
+                                     */
+#endif
     union {
         psa_cipher_operation_t cipher;    /*!< Cipher operation context */
         psa_mac_operation_t mac;          /*!< MAC operation context */
@@ -49,6 +76,14 @@ struct tfm_crypto_operation_s {
 
 static struct tfm_crypto_operation_s operations[CRYPTO_CONC_OPER_NUM] = {{0}};
 
+/* Index of the first context in the list of free contexts */
+static uint32_t free_head = TFM_CRYPTO_FREE_LIST_END;
+
+#if CRYPTO_CONC_OPER_RECLAIM_AGE > 0
+/* Counter of the allocations and look-ups, used to age the contexts */
+static uint32_t use_counter = 0;
+#endif
+
 /*
  * \brief Function used to clear the memory associated to a backend context
  *
@@ -64,6 +99,139 @@ static void memset_operation_context(uint32_t index)
                  sizeof(operations[index].operation));
 }
 
+/*
+ * \brief Function used to convert a handle into the index of its backend
+ *        context. The handle of a released context is rejected.
+ *
+ * \param[in]  handle Handle of the context
+ * \param[out] index  Numerical index in the database of the backend contexts
+ *
+ * \return true if the handle refers to a context in use, false otherwise
+ *
+ */
+static bool handle_to_index(uint32_t handle, uint32_t *index)
+{
+    uint32_t idx = (handle & TFM_CRYPTO_HANDLE_INDEX_MASK);
+
+    if ((idx == 0) || (idx > CRYPTO_CONC_OPER_NUM)) {
+        return false;
+    }
+    idx--;
+
+    if ((operations[idx].in_use != TFM_CRYPTO_IN_USE) ||
+        (operations[idx].generation !=
+         (handle >> TFM_CRYPTO_HANDLE_INDEX_BITS))) {
+        return false;
+    }
+
+    *index = idx;
+    return true;
+}
+
+/*
+ * \brief Function used to put a backend context back in the list of free
+ *        contexts
+ *
+ * \param[in] index Numerical index in the database of the backend contexts
+ *
+ * \return None
+ *
+ */
+static void free_operation_context(uint32_t index)
+{
+    memset_operation_context(index);
+    operations[index].in_use = TFM_CRYPTO_NOT_IN_USE;
+    operations[index].type = TFM_CRYPTO_OPERATION_NONE;
+    operations[index].owner = 0;
+    operations[index].generation = (operations[index].generation + 1) &
+                                   TFM_CRYPTO_HANDLE_GEN_MASK;
+    operations[index].next_free = free_head;
+    free_head = index;
+}
+
+#if CRYPTO_CONC_OPER_QUOTA_PER_OWNER > 0
+/*
+ * \brief Function used to check whether an owner holds as many contexts as
+ *        the quota allows
+ *
+ * \param[in] owner ID of the owner
+ *
+ * \return true if the quota is reached, false otherwise
+ *
+ */
+static bool owner_quota_reached(int32_t owner)
+{
+    uint32_t i, count = 0;
+
+    for (i = 0; i < CRYPTO_CONC_OPER_NUM; i++) {
+        if ((operations[i].in_use == TFM_CRYPTO_IN_USE) &&
+            (operations[i].owner == owner)) {
+            count++;
+        }
+    }
+
+    return count >= CRYPTO_CONC_OPER_QUOTA_PER_OWNER;
+}
+#endif
+
+#if CRYPTO_CONC_OPER_RECLAIM_AGE > 0
+/*
+ * \brief Function used to reclaim the least recently used context owned by a
+ *        non-secure client, if it has not been used for at least
+ *        CRYPTO_CONC_OPER_RECLAIM_AGE allocations and look-ups. Such a context
+ *        is most likely leaked by a non-secure task which has gone away.
+ *
+ * \return None
+ *
+ */
+static void reclaim_operation_context(void)
+{
+    uint32_t i, index = TFM_CRYPTO_FREE_LIST_END;
+    uint32_t age, max_age = 0;
+
+    for (i = 0; i < CRYPTO_CONC_OPER_NUM; i++) {
+        if ((operations[i].in_use != TFM_CRYPTO_IN_USE) ||
+            (operations[i].owner >= 0)) {
+            continue;
+        }
+
+        age = use_counter - operations[i].last_used;
+        if (age >= max_age) {
+            max_age = age;
+            index = i;
+        }
+    }
+
+    if ((index == TFM_CRYPTO_FREE_LIST_END) ||
+        (max_age < CRYPTO_CONC_OPER_RECLAIM_AGE)) {
+        return;
+    }
+
+    /* Release any resource held by the operation before clearing it */
+    switch (operations[index].type) {
+    case TFM_CRYPTO_CIPHER_OPERATION:
+        (void)psa_cipher_abort(&operations[index].operation.cipher);
+        break;
+    case TFM_CRYPTO_MAC_OPERATION:
+        (void)psa_mac_abort(&operations[index].operation.mac);
+        break;
+    case TFM_CRYPTO_HASH_OPERATION:
+        (void)psa_hash_abort(&operations[index].operation.hash);
+        break;
+    case TFM_CRYPTO_KEY_DERIVATION_OPERATION:
+        (void)psa_key_derivation_abort(&operations[index].operation.key_deriv);
+        break;
+    case TFM_CRYPTO_AEAD_OPERATION:
+        (void)psa_aead_abort(&operations[index].operation.aead);
+        break;
+    default:
+        break;
+    }
+
+    free_operation_context(index);
+}
+#endif
+
 /*!
  * \defgroup alloc Function that implement allocation and deallocation of
  *                 contexts to be stored in the secure world for multipart
@@ -73,8 +241,17 @@ static void memset_operation_context(uint32_t index)
 /*!@{*/
 psa_status_t tfm_crypto_init_alloc(void)
 {
+    uint32_t i;
+
     /* Clear the contents of the local contexts */
     (void)memset(operations, 0, sizeof(operations));
+
+    /* Chain all the contexts in the list of free contexts */
+    for (i = 0; i < CRYPTO_CONC_OPER_NUM; i++) {
+        operations[i].next_free = i + 1;
+    }
+    free_head = 0;
+
     return PSA_SUCCESS;
 }
 
@@ -82,7 +259,7 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
                                         uint32_t *handle,
                                         void **ctx)
 {
-    uint32_t i = 0;
+    uint32_t index;
     int32_t partition_id = 0;
     psa_status_t status;
 
@@ -102,31 +279,52 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
         return status;
     }
 
-    for (i = 0; i < CRYPTO_CONC_OPER_NUM; i++) {
-        if (operations[i].in_use == TFM_CRYPTO_NOT_IN_USE) {
-            operations[i].in_use = TFM_CRYPTO_IN_USE;
-            operations[i].owner = partition_id;
-            operations[i].type = type;
-            *handle = i + 1;
-            *ctx = (void *) &(operations[i].operation);
-            return PSA_SUCCESS;
-        }
+#if CRYPTO_CONC_OPER_QUOTA_PER_OWNER > 0
+    if (owner_quota_reached(partition_id)) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+#endif
+
+#if CRYPTO_CONC_OPER_RECLAIM_AGE > 0
+    use_counter++;
+
+    if (free_head == TFM_CRYPTO_FREE_LIST_END) {
+        reclaim_operation_context();
     }
+#endif
+
+    if (free_head == TFM_CRYPTO_FREE_LIST_END) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    index = free_head;
+    free_head = operations[index].next_free;
 
-    return PSA_ERROR_NOT_PERMITTED;
+    operations[index].in_use = TFM_CRYPTO_IN_USE;
+    operations[index].owner = partition_id;
+    operations[index].type = type;
+#if CRYPTO_CONC_OPER_RECLAIM_AGE > 0
+    operations[index].last_used = use_counter;
+#endif
+
+    *handle = (operations[index].generation << TFM_CRYPTO_HANDLE_INDEX_BITS) |
+              (index + 1);
+    *ctx = (void *) &(operations[index].operation);
+
+    return PSA_SUCCESS;
 }
 
 psa_status_t tfm_crypto_operation_release(uint32_t *handle)
 {
     uint32_t h_val = *handle;
+    uint32_t index;
     int32_t partition_id = 0;
     psa_status_t status;
 
     /* Handle shall be cleaned up always at first */
     *handle = TFM_CRYPTO_INVALID_HANDLE;
 
-    if ((h_val == TFM_CRYPTO_INVALID_HANDLE) ||
-        (h_val > CRYPTO_CONC_OPER_NUM)) {
+    if (!handle_to_index(h_val, &index)) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
@@ -135,14 +333,8 @@ psa_status_t tfm_crypto_operation_release(uint32_t *handle)
         return status;
     }
 
-    if ((operations[h_val - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[h_val - 1].owner == partition_id)) {
-
-        memset_operation_context(h_val - 1);
-        operations[h_val - 1].in_use = TFM_CRYPTO_NOT_IN_USE;
-        operations[h_val - 1].type = TFM_CRYPTO_OPERATION_NONE;
-        operations[h_val - 1].owner = 0;
-
+    if (operations[index].owner == partition_id) {
+        free_operation_context(index);
         return PSA_SUCCESS;
     }
 
@@ -153,11 +345,11 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
                                          uint32_t handle,
                                          void **ctx)
 {
+    uint32_t index;
     int32_t partition_id = 0;
     psa_status_t status;
 
-    if ((handle == TFM_CRYPTO_INVALID_HANDLE) ||
-        (handle > CRYPTO_CONC_OPER_NUM)) {
+    if (!handle_to_index(handle, &index)) {
         return PSA_ERROR_BAD_STATE;
     }
 
@@ -170,10 +362,12 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
         return status;
     }
 
-    if ((operations[handle - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[handle - 1].type == type) &&
-        (operations[handle - 1].owner == partition_id)) {
-        *ctx = (void *) &(operations[handle - 1].operation);
+    if ((operations[index].type == type) &&
+        (operations[index].owner == partition_id)) {
+#if CRYPTO_CONC_OPER_RECLAIM_AGE > 0
+        operations[index].last_used = ++use_counter;
+#endif
+        *ctx = (void *) &(operations[index].operation);
         return PSA_SUCCESS;
     }
 
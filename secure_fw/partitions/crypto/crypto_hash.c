@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "config_tfm.h"
 #include "tfm_mbedcrypto_include.h"
@@ -62,6 +63,61 @@ psa_status_t tfm_crypto_hash_interface(psa_invec in_vec[],
 #endif
     }
 
+    if (sid == TFM_CRYPTO_HASH_COMPUTE_BATCH_SID) {
+#if CRYPTO_SINGLE_PART_FUNCS_DISABLED
+        return PSA_ERROR_NOT_SUPPORTED;
+#else
+        const struct tfm_crypto_hash_batch_msg *msgs = in_vec[1].base;
+        struct tfm_crypto_hash_batch_msg msg;
+        size_t msg_count = in_vec[1].len / sizeof(struct tfm_crypto_hash_batch_msg);
+        const uint8_t *data = in_vec[2].base;
+        size_t data_length = in_vec[2].len;
+        uint8_t *hashes = out_vec[0].base;
+        size_t hashes_size = out_vec[0].len;
+        size_t hash_length = PSA_HASH_LENGTH(iov->alg);
+        size_t length;
+        size_t i;
+
+        out_vec[0].len = 0;
+
+        if ((in_vec[1].len % sizeof(struct tfm_crypto_hash_batch_msg)) != 0) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        if (hash_length == 0) {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
+
+        if (msg_count > (hashes_size / hash_length)) {
+            return PSA_ERROR_BUFFER_TOO_SMALL;
+        }
+
+        for (i = 0; i < msg_count; i++) {
+            /*
+             * The client can modify the message array while it is in use, when
+             * the iovecs are mapped. Check and use a local copy only.
+             */
+            (void)memcpy(&msg, &msgs[i], sizeof(msg));
+
+            if ((msg.offset > data_length) ||
+                (msg.length > (data_length - msg.offset))) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+
+            status = psa_hash_compute(iov->alg,
+                                      &data[msg.offset], msg.length,
+                                      &hashes[i * hash_length], hash_length,
+                                      &length);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+        }
+
+        out_vec[0].len = msg_count * hash_length;
+        return PSA_SUCCESS;
+#endif
+    }
+
     if (sid == TFM_CRYPTO_HASH_SETUP_SID) {
         p_handle = out_vec[0].base;
         *p_handle = iov->op_handle;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -185,6 +185,323 @@ static psa_status_t tfm_crypto_init_iovecs(const psa_msg_t *msg,
 
     return PSA_SUCCESS;
 }
+
+#if CRYPTO_IOVEC_STREAMING_ENABLED && !CRYPTO_SINGLE_PART_FUNCS_DISABLED
+/**
+ * \brief Size of the input chunks read into the scratch when streaming. The
+ *        rest of the scratch holds the output produced from each chunk, which
+ *        for ciphers can be up to a block larger than the chunk.
+ */
+#define TFM_CRYPTO_STREAM_CHUNK_SIZE \
+    (((CRYPTO_IOVEC_BUFFER_SIZE / 2) - PSA_BLOCK_CIPHER_BLOCK_MAX_SIZE) & \
+     ~(TFM_CRYPTO_IOVEC_ALIGNMENT - 1))
+
+/**
+ * \brief Size of the output buffer in the scratch when streaming.
+ */
+#define TFM_CRYPTO_STREAM_OUTPUT_SIZE \
+    ((CRYPTO_IOVEC_BUFFER_SIZE - TFM_CRYPTO_STREAM_CHUNK_SIZE) & \
+     ~(TFM_CRYPTO_IOVEC_ALIGNMENT - 1))
+
+#if (CRYPTO_IOVEC_BUFFER_SIZE / 2) <= PSA_BLOCK_CIPHER_BLOCK_MAX_SIZE
+#error "CRYPTO_IOVEC_BUFFER_SIZE is too small to stream inputs and outputs."
+#endif
+
+/* The whole digest, MAC or last cipher block is produced in the output buffer */
+#if CRYPTO_HASH_MODULE_ENABLED && \
+    (TFM_CRYPTO_STREAM_OUTPUT_SIZE < PSA_HASH_MAX_SIZE)
+#error "CRYPTO_IOVEC_BUFFER_SIZE is too small to stream hash computations."
+#endif
+
+#if CRYPTO_MAC_MODULE_ENABLED && \
+    (TFM_CRYPTO_STREAM_OUTPUT_SIZE < PSA_MAC_MAX_SIZE)
+#error "CRYPTO_IOVEC_BUFFER_SIZE is too small to stream MAC computations."
+#endif
+
+#if CRYPTO_CIPHER_MODULE_ENABLED && \
+    (TFM_CRYPTO_STREAM_OUTPUT_SIZE < \
+     (TFM_CRYPTO_STREAM_CHUNK_SIZE + PSA_BLOCK_CIPHER_BLOCK_MAX_SIZE))
+#error "CRYPTO_IOVEC_BUFFER_SIZE is too small to stream cipher encryptions."
+#endif
+
+/**
+ * \brief Checks whether a call shall be streamed through the scratch, i.e.
+ *        it is a single-part call with an input vector and an output vector
+ *        which cannot be both allocated in the scratch.
+ */
+static bool tfm_crypto_stream_is_required(const psa_msg_t *msg,
+                                          const struct tfm_crypto_pack_iovec *iov,
+                                          size_t in_len,
+                                          size_t out_len)
+{
+    if ((in_len != 2) || (out_len != 1)) {
+        return false;
+    }
+
+    switch (iov->function_id) {
+#if CRYPTO_HASH_MODULE_ENABLED
+    case TFM_CRYPTO_HASH_COMPUTE_SID:
+#endif
+#if CRYPTO_MAC_MODULE_ENABLED
+    case TFM_CRYPTO_MAC_COMPUTE_SID:
+#endif
+#if CRYPTO_CIPHER_MODULE_ENABLED
+    case TFM_CRYPTO_CIPHER_ENCRYPT_SID:
+#endif
+        break;
+    default:
+        return false;
+    }
+
+    return (ALIGN(msg->in_size[1], TFM_CRYPTO_IOVEC_ALIGNMENT) +
+            ALIGN(msg->out_size[0], TFM_CRYPTO_IOVEC_ALIGNMENT)) >
+           sizeof(scratch.buf);
+}
+
+/**
+ * \brief Writes data to the output vector of a streamed call. It fails
+ *        instead of overflowing the output vector, which would be a fatal
+ *        error in psa_write().
+ */
+static psa_status_t tfm_crypto_stream_write(const psa_msg_t *msg,
+                                            size_t *written,
+                                            const uint8_t *data,
+                                            size_t data_length)
+{
+    if (data_length > (msg->out_size[0] - *written)) {
+        return PSA_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    psa_write(msg->handle, 0, data, data_length);
+    *written += data_length;
+
+    return PSA_SUCCESS;
+}
+
+#if CRYPTO_HASH_MODULE_ENABLED
+static psa_status_t tfm_crypto_stream_hash_compute(const psa_msg_t *msg,
+                                                   const struct tfm_crypto_pack_iovec *iov,
+                                                   uint8_t *chunk,
+                                                   uint8_t *output)
+{
+    psa_status_t status;
+    psa_hash_operation_t *operation = NULL;
+    uint32_t handle = TFM_CRYPTO_INVALID_HANDLE;
+    size_t remaining = msg->in_size[1];
+    size_t chunk_length, hash_length = 0, written = 0;
+
+    status = tfm_crypto_operation_alloc(TFM_CRYPTO_HASH_OPERATION, &handle,
+                                        (void **)&operation);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    status = psa_hash_setup(operation, iov->alg);
+    while ((status == PSA_SUCCESS) && (remaining > 0)) {
+        chunk_length = psa_read(msg->handle, 1, chunk,
+                                TFM_CRYPTO_STREAM_CHUNK_SIZE);
+        remaining -= chunk_length;
+        status = psa_hash_update(operation, chunk, chunk_length);
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_finish(operation, output,
+                                 (msg->out_size[0] < PSA_HASH_MAX_SIZE) ?
+                                 msg->out_size[0] : PSA_HASH_MAX_SIZE,
+                                 &hash_length);
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = tfm_crypto_stream_write(msg, &written, output, hash_length);
+    } else {
+        (void)psa_hash_abort(operation);
+    }
+
+    /* Release the operation context, ignore if the release fails. */
+    (void)tfm_crypto_operation_release(&handle);
+    return status;
+}
+#endif /* CRYPTO_HASH_MODULE_ENABLED */
+
+#if CRYPTO_MAC_MODULE_ENABLED
+static psa_status_t tfm_crypto_stream_mac_compute(const psa_msg_t *msg,
+                                                  const struct tfm_crypto_pack_iovec *iov,
+                                                  uint8_t *chunk,
+                                                  uint8_t *output)
+{
+    psa_status_t status;
+    psa_mac_operation_t *operation = NULL;
+    uint32_t handle = TFM_CRYPTO_INVALID_HANDLE;
+    size_t remaining = msg->in_size[1];
+    size_t chunk_length, mac_length = 0, written = 0;
+    tfm_crypto_library_key_id_t library_key =
+                         tfm_crypto_library_key_id_init(msg->client_id,
+                                                        iov->key_id);
+
+    status = tfm_crypto_operation_alloc(TFM_CRYPTO_MAC_OPERATION, &handle,
+                                        (void **)&operation);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    status = psa_mac_sign_setup(operation, library_key, iov->alg);
+    while ((status == PSA_SUCCESS) && (remaining > 0)) {
+        chunk_length = psa_read(msg->handle, 1, chunk,
+                                TFM_CRYPTO_STREAM_CHUNK_SIZE);
+        remaining -= chunk_length;
+        status = psa_mac_update(operation, chunk, chunk_length);
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = psa_mac_sign_finish(operation, output,
+                                     (msg->out_size[0] < PSA_MAC_MAX_SIZE) ?
+                                     msg->out_size[0] : PSA_MAC_MAX_SIZE,
+                                     &mac_length);
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = tfm_crypto_stream_write(msg, &written, output, mac_length);
+    } else {
+        (void)psa_mac_abort(operation);
+    }
+
+    /* Release the operation context, ignore if the release fails. */
+    (void)tfm_crypto_operation_release(&handle);
+    return status;
+}
+#endif /* CRYPTO_MAC_MODULE_ENABLED */
+
+#if CRYPTO_CIPHER_MODULE_ENABLED
+static psa_status_t tfm_crypto_stream_cipher_encrypt(const psa_msg_t *msg,
+                                                     const struct tfm_crypto_pack_iovec *iov,
+                                                     uint8_t *chunk,
+                                                     uint8_t *output)
+{
+    psa_status_t status;
+    psa_cipher_operation_t *operation = NULL;
+    psa_key_attributes_t key_attributes = PSA_KEY_ATTRIBUTES_INIT;
+    psa_key_type_t key_type;
+    uint32_t handle = TFM_CRYPTO_INVALID_HANDLE;
+    size_t remaining = msg->in_size[1];
+    size_t chunk_length, output_length = 0, written = 0;
+    tfm_crypto_library_key_id_t library_key =
+                         tfm_crypto_library_key_id_init(msg->client_id,
+                                                        iov->key_id);
+
+    status = tfm_crypto_operation_alloc(TFM_CRYPTO_CIPHER_OPERATION, &handle,
+                                        (void **)&operation);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    status = psa_cipher_encrypt_setup(operation, library_key, iov->alg);
+    if (status != PSA_SUCCESS) {
+        goto release_operation_and_return;
+    }
+
+    status = psa_get_key_attributes(library_key, &key_attributes);
+    key_type = psa_get_key_type(&key_attributes);
+    psa_reset_key_attributes(&key_attributes);
+    if (status != PSA_SUCCESS) {
+        goto abort_operation_and_return;
+    }
+
+    /*
+     * Check the output size upfront as psa_cipher_encrypt() does, so that no
+     * partial output is written to the client when the output is too small.
+     */
+    if (msg->out_size[0] <
+        PSA_CIPHER_ENCRYPT_OUTPUT_SIZE(key_type, iov->alg, msg->in_size[1])) {
+        status = PSA_ERROR_BUFFER_TOO_SMALL;
+        goto abort_operation_and_return;
+    }
+
+    /* The generated IV is placed in front of the ciphertext */
+    if (PSA_CIPHER_IV_LENGTH(key_type, iov->alg) > 0) {
+        status = psa_cipher_generate_iv(operation, output,
+                                        TFM_CRYPTO_STREAM_OUTPUT_SIZE,
+                                        &output_length);
+        if (status == PSA_SUCCESS) {
+            status = tfm_crypto_stream_write(msg, &written,
+                                             output, output_length);
+        }
+    }
+
+    while ((status == PSA_SUCCESS) && (remaining > 0)) {
+        chunk_length = psa_read(msg->handle, 1, chunk,
+                                TFM_CRYPTO_STREAM_CHUNK_SIZE);
+        remaining -= chunk_length;
+        status = psa_cipher_update(operation, chunk, chunk_length,
+                                   output, TFM_CRYPTO_STREAM_OUTPUT_SIZE,
+                                   &output_length);
+        if (status == PSA_SUCCESS) {
+            status = tfm_crypto_stream_write(msg, &written,
+                                             output, output_length);
+        }
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = psa_cipher_finish(operation, output,
+                                   TFM_CRYPTO_STREAM_OUTPUT_SIZE,
+                                   &output_length);
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = tfm_crypto_stream_write(msg, &written, output, output_length);
+        goto release_operation_and_return;
+    }
+
+abort_operation_and_return:
+    (void)psa_cipher_abort(operation);
+
+release_operation_and_return:
+    /* Release the operation context, ignore if the release fails. */
+    (void)tfm_crypto_operation_release(&handle);
+    return status;
+}
+#endif /* CRYPTO_CIPHER_MODULE_ENABLED */
+
+/**
+ * \brief Serves a single-part call whose vectors do not fit in the scratch.
+ *        The input is read in chunks through the scratch and fed to the
+ *        multi-part operation, and the output is written back as soon as it
+ *        is produced.
+ */
+static psa_status_t tfm_crypto_stream_call(const psa_msg_t *msg,
+                                           const struct tfm_crypto_pack_iovec *iov)
+{
+    psa_status_t status;
+    void *chunk = NULL;
+    void *output = NULL;
+
+    status = tfm_crypto_alloc_scratch(TFM_CRYPTO_STREAM_CHUNK_SIZE, &chunk);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    status = tfm_crypto_alloc_scratch(TFM_CRYPTO_STREAM_OUTPUT_SIZE, &output);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    switch (iov->function_id) {
+#if CRYPTO_HASH_MODULE_ENABLED
+    case TFM_CRYPTO_HASH_COMPUTE_SID:
+        return tfm_crypto_stream_hash_compute(msg, iov, chunk, output);
+#endif
+#if CRYPTO_MAC_MODULE_ENABLED
+    case TFM_CRYPTO_MAC_COMPUTE_SID:
+        return tfm_crypto_stream_mac_compute(msg, iov, chunk, output);
+#endif
+#if CRYPTO_CIPHER_MODULE_ENABLED
+    case TFM_CRYPTO_CIPHER_ENCRYPT_SID:
+        return tfm_crypto_stream_cipher_encrypt(msg, iov, chunk, output);
+#endif
+    default:
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+}
+#endif /* CRYPTO_IOVEC_STREAMING_ENABLED && !CRYPTO_SINGLE_PART_FUNCS_DISABLED */
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
 
 static psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
@@ -283,6 +600,17 @@ static psa_status_t tfm_crypto_call_srv(const psa_msg_t *msg)
     in_vec[0].base = &iov;
     in_vec[0].len = sizeof(struct tfm_crypto_pack_iovec);
 
+#if (PSA_FRAMEWORK_HAS_MM_IOVEC != 1) && CRYPTO_IOVEC_STREAMING_ENABLED && \
+    !CRYPTO_SINGLE_PART_FUNCS_DISABLED
+    /* Stream the vectors which do not fit in the scratch */
+    if (tfm_crypto_stream_is_required(msg, &iov, in_len, out_len)) {
+        tfm_crypto_set_caller_id(msg->client_id);
+        status = tfm_crypto_stream_call(msg, &iov);
+        tfm_crypto_clear_scratch();
+        return status;
+    }
+#endif
+
     status = tfm_crypto_init_iovecs(msg, in_vec, in_len, out_vec, out_len);
     if (status != PSA_SUCCESS) {
         return status;
@@ -359,8 +687,16 @@ static psa_status_t tfm_crypto_engine_init(void)
 
 static psa_status_t tfm_crypto_module_init(void)
 {
+    psa_status_t status;
+
     /* Init the Alloc module */
-    return tfm_crypto_init_alloc();
+    status = tfm_crypto_init_alloc();
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* Init the RNG module */
+    return tfm_crypto_init_rng();
 }
 
 /*!
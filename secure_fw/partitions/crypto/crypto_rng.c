@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2021, Nordic Semiconductor ASA.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "config_tfm.h"
 #include "tfm_mbedcrypto_include.h"
@@ -15,12 +16,68 @@
 #include "tfm_crypto_api.h"
 #include "tfm_crypto_defs.h"
 
+#if CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0)
+/**
+ * \brief Largest request served from the random pool. Larger requests are
+ *        served directly by the DRBG.
+ */
+#define TFM_CRYPTO_RNG_POOL_MAX_DRAW (CRYPTO_RNG_POOL_SIZE / 4)
+
+/**
+ * \brief Pool of random bytes generated by a single DRBG call and handed out
+ *        in slices to small requests. A slice is erased from the pool as soon
+ *        as it is handed out, so no byte is ever handed out twice.
+ */
+static struct tfm_crypto_rng_pool {
+    uint8_t buf[CRYPTO_RNG_POOL_SIZE];
+    size_t index;                      /*!< Index of the first unused byte */
+} rng_pool = {.buf = {0}, .index = CRYPTO_RNG_POOL_SIZE};
+
+static void tfm_crypto_rng_pool_clear(void)
+{
+    (void)memset(rng_pool.buf, 0, sizeof(rng_pool.buf));
+    rng_pool.index = sizeof(rng_pool.buf);
+}
+
+static psa_status_t tfm_crypto_rng_pool_draw(uint8_t *output,
+                                             size_t output_size)
+{
+    psa_status_t status;
+
+    if ((sizeof(rng_pool.buf) - rng_pool.index) < output_size) {
+        /* The unused bytes left are overwritten by the refill */
+        status = psa_generate_random(rng_pool.buf, sizeof(rng_pool.buf));
+        if (status != PSA_SUCCESS) {
+            tfm_crypto_rng_pool_clear();
+            return status;
+        }
+        rng_pool.index = 0;
+    }
+
+    (void)memcpy(output, &rng_pool.buf[rng_pool.index], output_size);
+    (void)memset(&rng_pool.buf[rng_pool.index], 0, output_size);
+    rng_pool.index += output_size;
+
+    return PSA_SUCCESS;
+}
+#endif /* CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0) */
+
 /*!
  * \addtogroup tfm_crypto_api_shim_layer
  *
  */
 
 /*!@{*/
+psa_status_t tfm_crypto_init_rng(void)
+{
+#if CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0)
+    /* Never hand out bytes left in the pool before a reset */
+    tfm_crypto_rng_pool_clear();
+#endif
+
+    return PSA_SUCCESS;
+}
+
 psa_status_t tfm_crypto_random_interface(psa_invec in_vec[],
                                          psa_outvec out_vec[])
 {
@@ -33,6 +90,12 @@ psa_status_t tfm_crypto_random_interface(psa_invec in_vec[],
     uint8_t *output = out_vec[0].base;
     size_t output_size = out_vec[0].len;
 
+#if CRYPTO_RNG_POOL_SIZE > 0
+    if (output_size <= TFM_CRYPTO_RNG_POOL_MAX_DRAW) {
+        return tfm_crypto_rng_pool_draw(output, output_size);
+    }
+#endif
+
     return psa_generate_random(output, output_size);
 #endif
 }
@@ -5,6 +5,7 @@
  *
  */
 #include <string.h>
+#include "config_tfm.h"
 #include "tfm_builtin_key_loader.h"
 #include "tfm_mbedcrypto_include.h"
 #include "psa_manifest/pid.h"
@@ -29,6 +30,7 @@ struct tfm_builtin_key_t {
     size_t key_len;                       /*!< Size of the key material held in the key buffer */
     psa_key_attributes_t attr;            /*!< Key attributes associated to the key */
     uint32_t is_loaded;                   /*!< Boolean indicating whether the slot is being used */
+    const tfm_plat_builtin_key_policy_t *policy; /*!< Usage policy of the key, NULL if none */
 };
 
 /*!
@@ -37,6 +39,61 @@ struct tfm_builtin_key_t {
  */
 static struct tfm_builtin_key_t g_builtin_key_slots[TFM_BUILTIN_MAX_KEYS] = {0};
 
+#if CRYPTO_BUILTIN_KEY_CACHE_NUM > 0
+/*!
+ * \brief A structure which describes a key derived from a builtin key for a user
+ */
+struct tfm_builtin_key_cache_entry_t {
+    uint8_t __attribute__((aligned(4))) key[TFM_BUILTIN_MAX_KEY_LEN]; /*!< Derived key material, 4-byte aligned */
+    size_t key_len;                       /*!< Size of the derived key material */
+    psa_drv_slot_number_t slot_number;    /*!< Slot of the builtin key the key is derived from */
+    int32_t user;                         /*!< User the key is derived for */
+    uint32_t is_valid;                    /*!< Boolean indicating whether the entry is being used */
+};
+
+/*!
+ * \brief The below array caches the keys derived for each user, so that the
+ *        key derivation is not run again each time a user accesses a builtin
+ *        key. Entries are replaced in a round-robin fashion.
+ */
+static struct tfm_builtin_key_cache_entry_t g_builtin_key_cache[CRYPTO_BUILTIN_KEY_CACHE_NUM] = {0};
+static size_t g_builtin_key_cache_next = 0;
+
+static struct tfm_builtin_key_cache_entry_t *builtin_key_cache_lookup(
+        psa_drv_slot_number_t slot_number, int32_t user, size_t key_len)
+{
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_builtin_key_cache); idx++) {
+        if (g_builtin_key_cache[idx].is_valid &&
+            g_builtin_key_cache[idx].slot_number == slot_number &&
+            g_builtin_key_cache[idx].user == user &&
+            g_builtin_key_cache[idx].key_len == key_len) {
+            return &g_builtin_key_cache[idx];
+        }
+    }
+
+    return NULL;
+}
+
+static void builtin_key_cache_insert(
+        psa_drv_slot_number_t slot_number, int32_t user,
+        const uint8_t *key, size_t key_len)
+{
+    struct tfm_builtin_key_cache_entry_t *entry = &g_builtin_key_cache[g_builtin_key_cache_next];
+
+    if (key_len > sizeof(entry->key)) {
+        return;
+    }
+
+    memcpy(entry->key, key, key_len);
+    entry->key_len = key_len;
+    entry->slot_number = slot_number;
+    entry->user = user;
+    entry->is_valid = 1;
+
+    g_builtin_key_cache_next = (g_builtin_key_cache_next + 1) % NUMBER_OF_ELEMENTS_OF(g_builtin_key_cache);
+}
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_NUM > 0 */
+
 /*!
  * \brief This functions returns the slot associated to a key id interrogating the
  *        platform HAL table
@@ -44,9 +101,20 @@ static struct tfm_builtin_key_t g_builtin_key_slots[TFM_BUILTIN_MAX_KEYS] = {0};
 static psa_status_t builtin_key_get_slot(psa_key_id_t key_id, psa_drv_slot_number_t *slot_ptr)
 {
     const tfm_plat_builtin_key_descriptor_t *desc_table = NULL;
-    size_t number_of_keys = tfm_plat_builtin_key_get_desc_table_ptr(&desc_table);
+    size_t number_of_keys;
     psa_drv_slot_number_t slot_number = TFM_BUILTIN_KEY_SLOT_MAX;
 
+    /* Loaded keys are found from the slots, without going through the platform HAL */
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_builtin_key_slots); idx++) {
+        if (g_builtin_key_slots[idx].is_loaded &&
+            CRYPTO_LIBRARY_GET_KEY_ID(psa_get_key_id(&g_builtin_key_slots[idx].attr)) == key_id) {
+            *slot_ptr = idx;
+            return PSA_SUCCESS;
+        }
+    }
+
+    number_of_keys = tfm_plat_builtin_key_get_desc_table_ptr(&desc_table);
+
     for (size_t idx = 0; idx < number_of_keys; idx++) {
         if (desc_table[idx].key_id == key_id) {
             slot_number = desc_table[idx].slot_number;
@@ -64,35 +132,48 @@ static psa_status_t builtin_key_get_slot(psa_key_id_t key_id, psa_drv_slot_numbe
 }
 
 /*!
- * \brief This functions returns the attributes of the key interrogating the
+ * \brief This functions returns the usage policy of a key interrogating the
  *        platform HAL
  */
-static psa_status_t builtin_key_get_attributes(
-        struct tfm_builtin_key_t *key_slot, int32_t user, psa_key_id_t key_id, psa_key_attributes_t *attr)
+static const tfm_plat_builtin_key_policy_t *builtin_key_get_policy(psa_key_id_t key_id)
 {
-    psa_key_usage_t usage = 0x0;
-
-    /* Retrieve the usage policy based on the key_id and the user of the key */
     const tfm_plat_builtin_key_policy_t *policy_table = NULL;
     size_t number_of_keys = tfm_plat_builtin_key_get_policy_table_ptr(&policy_table);
 
     for (size_t idx = 0; idx < number_of_keys; idx++) {
         if (policy_table[idx].key_id == key_id) {
-            if (policy_table[idx].per_user_policy == 0) {
-                usage = policy_table[idx].usage;
-            } else {
-                /* The policy depedends also on the user of the key */
-                size_t num_users = policy_table[idx].per_user_policy;
-                const tfm_plat_builtin_key_per_user_policy_t *p_policy = policy_table[idx].policy_ptr;
-
-                for (size_t j = 0; j < num_users; j++) {
-                    if (p_policy[j].user == user) {
-                        usage = p_policy[j].usage;
-                        break;
-                    }
+            return &policy_table[idx];
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ * \brief This functions returns the attributes of the key from the key slot
+ *        and the usage policy retrieved when the key was loaded
+ */
+static psa_status_t builtin_key_get_attributes(
+        struct tfm_builtin_key_t *key_slot, int32_t user, psa_key_id_t key_id, psa_key_attributes_t *attr)
+{
+    psa_key_usage_t usage = 0x0;
+    const tfm_plat_builtin_key_policy_t *policy = key_slot->policy;
+
+    /* Retrieve the usage policy based on the user of the key */
+    if (policy != NULL) {
+        if (policy->per_user_policy == 0) {
+            usage = policy->usage;
+        } else {
+            /* The policy depedends also on the user of the key */
+            size_t num_users = policy->per_user_policy;
+            const tfm_plat_builtin_key_per_user_policy_t *p_policy = policy->policy_ptr;
+
+            for (size_t j = 0; j < num_users; j++) {
+                if (p_policy[j].user == user) {
+                    usage = p_policy[j].usage;
+                    break;
                 }
             }
-            break;
         }
     }
 
@@ -216,6 +297,9 @@ psa_status_t tfm_builtin_key_loader_init(void)
     psa_algorithm_t algorithm;
     psa_key_type_t type;
 
+    /* Never use keys derived before a reset */
+    tfm_builtin_key_loader_cache_clear();
+
     for (size_t key = 0; key < number_of_keys; key++) {
         if (desc_table[key].lifetime != TFM_BUILTIN_KEY_LOADER_LIFETIME) {
             /* If the key is not bound to this driver, just don't load it */
@@ -243,6 +327,7 @@ psa_status_t tfm_builtin_key_loader_init(void)
         memcpy(&(g_builtin_key_slots[slot_number].attr), &attr, sizeof(psa_key_attributes_t));
         memcpy(&(g_builtin_key_slots[slot_number].key), buf, key_len);
         g_builtin_key_slots[slot_number].key_len = key_len;
+        g_builtin_key_slots[slot_number].policy = builtin_key_get_policy(desc_table[key].key_id);
         g_builtin_key_slots[slot_number].is_loaded = 1;
     }
     /* At this point the discovered keys have been loaded successfully into the driver */
@@ -336,10 +421,26 @@ psa_status_t tfm_builtin_key_loader_get_builtin_key(
      */
     int32_t user = CRYPTO_LIBRARY_GET_OWNER(key_id);
     if (psa_get_key_usage_flags(attributes) & PSA_KEY_USAGE_DERIVE && user != TFM_SP_CRYPTO) {
+#if CRYPTO_BUILTIN_KEY_CACHE_NUM > 0
+        const struct tfm_builtin_key_cache_entry_t *entry =
+            builtin_key_cache_lookup(slot_number, user, key_buffer_size);
+
+        if (entry != NULL) {
+            memcpy(key_buffer, entry->key, entry->key_len);
+            *key_buffer_length = entry->key_len;
+            err = PSA_SUCCESS;
+            goto wrap_up;
+        }
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_NUM > 0 */
 
         err = derive_subkey_into_buffer(key_slot, user,
                                         key_buffer, key_buffer_size,
                                         key_buffer_length);
+#if CRYPTO_BUILTIN_KEY_CACHE_NUM > 0
+        if (err == PSA_SUCCESS && *key_buffer_length == key_buffer_size) {
+            builtin_key_cache_insert(slot_number, user, key_buffer, *key_buffer_length);
+        }
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_NUM > 0 */
     } else {
         err = builtin_key_copy_to_buffer(key_slot, key_buffer, key_buffer_size,
                                          key_buffer_length);
@@ -348,4 +449,12 @@ psa_status_t tfm_builtin_key_loader_get_builtin_key(
 wrap_up:
     return err;
 }
+
+void tfm_builtin_key_loader_cache_clear(void)
+{
+#if CRYPTO_BUILTIN_KEY_CACHE_NUM > 0
+    memset(g_builtin_key_cache, 0, sizeof(g_builtin_key_cache));
+    g_builtin_key_cache_next = 0;
+#endif /* CRYPTO_BUILTIN_KEY_CACHE_NUM > 0 */
+}
 /*!@}*/
@@ -95,6 +95,17 @@ psa_status_t tfm_builtin_key_loader_get_builtin_key(
         psa_drv_slot_number_t slot_number, psa_key_attributes_t *attributes,
         uint8_t *key_buffer, size_t key_buffer_size, size_t *key_buffer_length);
 
+/**
+ * \brief Erases the keys derived from builtin keys for their users and cached
+ *        by the driver. The cache is cleared when the driver is initialised.
+ *        Platforms must call this function if the state the derived keys
+ *        depend on changes at runtime, e.g. on a lifecycle state change.
+ *
+ * \note The cache is used only if CRYPTO_BUILTIN_KEY_CACHE_NUM is greater
+ *       than 0, otherwise this function has no effect.
+ */
+void tfm_builtin_key_loader_cache_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -36,6 +36,11 @@ enum tfm_crypto_operation_type {
     TFM_CRYPTO_OPERATION_TYPE_MAX = INT_MAX
 };
 
+/**
+ * \brief This value is used to mark an handle for multipart operations as invalid.
+ */
+#define TFM_CRYPTO_INVALID_HANDLE (0x0u)
+
 /**
  * \brief Initialise the service
  *
@@ -50,6 +55,13 @@ psa_status_t tfm_crypto_init(void);
  */
 psa_status_t tfm_crypto_init_alloc(void);
 
+/**
+ * \brief Initialise the Random Number Generation module
+ *
+ * \return Return values as described in \ref psa_status_t
+ */
+psa_status_t tfm_crypto_init_rng(void);
+
 /**
  * \brief Returns the ID of the caller
  *
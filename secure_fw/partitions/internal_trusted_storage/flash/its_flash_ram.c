@@ -9,6 +9,11 @@
 
 #include "flash_fs/its_flash_fs.h"
 
+#if ITS_RAM_FS_STATS
+/* Counters of the operations done on the emulated flash devices */
+static struct its_flash_ram_stats_t its_flash_ram_stats;
+#endif
+
 /**
  * \brief Gets physical address of the given block ID.
  *
@@ -39,6 +44,11 @@ static psa_status_t its_flash_ram_read(const struct its_flash_fs_config_t *cfg,
 
     (void)memcpy(buff, (uint8_t *)cfg->flash_dev + idx, size);
 
+#if ITS_RAM_FS_STATS
+    its_flash_ram_stats.reads++;
+    its_flash_ram_stats.read_bytes += size;
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -50,6 +60,11 @@ static psa_status_t its_flash_ram_write(const struct its_flash_fs_config_t *cfg,
 
     (void)memcpy((uint8_t *)cfg->flash_dev + idx, buff, size);
 
+#if ITS_RAM_FS_STATS
+    its_flash_ram_stats.writes++;
+    its_flash_ram_stats.write_bytes += size;
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -73,6 +88,10 @@ static psa_status_t its_flash_ram_erase(const struct its_flash_fs_config_t *cfg,
     (void)memset((uint8_t *)cfg->flash_dev + idx, cfg->erase_val,
                  cfg->block_size);
 
+#if ITS_RAM_FS_STATS
+    its_flash_ram_stats.erases++;
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -83,3 +102,15 @@ const struct its_flash_fs_ops_t its_flash_fs_ops_ram = {
     .flush = its_flash_ram_flush,
     .erase = its_flash_ram_erase,
 };
+
+#if ITS_RAM_FS_STATS
+void its_flash_ram_get_stats(struct its_flash_ram_stats_t *stats)
+{
+    *stats = its_flash_ram_stats;
+}
+
+void its_flash_ram_reset_stats(void)
+{
+    (void)memset(&its_flash_ram_stats, 0, sizeof(its_flash_ram_stats));
+}
+#endif /* ITS_RAM_FS_STATS */
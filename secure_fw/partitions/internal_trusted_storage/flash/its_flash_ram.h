@@ -16,12 +16,49 @@
 #ifndef __ITS_FLASH_RAM_H__
 #define __ITS_FLASH_RAM_H__
 
+#include <stdint.h>
+
+#include "config_tfm.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 extern const struct its_flash_fs_ops_t its_flash_fs_ops_ram;
 
+#if ITS_RAM_FS_STATS
+/*!
+ * \struct its_flash_ram_stats_t
+ *
+ * \brief Counters of the operations done on the emulated flash devices.
+ */
+struct its_flash_ram_stats_t {
+    uint32_t reads;       /*!< Number of read operations */
+    uint32_t read_bytes;  /*!< Number of bytes read */
+    uint32_t writes;      /*!< Number of program operations */
+    uint32_t write_bytes; /*!< Number of bytes programmed */
+    uint32_t erases;      /*!< Number of block erases */
+};
+
+/**
+ * \brief Gets the counters of the operations done on the emulated flash
+ *        devices since boot or since the last reset of the counters.
+ *
+ * \details The counters are shared by all the filesystems using the emulated
+ *          flash, and allow measuring the flash traffic of storage operations
+ *          without a hardware flash device.
+ *
+ * \param[out] stats  Pointer to the structure to fill in
+ */
+void its_flash_ram_get_stats(struct its_flash_ram_stats_t *stats);
+
+/**
+ * \brief Resets the counters of the operations done on the emulated flash
+ *        devices.
+ */
+void its_flash_ram_reset_stats(void);
+#endif /* ITS_RAM_FS_STATS */
+
 #ifdef __cplusplus
 }
 #endif
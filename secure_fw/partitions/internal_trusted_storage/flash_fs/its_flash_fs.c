@@ -23,14 +23,80 @@
 static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
                                             uint32_t del_file_idx);
 
+#if ITS_LOG_STRUCTURED
+static bool its_flash_fs_log_structured(const struct its_flash_fs_ctx_t *fs_ctx,
+                                        uint32_t lblock);
+
+/**
+ * \brief Appends the new version of a file to the data of its active data
+ *        block.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in,out] block_meta  Block metadata, updated with the space taken by a
+ *                            relocated file
+ * \param[in,out] file_meta   File metadata, updated with the position of a
+ *                            relocated file
+ * \param[in]     reserved    True if the file has just been reserved, so its
+ *                            data area has not been written yet
+ * \param[in]     offset      Offset in the file
+ * \param[in]     size        Size of the incoming data
+ * \param[in]     src         Source of the incoming data
+ *
+ * \return Returns PSA_ERROR_INSUFFICIENT_STORAGE if the new version cannot be
+ *         appended. Otherwise, error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_file_append_data(
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            struct its_block_meta_t *block_meta,
+                                            struct its_file_meta_t *file_meta,
+                                            bool reserved,
+                                            size_t offset,
+                                            size_t size,
+                                            const struct its_flash_fs_data_src_t *src)
+{
+    psa_status_t err;
+    size_t data_idx;
+
+    if (reserved) {
+        /* The data area of a new file is already at the end of the data */
+        data_idx = file_meta->data_idx;
+    } else {
+        /* Relocate the file to the end of the data. Its current data area
+         * becomes stale.
+         */
+        if (block_meta->free_size < file_meta->max_size) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+        data_idx = fs_ctx->cfg->block_size - block_meta->free_size;
+    }
+
+    err = its_flash_fs_dblock_append_file(fs_ctx, block_meta, file_meta,
+                                          data_idx, offset, size, src);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (!reserved) {
+        block_meta->free_size -= file_meta->max_size;
+        file_meta->data_idx = data_idx;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_LOG_STRUCTURED */
+
 static psa_status_t its_flash_fs_file_write_aligned_data(
-                                      struct its_flash_fs_ctx_t *fs_ctx,
-                                      const struct its_block_meta_t *block_meta,
-                                      const struct its_file_meta_t *file_meta,
-                                      size_t offset,
-                                      size_t size,
-                                      const uint8_t *data)
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            struct its_block_meta_t *block_meta,
+                                            struct its_file_meta_t *file_meta,
+                                            bool reserved,
+                                            size_t offset,
+                                            size_t size,
+                                            const struct its_flash_fs_data_src_t *src)
 {
+    uint32_t cur_phys_block;
+    psa_status_t err;
+
 #if (ITS_FLASH_MAX_ALIGNMENT != 1)
     /* Check that the offset is aligned with the flash program unit */
     if (!ITS_UTILS_IS_ALIGNED(offset, fs_ctx->cfg->program_unit)) {
@@ -52,8 +118,37 @@ static psa_status_t its_flash_fs_file_write_aligned_data(
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    return its_flash_fs_dblock_write_file(fs_ctx, block_meta, file_meta, offset,
-                                          size, data);
+#if ITS_LOG_STRUCTURED
+    if (its_flash_fs_log_structured(fs_ctx, file_meta->lblock)) {
+        err = its_flash_fs_file_append_data(fs_ctx, block_meta, file_meta,
+                                            reserved, offset, size, src);
+        if (err != PSA_ERROR_INSUFFICIENT_STORAGE) {
+            return err;
+        }
+        /* Otherwise, rewrite the block in the scratch data block */
+    }
+#else
+    (void)reserved;
+#endif
+
+    /* Write the content into scratch data block */
+    err = its_flash_fs_dblock_write_file(fs_ctx, block_meta, file_meta, offset,
+                                         size, src);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    cur_phys_block = block_meta->phy_id;
+
+    /* Cur scratch block become the active datablock */
+    block_meta->phy_id =
+        its_flash_fs_mblock_cur_data_scratch_id(fs_ctx, file_meta->lblock);
+
+    /* Swap the scratch data block */
+    its_flash_fs_mblock_set_data_scratch(fs_ctx, cur_phys_block,
+                                         file_meta->lblock);
+
+    return PSA_SUCCESS;
 }
 
 /* TODO This is very similar to (static) its_num_active_dblocks() */
@@ -138,6 +233,308 @@ static psa_status_t its_flash_fs_validate_config(
     return ret;
 }
 
+#if ITS_LOG_STRUCTURED
+/**
+ * \brief Checks if new file versions are appended to a logical data block.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] lblock  Logical block number
+ *
+ * \return Returns true if the block is log-structured.
+ */
+static bool its_flash_fs_log_structured(const struct its_flash_fs_ctx_t *fs_ctx,
+                                        uint32_t lblock)
+{
+    /* Logical data block 0 is rewritten with the metadata block anyway */
+    return fs_ctx->cfg->log_structured && (lblock != ITS_LOGICAL_DBLOCK0);
+}
+
+/**
+ * \brief Gets the size of the stale data in a logical data block, i.e. the
+ *        data of deleted files and of old file versions.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     lblock      Logical block number
+ * \param[in]     block_meta  Block metadata
+ * \param[out]    stale_size  Size of the stale data
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_log_stale_size(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t lblock,
+                                      const struct its_block_meta_t *block_meta,
+                                      size_t *stale_size)
+{
+    struct its_file_meta_t file_meta;
+    psa_status_t err;
+    size_t size;
+    uint32_t idx;
+
+    size = fs_ctx->cfg->block_size - block_meta->free_size
+           - block_meta->data_start;
+
+    /* Subtract the data of the files stored in the block */
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if ((file_meta.lblock == lblock) &&
+            (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS)) {
+            if (file_meta.max_size > size) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+            size -= file_meta.max_size;
+        }
+    }
+
+    *stale_size = size;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Compacts a logical data block, in a metadata block update of its own.
+ *        The files stored in the block are copied, packed, to the scratch data
+ *        block, which then becomes the logical data block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     lblock  Logical block number, other than logical block 0
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_log_compact_block(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t lblock)
+{
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+    uint32_t scratch_id;
+    psa_status_t err;
+    size_t pos;
+    uint32_t idx;
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock, &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    its_flash_fs_mblock_begin_update(fs_ctx);
+
+    scratch_id = its_flash_fs_mblock_cur_data_scratch_id(fs_ctx, lblock);
+    pos = block_meta.data_start;
+
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if ((file_meta.lblock == lblock) &&
+            (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS)) {
+            /* Only the written part of the file needs to be copied */
+            err = its_flash_fs_block_to_block_move(fs_ctx, scratch_id, pos,
+                                                   block_meta.phy_id,
+                                                   file_meta.data_idx,
+                                                   ITS_UTILS_ALIGN(
+                                                   file_meta.cur_size,
+                                                   fs_ctx->cfg->program_unit));
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            file_meta.data_idx = pos;
+            pos += file_meta.max_size;
+        }
+
+        /* Update file metadata in to the scratch block */
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, idx,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Commit data block modifications to flash */
+    err = fs_ctx->ops->flush(fs_ctx->cfg, scratch_id);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Swap the scratch and current data blocks */
+    its_flash_fs_mblock_set_data_scratch(fs_ctx, block_meta.phy_id, lblock);
+    block_meta.phy_id = scratch_id;
+    block_meta.free_size = fs_ctx->cfg->block_size - pos;
+
+    /* Update block metadata in scratch metadata block */
+    err = its_flash_fs_mblock_update_scratch_block_meta(fs_ctx, lblock,
+                                                        &block_meta);
+    if (err != PSA_SUCCESS) {
+        /* Swap back the data block as there was an issue in the process */
+        its_flash_fs_mblock_set_data_scratch(fs_ctx, scratch_id, lblock);
+        return err;
+    }
+
+    err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Write metadata header, swap metadata blocks and erase scratch blocks */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+
+/**
+ * \brief Compacts a logical data block after an update if its stale data
+ *        exceeds ITS_LOG_STRUCTURED_GC_THRESHOLD percent of the block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     lblock  Logical block number
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_log_collect(struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t lblock)
+{
+#if ITS_LOG_STRUCTURED_GC_THRESHOLD != 0
+    struct its_block_meta_t block_meta;
+    size_t stale_size;
+    psa_status_t err;
+
+    if (!its_flash_fs_log_structured(fs_ctx, lblock)) {
+        return PSA_SUCCESS;
+    }
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock, &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_log_stale_size(fs_ctx, lblock, &block_meta,
+                                      &stale_size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if ((stale_size * 100) >
+        ((size_t)fs_ctx->cfg->block_size * ITS_LOG_STRUCTURED_GC_THRESHOLD)) {
+        return its_flash_fs_log_compact_block(fs_ctx, lblock);
+    }
+#else
+    (void)fs_ctx;
+    (void)lblock;
+#endif
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Makes room for the next version of a file before it is written, by
+ *        compacting a logical data block if the version would not fit in the
+ *        free space at the end of any block otherwise.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     fid        ID of the file
+ * \param[in]     finfo      Incoming file info, with an aligned max size
+ * \param[in]     data_size  Size of the incoming data
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_log_make_room(
+                                    struct its_flash_fs_ctx_t *fs_ctx,
+                                    const uint8_t *fid,
+                                    const struct its_flash_fs_file_info_t *finfo,
+                                    size_t data_size)
+{
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+    uint32_t lblock = ITS_LOGICAL_DBLOCK0;
+    size_t best_size = 0;
+    size_t stale_size;
+    psa_status_t err;
+    size_t size;
+    uint32_t idx;
+    uint32_t i;
+
+    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &idx, &file_meta);
+    if ((err == PSA_SUCCESS) &&
+        (!(finfo->flags & ITS_FLASH_FS_FLAG_TRUNCATE) ||
+         (file_meta.max_size == finfo->size_max))) {
+        /* The existing file is reused, and relocated if data is written */
+        if ((data_size == 0) ||
+            !its_flash_fs_log_structured(fs_ctx, file_meta.lblock)) {
+            return PSA_SUCCESS;
+        }
+
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, file_meta.lblock,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (block_meta.free_size >= file_meta.max_size) {
+            return PSA_SUCCESS;
+        }
+
+        err = its_flash_fs_log_stale_size(fs_ctx, file_meta.lblock,
+                                          &block_meta, &stale_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        /* Otherwise, the block is rewritten in the scratch data block */
+        if ((block_meta.free_size + stale_size) >= file_meta.max_size) {
+            return its_flash_fs_log_compact_block(fs_ctx, file_meta.lblock);
+        }
+
+        return PSA_SUCCESS;
+    } else if ((err != PSA_SUCCESS) && (err != PSA_ERROR_DOES_NOT_EXIST)) {
+        return err;
+    } else if ((err != PSA_SUCCESS) &&
+               !(finfo->flags & ITS_FLASH_FS_FLAG_CREATE)) {
+        return PSA_SUCCESS;
+    }
+
+    /* A new file is reserved. Find the block where compaction frees the most
+     * space, unless the file already fits in a block.
+     */
+    for (i = 0; i < its_flash_fs_num_active_dblocks(fs_ctx->cfg); i++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (block_meta.free_size >= finfo->size_max) {
+            return PSA_SUCCESS;
+        }
+
+        if (!its_flash_fs_log_structured(fs_ctx, i)) {
+            continue;
+        }
+
+        err = its_flash_fs_log_stale_size(fs_ctx, i, &block_meta, &stale_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        size = block_meta.free_size + stale_size;
+        if ((stale_size != 0) && (size >= finfo->size_max) &&
+            (size > best_size)) {
+            lblock = i;
+            best_size = size;
+        }
+    }
+
+    if (lblock != ITS_LOGICAL_DBLOCK0) {
+        return its_flash_fs_log_compact_block(fs_ctx, lblock);
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_LOG_STRUCTURED */
+
 psa_status_t its_flash_fs_init_ctx(its_flash_fs_ctx_t *fs_ctx,
                                    const struct its_flash_fs_config_t *fs_cfg,
                                    const struct its_flash_fs_ops_t *fs_ops)
@@ -203,6 +600,20 @@ psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
     uint32_t idx;
     struct its_file_meta_t tmp_metadata;
 
+#if ITS_RAM_FILE_INDEX && !defined(ITS_ENCRYPTION)
+    /* Without encryption, everything needed is held in the file index */
+    err = its_flash_fs_mblock_get_cached_file_info(fs_ctx, fid,
+                                                   &info->size_current,
+                                                   &info->size_max,
+                                                   &info->flags);
+    if (err == PSA_SUCCESS) {
+        info->flags &= ITS_FLASH_FS_USER_FLAGS_MASK;
+        return PSA_SUCCESS;
+    } else if (err != PSA_ERROR_NOT_SUPPORTED) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+#endif
+
     /* Get the meta data index and meta data */
     err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &idx, &tmp_metadata);
     if (err != PSA_SUCCESS) {
@@ -220,16 +631,45 @@ psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
     return PSA_SUCCESS;
 }
 
+/* Data source of a write from a buffer. The whole data is a single part. */
+static psa_status_t its_flash_fs_buf_get_data(void *ctx, size_t offset,
+                                              size_t size,
+                                              const uint8_t **data)
+{
+    (void)size;
+
+    *data = (const uint8_t *)ctx + offset;
+
+    return PSA_SUCCESS;
+}
+
 psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
                                      const uint8_t *fid,
                                      struct its_flash_fs_file_info_t *finfo,
                                      size_t data_size,
                                      size_t offset,
                                      const uint8_t *data)
+{
+    const struct its_flash_fs_data_src_t src = {
+        .get_data = its_flash_fs_buf_get_data,
+        .ctx = (void *)data,
+        .part_size = SIZE_MAX,
+    };
+
+    return its_flash_fs_file_write_src(fs_ctx, fid, finfo, data_size, offset,
+                                       &src);
+}
+
+psa_status_t its_flash_fs_file_write_src(
+                                  struct its_flash_fs_ctx_t *fs_ctx,
+                                  const uint8_t *fid,
+                                  struct its_flash_fs_file_info_t *finfo,
+                                  size_t data_size,
+                                  size_t offset,
+                                  const struct its_flash_fs_data_src_t *src)
 {
     struct its_block_meta_t block_meta;
     struct its_file_meta_t file_meta = {0};
-    uint32_t cur_phys_block;
     psa_status_t err;
     uint32_t idx;
     uint32_t old_idx = ITS_METADATA_INVALID_INDEX;
@@ -250,6 +690,16 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
     finfo->size_max = ITS_UTILS_ALIGN(finfo->size_max, fs_ctx->cfg->program_unit);
 #endif
 
+#if ITS_LOG_STRUCTURED
+    /* Reclaim stale space first if the new version would not fit otherwise */
+    err = its_flash_fs_log_make_room(fs_ctx, fid, finfo, data_size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
+    its_flash_fs_mblock_begin_update(fs_ctx);
+
     /* Check if the file already exists */
     err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &old_idx, &file_meta);
     if (err == PSA_SUCCESS) {
@@ -315,10 +765,11 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
     }
 
     if (data_size != 0) {
-        /* Write the content into scratch data block */
+        /* Write the content into the data block */
         err = its_flash_fs_file_write_aligned_data(fs_ctx, &block_meta,
-                                                   &file_meta, offset,
-                                                   data_size, data);
+                                                   &file_meta,
+                                                   (new_idx != old_idx),
+                                                   offset, data_size, src);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
         }
@@ -328,16 +779,6 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
             /* Update the file metadata */
             file_meta.cur_size = offset + data_size;
         }
-
-        cur_phys_block = block_meta.phy_id;
-
-        /* Cur scratch block become the active datablock */
-        block_meta.phy_id =
-            its_flash_fs_mblock_cur_data_scratch_id(fs_ctx, file_meta.lblock);
-
-        /* Swap the scratch data block */
-        its_flash_fs_mblock_set_data_scratch(fs_ctx, cur_phys_block,
-                                             file_meta.lblock);
     }
 
     /* Update block metadata in scratch metadata block */
@@ -417,6 +858,13 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         err = its_flash_fs_delete_idx(fs_ctx, old_idx);
     }
 
+#if ITS_LOG_STRUCTURED
+    if (err == PSA_SUCCESS) {
+        /* The previous version of a relocated file is now stale */
+        err = its_flash_fs_log_collect(fs_ctx, file_meta.lblock);
+    }
+#endif
+
     return err;
 }
 
@@ -432,6 +880,7 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
     uint32_t idx;
     struct its_file_meta_t file_meta;
     struct its_block_meta_t block_meta;
+    bool compact;
 
     err = its_flash_fs_mblock_read_file_meta(fs_ctx, del_file_idx, &file_meta);
     if (err != PSA_SUCCESS) {
@@ -442,11 +891,24 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
         return PSA_ERROR_DOES_NOT_EXIST;
     }
 
+    its_flash_fs_mblock_begin_update(fs_ctx);
+
     /* Save logical block, data_index and max_size to be used later on */
     del_file_lblock = file_meta.lblock;
     del_file_data_idx = file_meta.data_idx;
     del_file_max_size = file_meta.max_size;
 
+    /* If the asset max size is 0, there is no need to compact the data block */
+    compact = (del_file_max_size != 0);
+#if ITS_LOG_STRUCTURED
+    if (its_flash_fs_log_structured(fs_ctx, del_file_lblock)) {
+        /* Leave the file data as stale data, reclaimed by a later compaction
+         * of the block.
+         */
+        compact = false;
+    }
+#endif
+
     /* Remove file metadata */
     file_meta = (struct its_file_meta_t){0};
 
@@ -473,7 +935,7 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
         /* Check if the file is located in the same logical block and has a
          * valid FID.
          */
-        if ((file_meta.lblock == del_file_lblock) &&
+        if (compact && (file_meta.lblock == del_file_lblock) &&
             (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS)) {
             /* If a file is located after the data to delete, this
              * needs to be moved.
@@ -503,9 +965,8 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
         }
     }
 
-    if (del_file_max_size == 0) {
-        /* If the asset max size is 0, there is no need to compact the data block.
-         * Copy the block metadata and the block data to scratch metadata block.
+    if (!compact) {
+        /* Copy the block metadata and the block data to scratch metadata block.
          */
         err = its_flash_fs_mblock_read_block_metadata(fs_ctx, ITS_LOGICAL_DBLOCK0, &block_meta);
         if (err != PSA_SUCCESS) {
@@ -533,12 +994,11 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
      * of the file processed is not located in the logical block 0. When an
      * file data is located in the logical block 0, that copy has been done
      * while processing the file data.
-     * If the max size of file to delete is 0:
+     * If the data block is not compacted:
      * The file metadata and block metadata has been updated into the scratch
      * metadata block, copy the file data to the scratch block.
      */
-    if (((del_file_max_size != 0) && (del_file_lblock != ITS_LOGICAL_DBLOCK0)) ||
-        (del_file_max_size == 0)) {
+    if (!compact || (del_file_lblock != ITS_LOGICAL_DBLOCK0)) {
         err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
@@ -548,7 +1008,16 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
     /* Update the metablock header, swap scratch and active blocks,
      * erase scratch blocks.
      */
+#if ITS_LOG_STRUCTURED
+    err = its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return its_flash_fs_log_collect(fs_ctx, del_file_lblock);
+#else
     return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+#endif
 }
 
 psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
@@ -597,3 +1066,524 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
 
     return PSA_SUCCESS;
 }
+
+#if ITS_TRANSACTION
+void its_flash_fs_txn_begin(struct its_flash_fs_txn_t *txn)
+{
+    txn->num_ops = 0;
+}
+
+/**
+ * \brief Gets the operation on the given file in a transaction, adding a new
+ *        operation if there is none yet.
+ *
+ * \param[in,out] txn  Transaction
+ * \param[in]     fid  File ID
+ *
+ * \return Returns a pointer to the operation, or NULL if the transaction is
+ *         full
+ */
+static struct its_flash_fs_txn_op_t *its_flash_fs_txn_get_op(
+                                                struct its_flash_fs_txn_t *txn,
+                                                const uint8_t *fid)
+{
+    struct its_flash_fs_txn_op_t *op;
+    uint32_t i;
+
+    for (i = 0; i < txn->num_ops; i++) {
+        if (memcmp(txn->op[i].fid, fid, ITS_FILE_ID_SIZE) == 0) {
+            return &txn->op[i];
+        }
+    }
+
+    if (txn->num_ops == ITS_TRANSACTION_MAX_OPS) {
+        return NULL;
+    }
+
+    op = &txn->op[txn->num_ops++];
+    memcpy(op->fid, fid, ITS_FILE_ID_SIZE);
+    op->remove = false;
+    op->written = false;
+
+    return op;
+}
+
+psa_status_t its_flash_fs_txn_stage_write(
+                                     struct its_flash_fs_txn_t *txn,
+                                     const uint8_t *fid,
+                                     const struct its_flash_fs_file_info_t *finfo,
+                                     size_t data_size,
+                                     const uint8_t *data)
+{
+    struct its_flash_fs_txn_op_t *op;
+
+    if ((finfo == NULL) || ((data == NULL) && (data_size != 0))) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Do not permit the user to pass filesystem-internal flags */
+    if (finfo->flags & ITS_FLASH_FS_INTERNAL_FLAGS_MASK) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    op = its_flash_fs_txn_get_op(txn, fid);
+    if (op == NULL) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    op->remove = false;
+    op->written = true;
+    op->finfo = *finfo;
+    op->finfo.size_current = data_size;
+    op->finfo.size_max = data_size;
+    op->finfo.flags &= ITS_FLASH_FS_USER_FLAGS_MASK;
+    op->data = data;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_txn_stage_delete(struct its_flash_fs_txn_t *txn,
+                                           const uint8_t *fid)
+{
+    struct its_flash_fs_txn_op_t *op;
+
+    op = its_flash_fs_txn_get_op(txn, fid);
+    if (op == NULL) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    if (op->remove) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    op->remove = true;
+    op->data = NULL;
+
+    return PSA_SUCCESS;
+}
+
+bool its_flash_fs_txn_get_staged(const struct its_flash_fs_txn_t *txn,
+                                 const uint8_t *fid,
+                                 const struct its_flash_fs_file_info_t **finfo)
+{
+    uint32_t i;
+
+    for (i = 0; i < txn->num_ops; i++) {
+        if (memcmp(txn->op[i].fid, fid, ITS_FILE_ID_SIZE) == 0) {
+            *finfo = txn->op[i].remove ? NULL : &txn->op[i].finfo;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * \brief Gets the transaction operation which owns a file metadata entry.
+ *
+ * \param[in] txn  Transaction
+ * \param[in] idx  File metadata entry index
+ *
+ * \return Returns a pointer to the operation, or NULL if the entry is not
+ *         changed by the transaction
+ */
+static const struct its_flash_fs_txn_op_t *its_flash_fs_txn_find_idx(
+                                          const struct its_flash_fs_txn_t *txn,
+                                          uint32_t idx)
+{
+    uint32_t i;
+
+    for (i = 0; i < txn->num_ops; i++) {
+        if ((txn->op[i].old_idx == idx) || (txn->op[i].new_idx == idx)) {
+            return &txn->op[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Gets the end of the data kept in a logical block rewritten by a
+ *        transaction, before the data of the files it removes is subtracted.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     lblock      Logical block number
+ * \param[in]     block_meta  Block metadata
+ * \param[out]    end         End of the data in the block
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_txn_block_end(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t lblock,
+                                      const struct its_block_meta_t *block_meta,
+                                      size_t *end)
+{
+#if ITS_LOG_STRUCTURED
+    size_t stale_size;
+    psa_status_t err;
+#endif
+
+    *end = fs_ctx->cfg->block_size - block_meta->free_size;
+
+#if ITS_LOG_STRUCTURED
+    /* The stale data is dropped when the files are packed */
+    if (its_flash_fs_log_structured(fs_ctx, lblock)) {
+        err = its_flash_fs_log_stale_size(fs_ctx, lblock, block_meta,
+                                          &stale_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        *end -= stale_size;
+    }
+#else
+    (void)lblock;
+#endif
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Writes the new content of a logical block updated by a transaction
+ *        into its scratch block: first the files kept by the transaction,
+ *        packed in file metadata entry order, then the new file contents
+ *        placed in the block.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     txn         Transaction
+ * \param[in]     lblock      Logical block number
+ * \param[in,out] block_meta  Block metadata, updated with the new free size
+ *                            and, for a dedicated data block, the physical ID
+ *                            of the scratch block
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_txn_write_block(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         const struct its_flash_fs_txn_t *txn,
+                                         uint32_t lblock,
+                                         struct its_block_meta_t *block_meta)
+{
+    const struct its_flash_fs_txn_op_t *op;
+    struct its_file_meta_t file_meta;
+    uint32_t scratch_id;
+    psa_status_t err;
+    size_t pos;
+    uint32_t idx;
+    uint32_t i;
+
+    scratch_id = its_flash_fs_mblock_cur_data_scratch_id(fs_ctx, lblock);
+    pos = block_meta->data_start;
+
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        if (its_flash_fs_txn_find_idx(txn, idx) != NULL) {
+            continue;
+        }
+
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if ((file_meta.lblock == lblock) &&
+            (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS)) {
+            err = its_flash_fs_block_to_block_move(fs_ctx, scratch_id, pos,
+                                                   block_meta->phy_id,
+                                                   file_meta.data_idx,
+                                                   file_meta.max_size);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            pos += file_meta.max_size;
+        }
+    }
+
+    for (i = 0; i < txn->num_ops; i++) {
+        op = &txn->op[i];
+        if (op->remove || (op->lblock != lblock)) {
+            continue;
+        }
+
+        if (op->finfo.size_max != 0) {
+            err = fs_ctx->ops->write(fs_ctx->cfg, scratch_id, op->data,
+                                     op->data_idx, op->finfo.size_max);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+
+        pos += op->finfo.size_max;
+    }
+
+    block_meta->free_size = fs_ctx->cfg->block_size - pos;
+
+    /* Commit data block modifications to flash, unless the data is in logical
+     * data block 0, in which case it will be flushed at the end of the metadata
+     * block update.
+     */
+    if (lblock != ITS_LOGICAL_DBLOCK0) {
+        block_meta->phy_id = scratch_id;
+        return fs_ctx->ops->flush(fs_ctx->cfg, scratch_id);
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_txn_commit(struct its_flash_fs_ctx_t *fs_ctx,
+                                     struct its_flash_fs_txn_t *txn)
+{
+    struct its_block_meta_t lb0_meta;
+    struct its_block_meta_t block_meta = {0};
+    struct its_file_meta_t file_meta;
+    struct its_flash_fs_txn_op_t *op;
+    const struct its_flash_fs_txn_op_t *idx_op;
+    /* The dedicated data block rewritten by the transaction, if any. Only one
+     * can be, as there is a single scratch data block.
+     */
+    uint32_t dblock = ITS_LOGICAL_DBLOCK0;
+    uint32_t dblock_phy_id = ITS_BLOCK_INVALID_ID;
+    bool lb0_rewrite = false;
+    size_t lb0_removed = 0;
+    size_t dblock_removed = 0;
+    size_t lb0_end;
+    size_t dblock_end = 0;
+    bool idx_released = false;
+    uint32_t free_idx = 0;
+    psa_status_t err;
+    uint32_t lblock;
+    uint32_t idx;
+    uint32_t i;
+
+    if (txn->num_ops == 0) {
+        return PSA_SUCCESS;
+    }
+
+    /* Find the existing files replaced or deleted by the transaction */
+    for (i = 0; i < txn->num_ops; i++) {
+        op = &txn->op[i];
+        op->new_idx = ITS_METADATA_INVALID_INDEX;
+
+        err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, op->fid,
+                                                    &op->old_idx, &file_meta);
+        if (err == PSA_ERROR_DOES_NOT_EXIST) {
+            op->old_idx = ITS_METADATA_INVALID_INDEX;
+            /* Deleting a file created by the transaction leaves nothing to
+             * do, so the operation is skipped by the steps below.
+             */
+            if (op->remove && !op->written) {
+                return PSA_ERROR_DOES_NOT_EXIST;
+            }
+            continue;
+        } else if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (file_meta.lblock == ITS_LOGICAL_DBLOCK0) {
+            lb0_rewrite = true;
+            lb0_removed += file_meta.max_size;
+        } else if ((dblock == ITS_LOGICAL_DBLOCK0) ||
+                   (dblock == file_meta.lblock)) {
+            dblock = file_meta.lblock;
+            dblock_removed += file_meta.max_size;
+        } else {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
+
+        if (op->remove) {
+            idx_released = true;
+        } else {
+            /* The new file content reuses the metadata entry */
+            op->new_idx = op->old_idx;
+        }
+    }
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                                  &lb0_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    lb0_end = fs_ctx->cfg->block_size - lb0_meta.free_size - lb0_removed;
+
+    if (dblock != ITS_LOGICAL_DBLOCK0) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, dblock,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+        err = its_flash_fs_txn_block_end(fs_ctx, dblock, &block_meta,
+                                         &dblock_end);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        dblock_end -= dblock_removed;
+    }
+
+    /* Place the new file contents after the files kept in the rewritten
+     * blocks, and reserve a metadata entry for each new file.
+     */
+    for (i = 0; i < txn->num_ops; i++) {
+        op = &txn->op[i];
+        if (op->remove) {
+            continue;
+        }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+        /* Set the max_size to be aligned with the flash program unit */
+        op->finfo.size_max = ITS_UTILS_ALIGN(op->finfo.size_current,
+                                             fs_ctx->cfg->program_unit);
+#endif
+
+        if (op->finfo.size_max > fs_ctx->cfg->max_file_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        if (op->finfo.size_max <= fs_ctx->cfg->block_size - lb0_end) {
+            op->lblock = ITS_LOGICAL_DBLOCK0;
+            op->data_idx = lb0_end;
+            lb0_end += op->finfo.size_max;
+            lb0_rewrite = true;
+        } else {
+            if (dblock == ITS_LOGICAL_DBLOCK0) {
+                /* Use the first dedicated data block with enough space */
+                for (lblock = ITS_LOGICAL_DBLOCK0 + 1;
+                     lblock < its_flash_fs_num_active_dblocks(fs_ctx->cfg);
+                     lblock++) {
+                    err = its_flash_fs_mblock_read_block_metadata(fs_ctx,
+                                                                  lblock,
+                                                                  &block_meta);
+                    if (err != PSA_SUCCESS) {
+                        return PSA_ERROR_GENERIC_ERROR;
+                    }
+
+                    err = its_flash_fs_txn_block_end(fs_ctx, lblock,
+                                                     &block_meta, &dblock_end);
+                    if (err != PSA_SUCCESS) {
+                        return err;
+                    }
+
+                    if (op->finfo.size_max
+                        <= fs_ctx->cfg->block_size - dblock_end) {
+                        dblock = lblock;
+                        break;
+                    }
+                }
+            }
+
+            if ((dblock == ITS_LOGICAL_DBLOCK0) ||
+                (op->finfo.size_max > fs_ctx->cfg->block_size - dblock_end)) {
+                return PSA_ERROR_INSUFFICIENT_STORAGE;
+            }
+
+            op->lblock = dblock;
+            op->data_idx = dblock_end;
+            dblock_end += op->finfo.size_max;
+        }
+
+        if (op->new_idx == ITS_METADATA_INVALID_INDEX) {
+            op->new_idx = its_flash_fs_mblock_get_free_file_idx(fs_ctx,
+                                                                free_idx);
+            if (op->new_idx == ITS_METADATA_INVALID_INDEX) {
+                return PSA_ERROR_INSUFFICIENT_STORAGE;
+            }
+            free_idx = op->new_idx + 1;
+        }
+    }
+
+    /* As for a single file creation, leave a spare metadata entry for the
+     * atomic replacement of a file, unless the transaction releases one.
+     */
+    if (!idx_released && (free_idx != 0) &&
+        (its_flash_fs_mblock_get_free_file_idx(fs_ctx, free_idx)
+         == ITS_METADATA_INVALID_INDEX)) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    its_flash_fs_mblock_begin_update(fs_ctx);
+
+    /* Rewrite the dedicated data block first, as its modifications must be
+     * flushed before the metadata block is written.
+     */
+    if (dblock != ITS_LOGICAL_DBLOCK0) {
+        dblock_phy_id = block_meta.phy_id;
+        err = its_flash_fs_txn_write_block(fs_ctx, txn, dblock, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    if (lb0_rewrite) {
+        err = its_flash_fs_txn_write_block(fs_ctx, txn, ITS_LOGICAL_DBLOCK0,
+                                           &lb0_meta);
+    } else {
+        err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    }
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Update block metadata in scratch metadata block */
+    err = its_flash_fs_mblock_update_scratch_block_metas(fs_ctx, &lb0_meta,
+                                                         dblock, &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Write all the file metadata entries, following the same order as
+     * its_flash_fs_txn_write_block() to relocate the files which are kept.
+     */
+    lb0_end = lb0_meta.data_start;
+    dblock_end = block_meta.data_start;
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        idx_op = its_flash_fs_txn_find_idx(txn, idx);
+        if (idx_op == NULL) {
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            if (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS) {
+                if (lb0_rewrite &&
+                    (file_meta.lblock == ITS_LOGICAL_DBLOCK0)) {
+                    file_meta.data_idx = lb0_end;
+                    lb0_end += file_meta.max_size;
+                } else if ((dblock != ITS_LOGICAL_DBLOCK0) &&
+                           (file_meta.lblock == dblock)) {
+                    file_meta.data_idx = dblock_end;
+                    dblock_end += file_meta.max_size;
+                }
+            }
+        } else if (idx_op->remove) {
+            /* Remove file metadata */
+            file_meta = (struct its_file_meta_t){0};
+        } else {
+            file_meta = (struct its_file_meta_t){0};
+            memcpy(file_meta.id, idx_op->fid, ITS_FILE_ID_SIZE);
+            file_meta.lblock = idx_op->lblock;
+            file_meta.data_idx = idx_op->data_idx;
+            file_meta.cur_size = idx_op->finfo.size_current;
+            file_meta.max_size = idx_op->finfo.size_max;
+            file_meta.flags = idx_op->finfo.flags;
+#ifdef ITS_ENCRYPTION
+            memcpy(file_meta.nonce, idx_op->finfo.nonce,
+                   sizeof(idx_op->finfo.nonce));
+            memcpy(file_meta.tag, idx_op->finfo.tag, sizeof(idx_op->finfo.tag));
+#endif
+        }
+
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, idx,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Swap the scratch data block */
+    if (dblock != ITS_LOGICAL_DBLOCK0) {
+        its_flash_fs_mblock_set_data_scratch(fs_ctx, dblock_phy_id, dblock);
+    }
+
+    /* Write metadata header, swap metadata blocks and erase scratch blocks */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+#endif /* ITS_TRANSACTION */
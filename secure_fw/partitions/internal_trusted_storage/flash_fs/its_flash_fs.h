@@ -17,6 +17,7 @@
 #ifndef __ITS_FLASH_FS_H__
 #define __ITS_FLASH_FS_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -61,6 +62,13 @@ struct its_flash_fs_config_t {
     uint16_t max_file_size;   /**< Maximum file size */
     uint16_t max_num_files;   /**< Maximum number of files */
     uint8_t erase_val;        /**< Value of a byte after erase (usually 0xFF) */
+#if ITS_LOG_STRUCTURED
+    bool log_structured;      /**< Append new file versions to the erased end
+                               *   of the dedicated data blocks. The flash
+                               *   must allow the erased part of a block to be
+                               *   programmed after the rest.
+                               */
+#endif
 };
 
 /**
@@ -166,6 +174,28 @@ struct its_flash_fs_ops_t {
  */
 typedef struct its_flash_fs_ctx_t its_flash_fs_ctx_t;
 
+/**
+ * \struct its_flash_fs_data_src_t
+ *
+ * \brief Structure describing where the data written to a file comes from.
+ *
+ * \details The data is requested in parts of at most part_size bytes, in
+ *          increasing offset order. It lets a caller produce the content of a
+ *          file, e.g. encrypt it, while it is written, without holding the
+ *          whole content in RAM.
+ */
+struct its_flash_fs_data_src_t {
+    /** Sets data to the part of size bytes at offset in the data written.
+     *   The part must stay valid until the next call.
+     */
+    psa_status_t (*get_data)(void *ctx, size_t offset, size_t size,
+                             const uint8_t **data);
+    void *ctx;         /*!< Context passed to get_data */
+    size_t part_size;  /*!< Maximum size of a part. A multiple of the flash
+                        *   program unit.
+                        */
+};
+
 /*!
  * \struct its_flash_fs_file_info_t
  *
@@ -187,6 +217,41 @@ struct its_flash_fs_file_info_t {
 #endif
 };
 
+#if ITS_TRANSACTION
+/*!
+ * \struct its_flash_fs_txn_op_t
+ *
+ * \brief Structure containing a file update staged in a transaction.
+ */
+struct its_flash_fs_txn_op_t {
+    uint8_t fid[ITS_FILE_ID_SIZE];         /*!< ID of the file */
+    bool remove;                           /*!< True to delete the file */
+    bool written;                          /*!< True if an update of the
+                                            *   file was staged, even if a
+                                            *   later deletion replaced it
+                                            */
+    struct its_flash_fs_file_info_t finfo; /*!< Info of the new file content */
+    const uint8_t *data;                   /*!< New file content */
+    /* The fields below are filled in by its_flash_fs_txn_commit() */
+    uint32_t old_idx;     /*!< Metadata entry of the existing file */
+    uint32_t new_idx;     /*!< Metadata entry of the new file content */
+    uint32_t lblock;      /*!< Logical block of the new file content */
+    size_t data_idx;      /*!< Offset of the new file content in lblock */
+};
+
+/*!
+ * \struct its_flash_fs_txn_t
+ *
+ * \brief Structure containing the file updates of a transaction. Nothing is
+ *        written to the filesystem before the transaction is committed, so a
+ *        transaction is abandoned simply by not committing it.
+ */
+struct its_flash_fs_txn_t {
+    struct its_flash_fs_txn_op_t op[ITS_TRANSACTION_MAX_OPS];
+    uint32_t num_ops;
+};
+#endif /* ITS_TRANSACTION */
+
 /**
  * \brief Initialises the filesystem context. Must be called successfully before
  *        any other filesystem API is called.
@@ -258,6 +323,31 @@ psa_status_t its_flash_fs_file_write(its_flash_fs_ctx_t *fs_ctx,
                                      size_t offset,
                                      const uint8_t *data);
 
+/**
+ * \brief Writes data to a file, taking the data from a data source.
+ *
+ * \details Same as \ref its_flash_fs_file_write, but the data is requested
+ *          from src while it is written. The new file content is still
+ *          committed in a single metadata update.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     fid        File ID
+ * \param[in]     finfo      Pointer to \ref its_flash_fs_file_info_t
+ * \param[in]     data_size  Size of the incoming write data.
+ * \param[in]     offset     Offset in the file to write. Must be less than or
+ *                           equal to the current file size.
+ * \param[in]     src        Source of the data to be written
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_file_write_src(
+                                  its_flash_fs_ctx_t *fs_ctx,
+                                  const uint8_t *fid,
+                                  struct its_flash_fs_file_info_t *finfo,
+                                  size_t data_size,
+                                  size_t offset,
+                                  const struct its_flash_fs_data_src_t *src);
+
 /**
  * \brief Reads data from an existing file.
  *
@@ -286,6 +376,91 @@ psa_status_t its_flash_fs_file_read(its_flash_fs_ctx_t *fs_ctx,
 psa_status_t its_flash_fs_file_delete(its_flash_fs_ctx_t *fs_ctx,
                                       const uint8_t *fid);
 
+#if ITS_TRANSACTION
+/**
+ * \brief Starts a new, empty, transaction.
+ *
+ * \param[out] txn  Transaction to initialise
+ */
+void its_flash_fs_txn_begin(struct its_flash_fs_txn_t *txn);
+
+/**
+ * \brief Stages the creation or the replacement of a file in a transaction.
+ *        The whole content of the file is replaced by the given data.
+ *
+ * \note  Staging an update of a file which already has an update staged in
+ *        the transaction replaces the earlier update.
+ *
+ * \param[in,out] txn        Transaction
+ * \param[in]     fid        File ID
+ * \param[in]     finfo      Pointer to \ref its_flash_fs_file_info_t holding
+ *                           the flags (and, with encryption, the nonce and
+ *                           tag) of the new file content
+ * \param[in]     data_size  Size of the new file content
+ * \param[in]     data       Pointer to the new file content. It must remain
+ *                           valid until the transaction is committed.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_txn_stage_write(
+                                     struct its_flash_fs_txn_t *txn,
+                                     const uint8_t *fid,
+                                     const struct its_flash_fs_file_info_t *finfo,
+                                     size_t data_size,
+                                     const uint8_t *data);
+
+/**
+ * \brief Stages the deletion of a file in a transaction.
+ *
+ * \note  The deletion of a file created earlier in the transaction cancels
+ *        its creation.
+ *
+ * \param[in,out] txn  Transaction
+ * \param[in]     fid  File ID
+ *
+ * \return Returns error code as specified in \ref psa_status_t. In
+ *         particular, PSA_ERROR_DOES_NOT_EXIST if the deletion of the file is
+ *         already staged.
+ */
+psa_status_t its_flash_fs_txn_stage_delete(struct its_flash_fs_txn_t *txn,
+                                           const uint8_t *fid);
+
+/**
+ * \brief Gets the state of a file as left by the updates staged in a
+ *        transaction.
+ *
+ * \param[in]  txn    Transaction
+ * \param[in]  fid    File ID
+ * \param[out] finfo  Set to the info of the staged file content, or to NULL
+ *                    if the deletion of the file is staged
+ *
+ * \return Returns true if an update of the file is staged. Otherwise, the
+ *         state of the file is the one in the filesystem.
+ */
+bool its_flash_fs_txn_get_staged(const struct its_flash_fs_txn_t *txn,
+                                 const uint8_t *fid,
+                                 const struct its_flash_fs_file_info_t **finfo);
+
+/**
+ * \brief Commits all the updates staged in a transaction in a single metadata
+ *        block update, so that either all or none of them take effect.
+ *
+ * \note  The files replaced or deleted by the transaction must be located in
+ *        logical data block 0 and at most one other logical data block, as
+ *        only one data block can be rewritten alongside the metadata block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in,out] txn     Transaction to commit
+ *
+ * \return Returns error code as specified in \ref psa_status_t. In
+ *         particular, PSA_ERROR_DOES_NOT_EXIST if a file to delete does not
+ *         exist, and PSA_ERROR_NOT_SUPPORTED if the files to replace or delete
+ *         are spread over too many logical data blocks.
+ */
+psa_status_t its_flash_fs_txn_commit(its_flash_fs_ctx_t *fs_ctx,
+                                     struct its_flash_fs_txn_t *txn);
+#endif /* ITS_TRANSACTION */
+
 #ifdef __cplusplus
 }
 #endif
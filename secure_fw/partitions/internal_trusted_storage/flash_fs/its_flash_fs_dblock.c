@@ -8,6 +8,12 @@
 #include "its_flash_fs_dblock.h"
 
 #include "its_flash_fs.h"
+#include "its_utils.h"
+
+#if ITS_LOG_STRUCTURED
+/* Size of the buffer used to check that flash is erased */
+#define ITS_DBLOCK_ERASED_CHECK_SIZE 64
+#endif
 
 /**
  * \brief Converts logical data block number to physical number.
@@ -134,13 +140,55 @@ psa_status_t its_flash_fs_dblock_read_file(
     return fs_ctx->ops->read(fs_ctx->cfg, phys_block, buf, pos, size);
 }
 
+/**
+ * \brief Writes the data from a data source to a block, one part at a time.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     phy_id  Physical block number
+ * \param[in]     pos     Position of the data in the block
+ * \param[in]     size    Size of the data
+ * \param[in]     src     Source of the data
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_dblock_write_src(struct its_flash_fs_ctx_t *fs_ctx,
+                                         uint32_t phy_id,
+                                         size_t pos,
+                                         size_t size,
+                                         const struct its_flash_fs_data_src_t *src)
+{
+    const uint8_t *data;
+    size_t offset = 0;
+    size_t part_size;
+    psa_status_t err;
+
+    while (offset < size) {
+        part_size = ITS_UTILS_MIN(size - offset, src->part_size);
+
+        err = src->get_data(src->ctx, offset, part_size, &data);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = fs_ctx->ops->write(fs_ctx->cfg, phy_id, data, pos + offset,
+                                 part_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        offset += part_size;
+    }
+
+    return PSA_SUCCESS;
+}
+
 psa_status_t its_flash_fs_dblock_write_file(
                                       struct its_flash_fs_ctx_t *fs_ctx,
                                       const struct its_block_meta_t *block_meta,
                                       const struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
-                                      const uint8_t *data)
+                                      const struct its_flash_fs_data_src_t *src)
 {
     psa_status_t err;
     uint32_t scratch_id;
@@ -164,7 +212,7 @@ psa_status_t its_flash_fs_dblock_write_file(
     }
 
     /* Write the new file data */
-    err = fs_ctx->ops->write(fs_ctx->cfg, scratch_id, data, pos, size);
+    err = its_dblock_write_src(fs_ctx, scratch_id, pos, size, src);
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -192,3 +240,106 @@ psa_status_t its_flash_fs_dblock_write_file(
 
     return err;
 }
+
+#if ITS_LOG_STRUCTURED
+/**
+ * \brief Checks that a data block area has not been programmed since the block
+ *        was erased.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     phy_id  Physical block number
+ * \param[in]     offset  Offset of the area in the block
+ * \param[in]     size    Size of the area
+ *
+ * \return Returns PSA_ERROR_INSUFFICIENT_STORAGE if the area is not erased.
+ *         Otherwise, error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_dblock_check_erased(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t phy_id,
+                                            size_t offset,
+                                            size_t size)
+{
+    uint8_t buf[ITS_DBLOCK_ERASED_CHECK_SIZE];
+    size_t bytes_to_check;
+    psa_status_t err;
+    size_t i;
+
+    while (size > 0) {
+        bytes_to_check = ITS_UTILS_MIN(size, sizeof(buf));
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, phy_id, buf, offset,
+                                bytes_to_check);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        for (i = 0; i < bytes_to_check; i++) {
+            if (buf[i] != fs_ctx->cfg->erase_val) {
+                return PSA_ERROR_INSUFFICIENT_STORAGE;
+            }
+        }
+
+        offset += bytes_to_check;
+        size -= bytes_to_check;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_dblock_append_file(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t data_idx,
+                                      size_t offset,
+                                      size_t size,
+                                      const struct its_flash_fs_data_src_t *src)
+{
+    psa_status_t err;
+    size_t end;
+
+    /* Calculate the size of the new version which needs to be programmed */
+    end = ITS_UTILS_MAX(ITS_UTILS_ALIGN(file_meta->cur_size,
+                                        fs_ctx->cfg->program_unit),
+                        offset + size);
+
+    /* Never program over data left by an interrupted update */
+    err = its_dblock_check_erased(fs_ctx, block_meta->phy_id, data_idx, end);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Copy the current file content before the new data */
+    if (offset > 0) {
+        err = its_flash_fs_block_to_block_move(fs_ctx, block_meta->phy_id,
+                                               data_idx, block_meta->phy_id,
+                                               file_meta->data_idx, offset);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Write the new file data */
+    err = its_dblock_write_src(fs_ctx, block_meta->phy_id, data_idx + offset,
+                               size, src);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Copy the current file content after the new data */
+    if (end > (offset + size)) {
+        err = its_flash_fs_block_to_block_move(fs_ctx, block_meta->phy_id,
+                                               data_idx + offset + size,
+                                               block_meta->phy_id,
+                                               file_meta->data_idx + offset
+                                               + size,
+                                               end - (offset + size));
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Commit data block modifications to flash */
+    return fs_ctx->ops->flush(fs_ctx->cfg, block_meta->phy_id);
+}
+#endif /* ITS_LOG_STRUCTURED */
@@ -68,7 +68,7 @@ psa_status_t its_flash_fs_dblock_read_file(
  * \param[in]     offset      Offset in the scratch data block where to start
  *                            the copy of the incoming data
  * \param[in]     size        Size of the incoming data
- * \param[in]     data        Pointer to data buffer to copy in the scratch data
+ * \param[in]     src         Source of the data to copy in the scratch data
  *                            block
  *
  * \return Returns error code as specified in \ref psa_status_t
@@ -79,7 +79,39 @@ psa_status_t its_flash_fs_dblock_write_file(
                                       const struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
-                                      const uint8_t *data);
+                                      const struct its_flash_fs_data_src_t *src);
+
+#if ITS_LOG_STRUCTURED
+/**
+ * \brief Writes a new version of a file directly in the active data block, at
+ *        a position which has not been programmed since the block was erased.
+ *
+ * The new version is the current file content with the incoming data written
+ * at the given offset. The scratch data block is not used.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     block_meta  Block metadata
+ * \param[in]     file_meta   Current file metadata
+ * \param[in]     data_idx    Position of the new version in the data block
+ * \param[in]     offset      Offset in the file where to start the copy of the
+ *                            incoming data
+ * \param[in]     size        Size of the incoming data
+ * \param[in]     src         Source of the data to copy in the data block
+ *
+ * \return Returns error code as specified in \ref psa_status_t. Returns
+ *         PSA_ERROR_INSUFFICIENT_STORAGE, without writing anything, if the
+ *         area of the new version is not erased (e.g. because of a power
+ *         failure during an earlier update).
+ */
+psa_status_t its_flash_fs_dblock_append_file(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t data_idx,
+                                      size_t offset,
+                                      size_t size,
+                                      const struct its_flash_fs_data_src_t *src);
+#endif /* ITS_LOG_STRUCTURED */
 
 #ifdef __cplusplus
 }
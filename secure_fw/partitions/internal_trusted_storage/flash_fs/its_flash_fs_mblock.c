@@ -135,6 +135,310 @@ static size_t its_mblock_file_meta_offset(struct its_flash_fs_ctx_t *fs_ctx,
            + (idx * ITS_FILE_METADATA_SIZE);
 }
 
+#if ITS_RAM_FILE_INDEX
+/**
+ * \brief Gets the first hash table bucket to probe for a file ID.
+ *
+ * \param[in] fid  ID of the file
+ *
+ * \return Bucket index
+ */
+static uint32_t its_file_index_hash(const uint8_t *fid)
+{
+    uint32_t i;
+    /* FNV-1a */
+    uint32_t hash = 2166136261U;
+
+    for (i = 0; i < ITS_FILE_ID_SIZE; i++) {
+        hash ^= fid[i];
+        hash *= 16777619U;
+    }
+
+    return hash % ITS_FILE_INDEX_NUM_BUCKETS;
+}
+
+/**
+ * \brief Rebuilds the file index hash table from the cached entries of the
+ *        active metadata block.
+ *
+ * \note If more than one entry has the same ID, only the one with the lowest
+ *       index is inserted, which matches the result of a linear scan of the
+ *       metadata block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void its_file_index_rebuild(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_file_index_t *index = &fs_ctx->file_index;
+    const struct its_file_index_entry_t *entry =
+                                        index->entry[fs_ctx->active_metablock];
+    uint32_t bucket;
+    uint32_t i;
+
+    for (i = 0; i < ITS_FILE_INDEX_NUM_BUCKETS; i++) {
+        index->bucket[i] = ITS_METADATA_INVALID_INDEX;
+    }
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if (its_utils_validate_fid(entry[i].id) != PSA_SUCCESS) {
+            continue;
+        }
+
+        bucket = its_file_index_hash(entry[i].id);
+        while (index->bucket[bucket] != ITS_METADATA_INVALID_INDEX) {
+            if (!memcmp(entry[index->bucket[bucket]].id, entry[i].id,
+                        ITS_FILE_ID_SIZE)) {
+                break;
+            }
+            bucket = (bucket + 1) % ITS_FILE_INDEX_NUM_BUCKETS;
+        }
+
+        if (index->bucket[bucket] == ITS_METADATA_INVALID_INDEX) {
+            index->bucket[bucket] = (uint16_t)i;
+        }
+    }
+}
+
+/**
+ * \brief Looks up a file ID in the file index.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     ID of the file
+ * \param[out]    idx     Index of the file metadata in the file system
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_file_index_lookup(struct its_flash_fs_ctx_t *fs_ctx,
+                                          const uint8_t *fid,
+                                          uint32_t *idx)
+{
+    const struct its_file_index_t *index = &fs_ctx->file_index;
+    const struct its_file_index_entry_t *entry =
+                                        index->entry[fs_ctx->active_metablock];
+    uint32_t bucket = its_file_index_hash(fid);
+    uint32_t probes;
+
+    for (probes = 0; probes < ITS_FILE_INDEX_NUM_BUCKETS; probes++) {
+        if (index->bucket[bucket] == ITS_METADATA_INVALID_INDEX) {
+            break;
+        }
+
+        if (!memcmp(entry[index->bucket[bucket]].id, fid, ITS_FILE_ID_SIZE)) {
+            *idx = index->bucket[bucket];
+            return PSA_SUCCESS;
+        }
+
+        bucket = (bucket + 1) % ITS_FILE_INDEX_NUM_BUCKETS;
+    }
+
+    return PSA_ERROR_DOES_NOT_EXIST;
+}
+
+/**
+ * \brief Caches a file metadata entry written to the scratch metadata block.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     idx        File metadata entry index
+ * \param[in]     file_meta  File metadata entry
+ */
+static void its_file_index_set_scratch(struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t idx,
+                                       const struct its_file_meta_t *file_meta)
+{
+    struct its_file_index_entry_t *entry;
+
+    if (fs_ctx->cfg->max_num_files > ITS_RAM_METADATA_MAX_FILES) {
+        return;
+    }
+
+    entry = &fs_ctx->file_index.entry[fs_ctx->scratch_metablock][idx];
+    memcpy(entry->id, file_meta->id, ITS_FILE_ID_SIZE);
+    entry->flags = file_meta->flags;
+    entry->cur_size = file_meta->cur_size;
+    entry->max_size = file_meta->max_size;
+}
+
+/**
+ * \brief Builds the file index from the file metadata in the active metadata
+ *        block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_file_index_build(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_file_index_entry_t *entry;
+    struct its_file_meta_t file_meta;
+    psa_status_t err;
+    uint32_t i;
+
+    fs_ctx->file_index.valid = false;
+
+    /* The context is configured with more files than the index can track */
+    if (fs_ctx->cfg->max_num_files > ITS_RAM_METADATA_MAX_FILES) {
+        return PSA_SUCCESS;
+    }
+
+    entry = fs_ctx->file_index.entry[fs_ctx->active_metablock];
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        memcpy(entry[i].id, file_meta.id, ITS_FILE_ID_SIZE);
+        entry[i].flags = file_meta.flags;
+        entry[i].cur_size = file_meta.cur_size;
+        entry[i].max_size = file_meta.max_size;
+    }
+
+    its_file_index_rebuild(fs_ctx);
+    fs_ctx->file_index.valid = true;
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_RAM_FILE_INDEX */
+
+#if ITS_RAM_FREE_SPACE_MAP
+/**
+ * \brief Checks if the free space map can track the current context.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return true if the map is large enough for the context, false otherwise
+ */
+static bool its_free_space_map_fits(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return (fs_ctx->cfg->max_num_files <= ITS_RAM_METADATA_MAX_FILES) &&
+           (its_num_active_dblocks(fs_ctx) <= ITS_FREE_SPACE_MAP_MAX_DBLOCKS);
+}
+
+/**
+ * \brief Records whether a file metadata entry is free in the given bank of
+ *        the free space map.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Metadata block ID of the bank to update
+ * \param[in]     idx       File metadata entry index
+ * \param[in]     is_free   true if the entry is free
+ */
+static void its_free_space_map_set_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                        uint32_t block_id, uint32_t idx,
+                                        bool is_free)
+{
+    uint32_t *word = &fs_ctx->free_space_map.free_file[block_id][idx / 32];
+    uint32_t bit = 1UL << (idx % 32);
+
+    if (is_free) {
+        *word |= bit;
+    } else {
+        *word &= ~bit;
+    }
+}
+
+/**
+ * \brief Checks if a file metadata entry of the active metadata block is free.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     idx     File metadata entry index
+ *
+ * \return true if the entry is free, false otherwise
+ */
+static bool its_free_space_map_file_is_free(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t idx)
+{
+    return (fs_ctx->free_space_map.free_file[fs_ctx->active_metablock][idx / 32]
+            & (1UL << (idx % 32))) != 0;
+}
+
+/**
+ * \brief Builds the free space map from the metadata in the active metadata
+ *        block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_free_space_map_build(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_file_meta_t file_meta;
+    struct its_block_meta_t block_meta;
+    psa_status_t err;
+    uint32_t i;
+
+    fs_ctx->free_space_map.valid = false;
+
+    if (!its_free_space_map_fits(fs_ctx)) {
+        return PSA_SUCCESS;
+    }
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        its_free_space_map_set_file(fs_ctx, fs_ctx->active_metablock, i,
+                               its_utils_validate_fid(file_meta.id) != PSA_SUCCESS);
+    }
+
+    for (i = 0; i < its_num_active_dblocks(fs_ctx); i++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        fs_ctx->free_space_map.free_size[fs_ctx->active_metablock][i] =
+                                                          block_meta.free_size;
+    }
+
+    fs_ctx->free_space_map.valid = true;
+
+    return PSA_SUCCESS;
+}
+
+#ifndef NDEBUG
+/**
+ * \brief Checks the free space map against the metadata in the active
+ *        metadata block. If they disagree, the map is no longer used.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void its_free_space_map_check(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_file_meta_t file_meta;
+    struct its_block_meta_t block_meta;
+    bool is_free;
+    uint32_t i;
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if (its_flash_fs_mblock_read_file_meta(fs_ctx, i, &file_meta)
+            != PSA_SUCCESS) {
+            fs_ctx->free_space_map.valid = false;
+            return;
+        }
+
+        is_free = (its_utils_validate_fid(file_meta.id) != PSA_SUCCESS);
+        if (is_free != its_free_space_map_file_is_free(fs_ctx, i)) {
+            fs_ctx->free_space_map.valid = false;
+            return;
+        }
+    }
+
+    for (i = 0; i < its_num_active_dblocks(fs_ctx); i++) {
+        if ((its_flash_fs_mblock_read_block_metadata(fs_ctx, i, &block_meta)
+             != PSA_SUCCESS) ||
+            (block_meta.free_size !=
+             fs_ctx->free_space_map.free_size[fs_ctx->active_metablock][i])) {
+            fs_ctx->free_space_map.valid = false;
+            return;
+        }
+    }
+}
+#endif /* !NDEBUG */
+#endif /* ITS_RAM_FREE_SPACE_MAP */
+
 /**
  * \brief Swaps metablocks. Scratch becomes active and active becomes scratch.
  *
@@ -147,6 +451,25 @@ static void its_mblock_swap_metablocks(struct its_flash_fs_ctx_t *fs_ctx)
     tmp_block = fs_ctx->scratch_metablock;
     fs_ctx->scratch_metablock = fs_ctx->active_metablock;
     fs_ctx->active_metablock = tmp_block;
+
+#if ITS_RAM_FILE_INDEX
+    /* The cached entries of the new active metadata block were filled in while
+     * the scratch metadata block was written.
+     */
+    if (fs_ctx->file_index.valid) {
+        its_file_index_rebuild(fs_ctx);
+    }
+#endif
+
+#if ITS_RAM_FREE_SPACE_MAP && !defined(NDEBUG)
+    /* The bank of the new active metadata block was filled in while the
+     * scratch metadata block was written. Check it against flash in debug
+     * builds.
+     */
+    if (fs_ctx->free_space_map.valid) {
+        its_free_space_map_check(fs_ctx);
+    }
+#endif
 }
 
 /**
@@ -462,6 +785,52 @@ static psa_status_t its_mblock_validate_metadata_xor(
     }
     return PSA_SUCCESS;
 }
+
+/**
+ * \brief Accumulates into the scratch XOR delta the change made by writing a
+ *        metadata entry to the scratch metadata block.
+ *
+ * \note Metadata entries which are copied unchanged from the active metadata
+ *       block do not change the XOR value, so only the entries written through
+ *       this function need to be accounted for. Each entry must be written at
+ *       most once between two erases of the scratch metadata block, which is
+ *       already required to program it in flash.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     offset     Offset of the entry in the metadata block
+ * \param[in]     new_entry  Pointer to the entry written to the scratch block
+ * \param[in]     size       Size of the entry
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_update_xor_delta(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              size_t offset,
+                                              const uint8_t *new_entry,
+                                              size_t size)
+{
+    uint32_t j;
+    psa_status_t err;
+    uint8_t old_entry[ITS_UTILS_MAX(ITS_BLOCK_METADATA_SIZE,
+                                    ITS_FILE_METADATA_SIZE)];
+
+    /* The XOR value is recalculated from the whole scratch metadata block */
+    if (!fs_ctx->scratch_xor_delta_valid) {
+        return PSA_SUCCESS;
+    }
+
+    err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock, old_entry,
+                            offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    for (j = 0; j < size; j++) {
+        fs_ctx->scratch_xor_delta ^= old_entry[j] ^ new_entry[j];
+    }
+
+    return PSA_SUCCESS;
+}
 #endif /* ITS_VALIDATE_METADATA_FROM_FLASH */
 
 /**
@@ -476,33 +845,15 @@ static psa_status_t its_mblock_validate_metadata_xor(
 static uint32_t its_get_free_file_index(struct its_flash_fs_ctx_t *fs_ctx,
                                         bool use_spare)
 {
-    psa_status_t err;
-    uint32_t i;
-    struct its_file_meta_t tmp_metadata;
-
-    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
-        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
-        if (err != PSA_SUCCESS) {
-            return ITS_METADATA_INVALID_INDEX;
-        }
+    uint32_t idx;
 
-        /* Check if this entry is free by checking if ID values is an
-         * invalid ID.
-         */
-        if (its_utils_validate_fid(tmp_metadata.id) != PSA_SUCCESS) {
-            if (!use_spare) {
-                /* Keep the first free file index as a spare, indicate that the
-                 * next free file index should be used and continue searching.
-                 */
-                use_spare = true;
-                continue;
-            }
-            /* Found */
-            return i;
-        }
+    idx = its_flash_fs_mblock_get_free_file_idx(fs_ctx, 0);
+    if (!use_spare && (idx != ITS_METADATA_INVALID_INDEX)) {
+        /* Keep the first free file index as a spare and use the next one */
+        idx = its_flash_fs_mblock_get_free_file_idx(fs_ctx, idx + 1);
     }
 
-    return ITS_METADATA_INVALID_INDEX;
+    return idx;
 }
 
 /**
@@ -517,6 +868,7 @@ static psa_status_t its_mblock_erase_scratch_blocks(
 {
     psa_status_t err;
     uint32_t scratch_datablock;
+    bool erase_dblock = true;
 
     /* For the atomicity of the data update process
      * and power-failure-safe operation, it is necessary that
@@ -532,12 +884,33 @@ static psa_status_t its_mblock_erase_scratch_blocks(
      * only data. Otherwise, if the number of blocks is equal to 2, it means
      * that all data is stored in the metadata block.
      */
-    if (fs_ctx->cfg->num_blocks > 2) {
+#if ITS_LOG_STRUCTURED
+    /* An update which only appended data to a data block has left the scratch
+     * data block erased.
+     */
+    erase_dblock = !fs_ctx->scratch_dblock_erased;
+#endif
+    if ((fs_ctx->cfg->num_blocks > 2) && erase_dblock) {
         scratch_datablock =
             its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
                                                     (ITS_LOGICAL_DBLOCK0 + 1));
         err = fs_ctx->ops->erase(fs_ctx->cfg, scratch_datablock);
+#if ITS_LOG_STRUCTURED
+        fs_ctx->scratch_dblock_erased = (err == PSA_SUCCESS);
+#endif
+    }
+
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    /* The scratch metadata block is now clean and the header of the active
+     * metadata block holds its XOR value, so the XOR value of the next update
+     * can be derived from the entries that it changes.
+     */
+    if (err == PSA_SUCCESS) {
+        fs_ctx->scratch_xor_delta = 0;
+        fs_ctx->scratch_xor_delta_valid = true;
+        fs_ctx->scratch_in_use = false;
     }
+#endif
 
     return err;
 }
@@ -557,37 +930,113 @@ static psa_status_t its_mblock_update_scratch_block_meta(
                                       uint32_t lblock,
                                       const struct its_block_meta_t *block_meta)
 {
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    psa_status_t err;
+#endif
     size_t pos;
 
+#if ITS_RAM_FREE_SPACE_MAP
+    if (its_free_space_map_fits(fs_ctx)) {
+        fs_ctx->free_space_map.free_size[fs_ctx->scratch_metablock][lblock] =
+                                                          block_meta->free_size;
+    }
+#endif
+
     /* Calculate the position */
     pos = its_mblock_block_meta_offset(lblock);
+
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    err = its_mblock_update_xor_delta(fs_ctx, pos, (const uint8_t *)block_meta,
+                                      ITS_BLOCK_METADATA_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
     return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
                               (const uint8_t *)block_meta, pos,
                               ITS_BLOCK_METADATA_SIZE);
 }
 
 /**
- * \brief Copies rest of the block metadata.
+ * \brief Copies the metadata of the dedicated data blocks, except the given
+ *        logical block, from the active to the scratch metadata block.
  *
  * \param[in,out] fs_ctx  Filesystem context
- * \param[in]     lblock  Logical block number to skip
+ * \param[in]     lblock  Logical block number to skip, or ITS_LOGICAL_DBLOCK0
+ *                        to copy all of them
  *
  * \return Returns error code as specified in \ref psa_status_t
  */
-static psa_status_t its_mblock_copy_remaining_block_meta(
+static psa_status_t its_mblock_copy_dblock_meta(
                                               struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t lblock)
 {
-    struct its_block_meta_t block_meta;
     psa_status_t err;
     uint32_t meta_block;
     size_t pos;
     uint32_t scratch_block;
     size_t size;
+#if ITS_RAM_FREE_SPACE_MAP
+    uint32_t i;
+#endif
 
     scratch_block = fs_ctx->scratch_metablock;
     meta_block = fs_ctx->active_metablock;
 
+#if ITS_RAM_FREE_SPACE_MAP
+    if (its_free_space_map_fits(fs_ctx)) {
+        for (i = ITS_LOGICAL_DBLOCK0 + 1; i < its_num_active_dblocks(fs_ctx);
+             i++) {
+            if (i != lblock) {
+                fs_ctx->free_space_map.free_size[scratch_block][i] =
+                                 fs_ctx->free_space_map.free_size[meta_block][i];
+            }
+        }
+    }
+#endif
+
+    /* Copy the metadata blocks between logical block 0 and the logical block
+     * provided in the function.
+     */
+    if (lblock > 1) {
+        pos = its_mblock_block_meta_offset(ITS_LOGICAL_DBLOCK0 + 1);
+
+        size = its_mblock_block_meta_offset(lblock) - pos;
+
+        /* Copy rest of the block data from previous block */
+        /* Data before updated content */
+        err = its_flash_fs_block_to_block_move(fs_ctx, scratch_block, pos,
+                                               meta_block, pos, size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Move meta blocks data after updated content */
+    pos = its_mblock_block_meta_offset(lblock+1);
+
+    size = its_mblock_file_meta_offset(fs_ctx, 0) - pos;
+
+    return its_flash_fs_block_to_block_move(fs_ctx, scratch_block, pos,
+                                            meta_block, pos, size);
+}
+
+/**
+ * \brief Copies rest of the block metadata.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     lblock  Logical block number to skip
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_copy_remaining_block_meta(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t lblock)
+{
+    struct its_block_meta_t block_meta;
+    psa_status_t err;
+
     if (lblock != ITS_LOGICAL_DBLOCK0) {
         /* The file data in the logical block 0 is stored in same physical
          * block where the metadata is stored. A change in the metadata requires
@@ -607,38 +1056,15 @@ static psa_status_t its_mblock_copy_remaining_block_meta(
         /* Update physical ID for logical block 0 to match with the
          * metadata block physical ID.
          */
-        block_meta.phy_id = scratch_block;
+        block_meta.phy_id = fs_ctx->scratch_metablock;
         err = its_mblock_update_scratch_block_meta(fs_ctx, ITS_LOGICAL_DBLOCK0,
                                                    &block_meta);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
         }
-
-        /* Copy the rest of metadata blocks between logical block 0 and
-         * the logical block provided in the function.
-         */
-        if (lblock > 1) {
-            pos = its_mblock_block_meta_offset(ITS_LOGICAL_DBLOCK0 + 1);
-
-            size = its_mblock_block_meta_offset(lblock) - pos;
-
-            /* Copy rest of the block data from previous block */
-            /* Data before updated content */
-            err = its_flash_fs_block_to_block_move(fs_ctx, scratch_block, pos,
-                                                   meta_block, pos, size);
-            if (err != PSA_SUCCESS) {
-                return err;
-            }
-        }
     }
 
-    /* Move meta blocks data after updated content */
-    pos = its_mblock_block_meta_offset(lblock+1);
-
-    size = its_mblock_file_meta_offset(fs_ctx, 0) - pos;
-
-    return its_flash_fs_block_to_block_move(fs_ctx, scratch_block, pos,
-                                            meta_block, pos, size);
+    return its_mblock_copy_dblock_meta(fs_ctx, lblock);
 }
 
 /**
@@ -759,13 +1185,25 @@ static psa_status_t its_mblock_write_scratch_meta_header(
         fs_ctx->meta_block_header.active_swap_count++;
     }
 #if ITS_VALIDATE_METADATA_FROM_FLASH
-    /* Calculate metadata XOR value. */
-    err = its_mblock_calculate_metadata_xor(fs_ctx,
+    if (fs_ctx->scratch_xor_delta_valid) {
+        /* Apply the changes made in the scratch metadata block to the XOR
+         * value of the active metadata block.
+         */
+        fs_ctx->meta_block_header.metadata_xor ^= fs_ctx->scratch_xor_delta;
+    } else {
+        /* Calculate metadata XOR value. */
+        err = its_mblock_calculate_metadata_xor(fs_ctx,
                                        fs_ctx->scratch_metablock,
                                        &fs_ctx->meta_block_header.metadata_xor);
-    if (err != PSA_SUCCESS) {
-        return err;
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
     }
+
+    /* Until the scratch metadata block is erased again, the XOR value must be
+     * recalculated from the whole block.
+     */
+    fs_ctx->scratch_xor_delta_valid = false;
 #else
     fs_ctx->meta_block_header.metadata_xor = 0;
 #endif
@@ -834,32 +1272,13 @@ static psa_status_t its_mblock_upgrade_meta_header(
     fs_ctx->meta_block_header.active_swap_count =
              meta_block_header_comp->active_swap_count;
     fs_ctx->meta_block_header.fs_version = ITS_SUPPORTED_VERSION;
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    /* The backward compatible header does not hold an XOR value */
+    fs_ctx->scratch_xor_delta_valid = false;
+#endif
     return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
 }
 
-/**
- * \brief Reads the active metadata block header into its_system_ctx.
- *
- * \param[in,out] fs_ctx  Filesystem context
- *
- * \return Returns error code as specified in \ref psa_status_t
- */
-static psa_status_t its_mblock_read_meta_header(
-                                              struct its_flash_fs_ctx_t *fs_ctx)
-{
-    psa_status_t err;
-
-    err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
-                            (uint8_t *)&fs_ctx->meta_block_header, 0,
-                            ITS_BLOCK_META_HEADER_SIZE);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
-
-    return its_mblock_validate_header_meta(fs_ctx, &fs_ctx->meta_block_header,
-                                           fs_ctx->active_metablock);
-}
-
 /**
  * \brief Reserves space for an file.
  *
@@ -882,6 +1301,15 @@ static psa_status_t its_mblock_reserve_file(struct its_flash_fs_ctx_t *fs_ctx,
     uint32_t i;
 
     for (i = 0; i < its_num_active_dblocks(fs_ctx); i++) {
+#if ITS_RAM_FREE_SPACE_MAP
+        /* Only read the metadata of a block that has enough free space */
+        if (fs_ctx->free_space_map.valid &&
+            (fs_ctx->free_space_map.free_size[fs_ctx->active_metablock][i]
+             < size)) {
+            continue;
+        }
+#endif
+
         err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, block_meta);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
@@ -963,17 +1391,60 @@ static psa_status_t its_init_get_active_metablock(
     fs_ctx->active_metablock = cur_meta_block;
     fs_ctx->scratch_metablock = ITS_OTHER_META_BLOCK(cur_meta_block);
 
+    /* Keep the header of the active metadata block, which has been validated
+     * above, so that the metadata does not need to be validated again.
+     */
+    fs_ctx->meta_block_header = (cur_meta_block == ITS_METADATA_BLOCK0) ?
+                                h_meta0 : h_meta1;
+
     return PSA_SUCCESS;
 }
 
+void its_flash_fs_mblock_begin_update(struct its_flash_fs_ctx_t *fs_ctx)
+{
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    /* An earlier update which failed before being finalized may have left
+     * entries in the scratch metadata block. The entries written again by this
+     * update would then be counted twice in the XOR delta, so the XOR value
+     * must be calculated from the whole block instead.
+     */
+    if (fs_ctx->scratch_in_use) {
+        fs_ctx->scratch_xor_delta_valid = false;
+    }
+    fs_ctx->scratch_in_use = true;
+#else
+    (void)fs_ctx;
+#endif
+}
+
 psa_status_t its_flash_fs_mblock_cp_file_meta(struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t idx_start,
                                               uint32_t idx_end)
 {
+#if ITS_RAM_FREE_SPACE_MAP
+    uint32_t idx;
+#endif
     /* Calculate the positions of the two indexes in the metadata block */
     size_t pos_start = its_mblock_file_meta_offset(fs_ctx, idx_start);
     size_t pos_end = its_mblock_file_meta_offset(fs_ctx, idx_end);
 
+#if ITS_RAM_FILE_INDEX
+    if (fs_ctx->cfg->max_num_files <= ITS_RAM_METADATA_MAX_FILES) {
+        memcpy(&fs_ctx->file_index.entry[fs_ctx->scratch_metablock][idx_start],
+               &fs_ctx->file_index.entry[fs_ctx->active_metablock][idx_start],
+               (idx_end - idx_start) * sizeof(struct its_file_index_entry_t));
+    }
+#endif
+
+#if ITS_RAM_FREE_SPACE_MAP
+    if (its_free_space_map_fits(fs_ctx)) {
+        for (idx = idx_start; idx < idx_end; idx++) {
+            its_free_space_map_set_file(fs_ctx, fs_ctx->scratch_metablock, idx,
+                                     its_free_space_map_file_is_free(fs_ctx, idx));
+        }
+    }
+#endif
+
     /* Copy all data between the two positions from the scratch metadata block
      * to the active metadata block.
      */
@@ -991,6 +1462,10 @@ uint32_t its_flash_fs_mblock_cur_data_scratch_id(
         return fs_ctx->scratch_metablock;
     }
 
+#if ITS_LOG_STRUCTURED
+    fs_ctx->scratch_dblock_erased = false;
+#endif
+
     return fs_ctx->meta_block_header.scratch_dblock;
 }
 
@@ -1003,6 +1478,35 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
     uint32_t i;
     struct its_file_meta_t tmp_metadata;
 
+#if ITS_RAM_FILE_INDEX
+    if (fs_ctx->file_index.valid) {
+        err = its_file_index_lookup(fs_ctx, fid, &i);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (file_meta == NULL) {
+            *idx = i;
+            return PSA_SUCCESS;
+        }
+
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (!memcmp(file_meta->id, fid, ITS_FILE_ID_SIZE)) {
+            *idx = i;
+            return PSA_SUCCESS;
+        }
+
+        /* The index must never disagree with the metadata block. If it does,
+         * stop using it and fall back to scanning the metadata.
+         */
+        fs_ctx->file_index.valid = false;
+    }
+#endif /* ITS_RAM_FILE_INDEX */
+
     for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
         err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
         if (err != PSA_SUCCESS) {
@@ -1023,6 +1527,36 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
     return PSA_ERROR_DOES_NOT_EXIST;
 }
 
+#if ITS_RAM_FILE_INDEX
+psa_status_t its_flash_fs_mblock_get_cached_file_info(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid,
+                                              size_t *cur_size,
+                                              size_t *max_size,
+                                              uint32_t *flags)
+{
+    const struct its_file_index_entry_t *entry;
+    psa_status_t err;
+    uint32_t idx;
+
+    if (!fs_ctx->file_index.valid) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    err = its_file_index_lookup(fs_ctx, fid, &idx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    entry = &fs_ctx->file_index.entry[fs_ctx->active_metablock][idx];
+    *cur_size = entry->cur_size;
+    *max_size = entry->max_size;
+    *flags = entry->flags;
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_RAM_FILE_INDEX */
+
 psa_status_t its_flash_fs_mblock_get_file_idx_flag(
                                               struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t flags,
@@ -1048,26 +1582,68 @@ psa_status_t its_flash_fs_mblock_get_file_idx_flag(
     return PSA_ERROR_DOES_NOT_EXIST;
 }
 
+uint32_t its_flash_fs_mblock_get_free_file_idx(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t start_idx)
+{
+    psa_status_t err;
+    uint32_t i;
+    bool is_free;
+    struct its_file_meta_t tmp_metadata;
+
+    for (i = start_idx; i < fs_ctx->cfg->max_num_files; i++) {
+#if ITS_RAM_FREE_SPACE_MAP
+        if (fs_ctx->free_space_map.valid) {
+            is_free = its_free_space_map_file_is_free(fs_ctx, i);
+        } else
+#endif
+        {
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
+            if (err != PSA_SUCCESS) {
+                return ITS_METADATA_INVALID_INDEX;
+            }
+
+            /* Check if this entry is free by checking if ID values is an
+             * invalid ID.
+             */
+            is_free = (its_utils_validate_fid(tmp_metadata.id) != PSA_SUCCESS);
+        }
+
+        if (is_free) {
+            /* Found */
+            return i;
+        }
+    }
+
+    return ITS_METADATA_INVALID_INDEX;
+}
+
 psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
 {
     psa_status_t err;
 
+#if ITS_RAM_FILE_INDEX
+    fs_ctx->file_index.valid = false;
+#endif
+#if ITS_RAM_FREE_SPACE_MAP
+    fs_ctx->free_space_map.valid = false;
+#endif
+
     /* Initialize Flash Interface */
     err = fs_ctx->ops->init(fs_ctx->cfg);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
+    /* Find the active metablock and read its header. This is the only point
+     * where the whole metadata is validated against the XOR value in the
+     * header; later updates derive the XOR value from the entries they change.
+     */
     err = its_init_get_active_metablock(fs_ctx);
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
     }
 
-    err = its_mblock_read_meta_header(fs_ctx);
-    if (err != PSA_SUCCESS) {
-        return PSA_ERROR_GENERIC_ERROR;
-    }
-
     /* Erase the other scratch metadata block. It can be used in the later
      * step.
      */
@@ -1077,7 +1653,26 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
     }
 
     /* Upgrade the metadata header if required. */
-    return its_mblock_upgrade_meta_header(fs_ctx);
+    err = its_mblock_upgrade_meta_header(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#if ITS_RAM_FILE_INDEX
+    /* Build the file index once; from now on it is kept up to date as the
+     * metadata blocks are updated.
+     */
+    err = its_file_index_build(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
+#if ITS_RAM_FREE_SPACE_MAP
+    err = its_free_space_map_build(fs_ctx);
+#endif
+
+    return err;
 }
 
 psa_status_t its_flash_fs_mblock_meta_update_finalize(
@@ -1228,6 +1823,23 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
     uint32_t metablock_to_erase_first = ITS_METADATA_BLOCK0;
     struct its_file_meta_t file_metadata;
 
+#if ITS_RAM_FILE_INDEX
+    /* The file index is built again when the filesystem is prepared */
+    fs_ctx->file_index.valid = false;
+#endif
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    /* Neither metadata block holds a valid XOR value */
+    fs_ctx->scratch_xor_delta_valid = false;
+#endif
+#if ITS_RAM_FREE_SPACE_MAP
+    /* The free space map is built again when the filesystem is prepared */
+    fs_ctx->free_space_map.valid = false;
+#endif
+#if ITS_LOG_STRUCTURED
+    /* The scratch data block changes, so it is erased by the next update */
+    fs_ctx->scratch_dblock_erased = false;
+#endif
+
     /* Erase both metadata blocks. If at least one metadata block is valid,
      * ensure that the active metadata block is erased last to prevent rollback
      * in the case of a power failure between the two erases.
@@ -1361,15 +1973,64 @@ psa_status_t its_flash_fs_mblock_update_scratch_block_meta(
     return its_mblock_copy_remaining_block_meta(fs_ctx, lblock);
 }
 
+psa_status_t its_flash_fs_mblock_update_scratch_block_metas(
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            struct its_block_meta_t *lb0_meta,
+                                            uint32_t lblock,
+                                            struct its_block_meta_t *block_meta)
+{
+    psa_status_t err;
+
+    /* Logical block 0 always moves with the metadata block */
+    lb0_meta->phy_id = fs_ctx->scratch_metablock;
+
+    err = its_mblock_update_scratch_block_meta(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                               lb0_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    if (lblock != ITS_LOGICAL_DBLOCK0) {
+        err = its_mblock_update_scratch_block_meta(fs_ctx, lblock, block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    return its_mblock_copy_dblock_meta(fs_ctx, lblock);
+}
+
 psa_status_t its_flash_fs_mblock_update_scratch_file_meta(
                                         struct its_flash_fs_ctx_t *fs_ctx,
                                         uint32_t idx,
                                         const struct its_file_meta_t *file_meta)
 {
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    psa_status_t err;
+#endif
     size_t pos;
 
+#if ITS_RAM_FILE_INDEX
+    its_file_index_set_scratch(fs_ctx, idx, file_meta);
+#endif
+#if ITS_RAM_FREE_SPACE_MAP
+    if (its_free_space_map_fits(fs_ctx)) {
+        its_free_space_map_set_file(fs_ctx, fs_ctx->scratch_metablock, idx,
+                              its_utils_validate_fid(file_meta->id) != PSA_SUCCESS);
+    }
+#endif
+
     /* Calculate the position */
     pos = its_mblock_file_meta_offset(fs_ctx, idx);
+
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    err = its_mblock_update_xor_delta(fs_ctx, pos, (const uint8_t *)file_meta,
+                                      ITS_FILE_METADATA_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
     return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
                               (const uint8_t *)file_meta, pos,
                               ITS_FILE_METADATA_SIZE);
@@ -12,6 +12,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "config_tfm.h"
 #include "flash/its_flash.h"
 #include "its_flash_fs.h"
 #include "its_utils.h"
@@ -179,6 +180,110 @@ struct its_file_meta_t {
 };
 #undef _T3
 
+#if ITS_RAM_FILE_INDEX || ITS_RAM_FREE_SPACE_MAP
+/*!
+ * \def ITS_RAM_METADATA_MAX_FILES
+ *
+ * \brief Defines the largest number of file metadata entries that can be
+ *        tracked in RAM. Filesystem contexts configured with more files than
+ *        this fall back to reading the metadata in flash.
+ */
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+#define ITS_RAM_METADATA_MAX_FILES  ITS_UTILS_MAX(ITS_NUM_ASSETS + 1, \
+                                                  PS_NUM_ASSETS + 3)
+#else
+#define ITS_RAM_METADATA_MAX_FILES  (ITS_NUM_ASSETS + 1)
+#endif
+#endif /* ITS_RAM_FILE_INDEX || ITS_RAM_FREE_SPACE_MAP */
+
+#if ITS_RAM_FILE_INDEX
+/*!
+ * \def ITS_FILE_INDEX_NUM_BUCKETS
+ *
+ * \brief Defines the number of buckets in the RAM file index hash table. Twice
+ *        the number of files keeps the load factor at or below one half, so
+ *        that linear probing terminates after a few probes.
+ */
+#define ITS_FILE_INDEX_NUM_BUCKETS  (2 * ITS_RAM_METADATA_MAX_FILES)
+
+/*!
+ * \struct its_file_index_entry_t
+ *
+ * \brief Structure to cache the file metadata fields needed to answer a lookup
+ *        without reading the metadata block.
+ */
+struct its_file_index_entry_t {
+    uint8_t id[ITS_FILE_ID_SIZE]; /*!< ID of the file */
+    uint32_t flags;               /*!< Flags set when the file was created */
+    size_t cur_size;              /*!< Current size of the file */
+    size_t max_size;              /*!< Maximum size of the file */
+};
+
+/*!
+ * \struct its_file_index_t
+ *
+ * \brief Structure to store the RAM file index.
+ *
+ * \details The cached entries are banked per physical metadata block, so that
+ *          they follow the active/scratch swap of the metadata blocks. The hash
+ *          table maps a file ID to its file metadata entry index in the active
+ *          metadata block and is rebuilt from the RAM entries on every swap.
+ */
+struct its_file_index_t {
+    struct its_file_index_entry_t entry[2][ITS_RAM_METADATA_MAX_FILES];
+    uint16_t bucket[ITS_FILE_INDEX_NUM_BUCKETS]; /*!< File metadata entry
+                                                  *   index, or
+                                                  *   ITS_METADATA_INVALID_INDEX
+                                                  *   if the bucket is empty
+                                                  */
+    bool valid; /*!< True if the index reflects the active metadata block */
+};
+#endif /* ITS_RAM_FILE_INDEX */
+
+#if ITS_RAM_FREE_SPACE_MAP
+/*!
+ * \def ITS_FREE_SPACE_MAP_MAX_DBLOCKS
+ *
+ * \brief Defines the largest number of logical data blocks that the free space
+ *        map can track. Filesystem contexts with more logical data blocks than
+ *        this fall back to reading the block metadata in flash.
+ */
+#ifndef ITS_FREE_SPACE_MAP_MAX_DBLOCKS
+#define ITS_FREE_SPACE_MAP_MAX_DBLOCKS  16
+#endif
+
+/*!
+ * \def ITS_FREE_SPACE_MAP_FILE_WORDS
+ *
+ * \brief Defines the number of 32-bit words in the free file metadata entry
+ *        bitmap.
+ */
+#define ITS_FREE_SPACE_MAP_FILE_WORDS  ((ITS_RAM_METADATA_MAX_FILES + 31) / 32)
+
+/*!
+ * \struct its_free_space_map_t
+ *
+ * \brief Structure to store the free file metadata entries and the free space
+ *        of each logical data block.
+ *
+ * \details Like the file index, the map is banked per physical metadata block:
+ *          the bank of the scratch metadata block is filled in while it is
+ *          written and becomes the active bank when the metadata blocks are
+ *          swapped.
+ */
+struct its_free_space_map_t {
+    uint32_t free_file[2][ITS_FREE_SPACE_MAP_FILE_WORDS]; /*!< Bit set if the
+                                                           *   file metadata
+                                                           *   entry is free
+                                                           */
+    size_t free_size[2][ITS_FREE_SPACE_MAP_MAX_DBLOCKS]; /*!< Free size of
+                                                          *   each logical
+                                                          *   data block
+                                                          */
+    bool valid; /*!< True if the map reflects the active metadata block */
+};
+#endif /* ITS_RAM_FREE_SPACE_MAP */
+
 /**
  * \struct its_flash_fs_ctx_t
  *
@@ -192,6 +297,33 @@ struct its_flash_fs_ctx_t {
                                                            */
     uint32_t active_metablock;  /**< Active metadata block */
     uint32_t scratch_metablock; /**< Scratch metadata block */
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    uint8_t scratch_xor_delta;    /**< XOR of the changes made to the metadata
+                                   *   in the scratch metadata block
+                                   */
+    bool scratch_xor_delta_valid; /**< True if scratch_xor_delta can be applied
+                                   *   to the XOR value of the active metadata
+                                   *   block
+                                   */
+    bool scratch_in_use;          /**< True if an update has been started since
+                                   *   the scratch blocks were last erased
+                                   */
+#endif
+#if ITS_RAM_FILE_INDEX
+    struct its_file_index_t file_index; /**< RAM index of the file metadata */
+#endif
+#if ITS_RAM_FREE_SPACE_MAP
+    struct its_free_space_map_t free_space_map; /**< RAM map of the free file
+                                                 *   metadata entries and data
+                                                 *   block space
+                                                 */
+#endif
+#if ITS_LOG_STRUCTURED
+    bool scratch_dblock_erased; /**< True if the scratch data block has not
+                                 *   been handed out for writing since it was
+                                 *   last erased
+                                 */
+#endif
 };
 
 /**
@@ -203,6 +335,14 @@ struct its_flash_fs_ctx_t {
  */
 psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx);
 
+/**
+ * \brief Starts an update of the scratch metadata block. Must be called before
+ *        the first scratch block write of each create/write/delete operation.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+void its_flash_fs_mblock_begin_update(struct its_flash_fs_ctx_t *fs_ctx);
+
 /**
  * \brief Copies the file metadata entries between two indexes from the active
  *        metadata block to the scratch metadata block.
@@ -220,6 +360,9 @@ psa_status_t its_flash_fs_mblock_cp_file_meta(struct its_flash_fs_ctx_t *fs_ctx,
 /**
  * \brief Gets current scratch datablock physical ID.
  *
+ * \note  The scratch data block of a dedicated data block is assumed to be
+ *        written by the caller, so it is erased at the end of the update.
+ *
  * \param[in,out] fs_ctx  Filesystem context
  * \param[in]     lblock  Logical block number
  *
@@ -245,6 +388,29 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
                                                    const uint8_t *fid,
                                                    uint32_t *idx,
                                                    struct its_file_meta_t *file_meta);
+#if ITS_RAM_FILE_INDEX
+/**
+ * \brief Gets the size and flags of a file from the RAM file index, without
+ *        reading the metadata block.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     fid       ID of the file
+ * \param[out]    cur_size  Current size of the file
+ * \param[out]    max_size  Maximum size of the file
+ * \param[out]    flags     Flags set when the file was created
+ *
+ * \return Returns error code as specified in \ref psa_status_t. If the index
+ *         is not available for this context, PSA_ERROR_NOT_SUPPORTED is
+ *         returned and the caller must read the metadata block instead.
+ */
+psa_status_t its_flash_fs_mblock_get_cached_file_info(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid,
+                                              size_t *cur_size,
+                                              size_t *max_size,
+                                              uint32_t *flags);
+#endif /* ITS_RAM_FILE_INDEX */
+
 /**
  * \brief Gets file metadata entry index of the first file with one of the
  *        provided flags set.
@@ -260,6 +426,19 @@ psa_status_t its_flash_fs_mblock_get_file_idx_flag(
                                               uint32_t flags,
                                               uint32_t *idx);
 
+/**
+ * \brief Gets the first free file metadata entry at or after the given index.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     start_idx  File metadata entry index to start the search
+ *
+ * \return Returns the index of the free file metadata entry, or
+ *         ITS_METADATA_INVALID_INDEX if there is none
+ */
+uint32_t its_flash_fs_mblock_get_free_file_idx(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t start_idx);
+
 /**
  * \brief Finalizes an update operation.
  *        Last step when a create/write/delete is performed.
@@ -390,6 +569,27 @@ psa_status_t its_flash_fs_mblock_update_scratch_block_meta(
                                            uint32_t lblock,
                                            struct its_block_meta_t *block_meta);
 
+/**
+ * \brief Puts the metadata of logical block 0 and, optionally, of one other
+ *        logical block in the scratch metadata block, and copies the metadata
+ *        of the remaining logical blocks from the active metadata block.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in,out] lb0_meta    Pointer to the metadata of logical block 0. Its
+ *                            physical ID is set to the scratch metadata block.
+ * \param[in]     lblock      Logical block number of the other block, or
+ *                            ITS_LOGICAL_DBLOCK0 if there is none
+ * \param[in]     block_meta  Pointer to the other block's metadata. Ignored
+ *                            when lblock is ITS_LOGICAL_DBLOCK0.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_update_scratch_block_metas(
+                                           struct its_flash_fs_ctx_t *fs_ctx,
+                                           struct its_block_meta_t *lb0_meta,
+                                           uint32_t lblock,
+                                           struct its_block_meta_t *block_meta);
+
 /**
  * \brief Writes a file metadata entry into scratch metadata block.
  *
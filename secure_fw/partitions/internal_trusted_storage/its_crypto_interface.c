@@ -9,6 +9,7 @@
 
 #include "flash_fs/its_flash_fs.h"
 #include "flash/its_flash.h"
+#include "its_crypto_interface.h"
 #include "its_utils.h"
 #include "psa_manifest/pid.h"
 #include "tfm_hal_its_encryption.h"
@@ -83,6 +84,220 @@ static psa_status_t tfm_hal_to_psa_error(enum tfm_hal_status_t tfm_hal_err)
     }
 }
 
+#if ITS_ENCRYPTION_CHUNK_SIZE
+size_t tfm_its_crypt_plain_size(size_t stored_size)
+{
+    size_t num_chunks = (stored_size + ITS_ENC_CHUNK_STORED_SIZE - 1) /
+                        ITS_ENC_CHUNK_STORED_SIZE;
+
+    if (num_chunks == 0) {
+        num_chunks = 1;
+    }
+
+    if (stored_size < num_chunks * ITS_ENC_CHUNK_OVERHEAD) {
+        return 0;
+    }
+
+    return stored_size - (num_chunks * ITS_ENC_CHUNK_OVERHEAD);
+}
+
+psa_status_t tfm_its_crypt_init(struct its_flash_fs_file_info_t *finfo,
+                                uint8_t *fid,
+                                const size_t fid_size,
+                                const size_t data_size,
+                                const bool is_encrypt)
+{
+    enum tfm_hal_status_t err;
+    psa_status_t status;
+
+    if (finfo == NULL) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* The additional data of every chunk holds the plaintext size of the
+     * whole file, so that a truncated file fails the authentication.
+     */
+    status = tfm_its_fill_enc_add(finfo->add,
+                                  sizeof(finfo->add),
+                                  fid,
+                                  fid_size,
+                                  finfo->flags,
+                                  data_size);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    if (is_encrypt) {
+        /* Each write of the file gets a fresh file nonce, stored in its
+         * metadata and authenticated with every chunk, so that chunks of
+         * different versions of the file cannot be mixed. Each chunk is
+         * stored with its own nonce and tag.
+         */
+        err = tfm_hal_its_aead_generate_nonce(finfo->nonce,
+                                              sizeof(finfo->nonce));
+        if (err != TFM_HAL_SUCCESS) {
+            return tfm_hal_to_psa_error(err);
+        }
+        memset(finfo->tag, 0, sizeof(finfo->tag));
+        finfo->size_max = ITS_ENC_STORED_SIZE(data_size);
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_crypt_chunk(struct its_flash_fs_file_info_t *finfo,
+                                 uint8_t *fid,
+                                 const size_t fid_size,
+                                 const uint32_t chunk_idx,
+                                 const uint8_t *input,
+                                 const size_t input_size,
+                                 uint8_t *output,
+                                 const size_t output_size,
+                                 const bool is_encrypt)
+{
+    struct tfm_hal_its_auth_crypt_ctx aead_ctx = {0};
+    uint8_t nonce[TFM_ITS_ENC_NONCE_LENGTH];
+    uint8_t tag[TFM_ITS_AUTH_TAG_LENGTH];
+    uint8_t aad[sizeof(finfo->add) + sizeof(finfo->nonce) + sizeof(chunk_idx)];
+    enum tfm_hal_status_t err;
+    size_t data_size;
+
+    if (finfo == NULL || input == NULL || output == NULL) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* The size of the plaintext of the chunk */
+    if (is_encrypt) {
+        data_size = input_size;
+        if (output_size < data_size + ITS_ENC_CHUNK_OVERHEAD) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    } else {
+        if (input_size < ITS_ENC_CHUNK_OVERHEAD) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        data_size = input_size - ITS_ENC_CHUNK_OVERHEAD;
+        if (output_size < data_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    if (data_size > ITS_ENCRYPTION_CHUNK_SIZE) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Every chunk is encrypted with a fresh nonce from the HAL, which is
+     * stored in front of the ciphertext.
+     */
+    if (is_encrypt) {
+        err = tfm_hal_its_aead_generate_nonce(nonce, sizeof(nonce));
+        if (err != TFM_HAL_SUCCESS) {
+            return tfm_hal_to_psa_error(err);
+        }
+    } else {
+        memcpy(nonce, input, sizeof(nonce));
+        input += sizeof(nonce);
+    }
+
+    /* The additional data of the file, the file nonce and the chunk index */
+    memcpy(aad, finfo->add, sizeof(finfo->add));
+    memcpy(aad + sizeof(finfo->add), finfo->nonce, sizeof(finfo->nonce));
+    memcpy(aad + sizeof(finfo->add) + sizeof(finfo->nonce), &chunk_idx,
+           sizeof(chunk_idx));
+
+    /* Set all required parameters for the aead operation context */
+    aead_ctx.nonce = nonce;
+    aead_ctx.nonce_size = sizeof(nonce);
+    aead_ctx.deriv_label = fid;
+    aead_ctx.deriv_label_size = fid_size;
+    aead_ctx.aad = aad;
+    aead_ctx.add_size = sizeof(aad);
+
+    if (is_encrypt) {
+        err = tfm_hal_its_aead_encrypt(&aead_ctx,
+                                       input,
+                                       data_size,
+                                       output + sizeof(nonce),
+                                       data_size,
+                                       tag,
+                                       sizeof(tag));
+        if (err == TFM_HAL_SUCCESS) {
+            /* The nonce is stored before the ciphertext, the tag after it */
+            memcpy(output, nonce, sizeof(nonce));
+            memcpy(output + sizeof(nonce) + data_size, tag, sizeof(tag));
+        }
+    } else {
+        memcpy(tag, input + data_size, sizeof(tag));
+        err = tfm_hal_its_aead_decrypt(&aead_ctx,
+                                       input,
+                                       data_size,
+                                       tag,
+                                       sizeof(tag),
+                                       output,
+                                       output_size);
+    }
+
+    return tfm_hal_to_psa_error(err);
+}
+
+psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
+                                uint8_t *fid,
+                                const size_t fid_size,
+                                const uint8_t *input,
+                                const size_t input_size,
+                                uint8_t *output,
+                                const size_t output_size,
+                                const bool is_encrypt)
+{
+    psa_status_t status;
+    uint32_t chunk_idx = 0;
+    size_t data_size;
+    size_t chunk_size;
+    size_t in_size;
+    size_t out_size;
+
+    /* The plaintext size of the whole file */
+    if (is_encrypt) {
+        data_size = input_size;
+        if (output_size < ITS_ENC_STORED_SIZE(data_size)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    } else {
+        data_size = tfm_its_crypt_plain_size(input_size);
+        if (input_size != ITS_ENC_STORED_SIZE(data_size) ||
+            output_size < data_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    status = tfm_its_crypt_init(finfo, fid, fid_size, data_size, is_encrypt);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    do {
+        chunk_size = ITS_UTILS_MIN(data_size, ITS_ENCRYPTION_CHUNK_SIZE);
+        in_size = is_encrypt ? chunk_size
+                             : chunk_size + ITS_ENC_CHUNK_OVERHEAD;
+        out_size = is_encrypt ? chunk_size + ITS_ENC_CHUNK_OVERHEAD
+                              : chunk_size;
+
+        status = tfm_its_crypt_chunk(finfo, fid, fid_size, chunk_idx,
+                                     input, in_size, output, out_size,
+                                     is_encrypt);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        input += in_size;
+        output += out_size;
+        data_size -= chunk_size;
+        chunk_idx++;
+    } while (data_size > 0);
+
+    return PSA_SUCCESS;
+}
+#else
 psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
                                 uint8_t *fid,
                                 const size_t fid_size,
@@ -163,4 +378,4 @@ psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
 
     return PSA_SUCCESS;
 }
-
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
@@ -29,6 +29,10 @@
  * \param[in]   output_size   Output size in bytes
  * \param[in]   is_encrypt    Set the operation type (encryption/decryption)
  *
+ * \note When ITS_ENCRYPTION_CHUNK_SIZE is not 0, the encrypted file is made
+ *       of chunks, as written by \ref tfm_its_crypt_chunk, and its size is
+ *       given by ITS_ENC_STORED_SIZE.
+ *
  * \return PSA_SUCCESS on successful operation or a valid PSA error code
  *
  */
@@ -41,3 +45,95 @@ psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
                                 const size_t output_size,
                                 const bool is_encrypt);
 
+#if ITS_ENCRYPTION_CHUNK_SIZE
+/* Size in bytes of the data stored with each chunk: its nonce and its
+ * authentication tag.
+ */
+#define ITS_ENC_CHUNK_OVERHEAD (TFM_ITS_ENC_NONCE_LENGTH + \
+                                TFM_ITS_AUTH_TAG_LENGTH)
+
+/* Size in bytes of an encrypted chunk in the filesystem: the nonce of the
+ * chunk, its ciphertext and its authentication tag.
+ */
+#define ITS_ENC_CHUNK_STORED_SIZE (ITS_ENCRYPTION_CHUNK_SIZE + \
+                                   ITS_ENC_CHUNK_OVERHEAD)
+
+/* Number of chunks of a file with the given plaintext size. An empty file
+ * still has one chunk, so that its metadata is authenticated.
+ */
+#define ITS_ENC_NUM_CHUNKS(size) \
+    (((size) == 0) ? 1 : ((((size) - 1) / ITS_ENCRYPTION_CHUNK_SIZE) + 1))
+
+/* Size in bytes of the encrypted file with the given plaintext size */
+#define ITS_ENC_STORED_SIZE(size) \
+    ((size) + (ITS_ENC_NUM_CHUNKS(size) * ITS_ENC_CHUNK_OVERHEAD))
+
+/**
+ * \brief Gets the plaintext size of an encrypted file.
+ *
+ * \param[in]  stored_size  Size in bytes of the file in the filesystem
+ *
+ * \return Size in bytes of the plaintext, or 0 if stored_size cannot be the
+ *         size of an encrypted file
+ */
+size_t tfm_its_crypt_plain_size(size_t stored_size);
+
+/**
+ * \brief Prepares the encryption/decryption of a file chunk by chunk
+ *
+ * \details Fills the additional data of the file info. On encryption, it also
+ *          generates a new file nonce into the file info, to be stored in the
+ *          file metadata, and sets the maximum size of the file info to the
+ *          size of the encrypted file. The tag of the file info is not used,
+ *          as each chunk is stored with its own.
+ *
+ * \param[in,out] finfo       Pointer to \ref its_flash_fs_file_info_t
+ * \param[in]     fid         File identifier
+ * \param[in]     fid_size    File identifier size in bytes
+ * \param[in]     data_size   Plaintext size of the whole file in bytes
+ * \param[in]     is_encrypt  Set the operation type (encryption/decryption)
+ *
+ * \return PSA_SUCCESS on successful operation or a valid PSA error code
+ */
+psa_status_t tfm_its_crypt_init(struct its_flash_fs_file_info_t *finfo,
+                                uint8_t *fid,
+                                const size_t fid_size,
+                                const size_t data_size,
+                                const bool is_encrypt);
+
+/**
+ * \brief Performs the encryption/decryption of one chunk of a file
+ *
+ * \details tfm_its_crypt_init must have been called on finfo first. On
+ *          encryption, a new nonce is generated for the chunk, and the output
+ *          is the nonce followed by the ciphertext and the tag. On decryption,
+ *          the input must be in the same layout. The file nonce and the chunk
+ *          index are authenticated with the data, so that chunks cannot be
+ *          reordered nor taken from another version of the file.
+ *
+ * \param[in]  finfo        Pointer to \ref its_flash_fs_file_info_t
+ * \param[in]  fid          File identifier
+ * \param[in]  fid_size     File identifier size in bytes
+ * \param[in]  chunk_idx    Index of the chunk in the file
+ * \param[in]  input        Input buffer
+ * \param[in]  input_size   Input size in bytes
+ * \param[out] output       Output buffer
+ * \param[in]  output_size  Output size in bytes
+ * \param[in]  is_encrypt   Set the operation type (encryption/decryption)
+ *
+ * \return PSA_SUCCESS on successful operation or a valid PSA error code
+ */
+psa_status_t tfm_its_crypt_chunk(struct its_flash_fs_file_info_t *finfo,
+                                 uint8_t *fid,
+                                 const size_t fid_size,
+                                 const uint32_t chunk_idx,
+                                 const uint8_t *input,
+                                 const size_t input_size,
+                                 uint8_t *output,
+                                 const size_t output_size,
+                                 const bool is_encrypt);
+#else
+/* Size in bytes of the encrypted file with the given plaintext size */
+#define ITS_ENC_STORED_SIZE(size) (size)
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
+
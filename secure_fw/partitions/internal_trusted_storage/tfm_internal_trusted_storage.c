@@ -28,6 +28,15 @@
 #include "its_crypto_interface.h"
 #endif
 
+#if defined(ITS_ENCRYPTION) && ITS_ENCRYPTION_CHUNK_SIZE && \
+    defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
+/* Encrypted files are streamed to/from the filesystem one chunk at a time */
+#define ITS_ENCRYPTION_CHUNKED
+#if (ITS_ENC_CHUNK_STORED_SIZE % ITS_FLASH_MAX_ALIGNMENT) != 0
+#error "ITS_ENCRYPTION_CHUNK_SIZE + TFM_ITS_ENC_NONCE_LENGTH + TFM_ITS_AUTH_TAG_LENGTH must be a multiple of the flash program unit"
+#endif
+#endif
+
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
 #include "ps_object_defs.h"
 #endif
@@ -54,8 +63,16 @@ static its_flash_fs_ctx_t fs_ctx_its;
 static struct its_flash_fs_config_t fs_cfg_its = {
     .flash_dev = &ITS_FLASH_DEV,
     .program_unit = ITS_FLASH_ALIGNMENT,
+#ifdef ITS_ENCRYPTION
+    .max_file_size = ITS_UTILS_ALIGN(ITS_ENC_STORED_SIZE(ITS_MAX_ASSET_SIZE),
+                                     ITS_FLASH_ALIGNMENT),
+#else
     .max_file_size = ITS_UTILS_ALIGN(ITS_MAX_ASSET_SIZE, ITS_FLASH_ALIGNMENT),
+#endif
     .max_num_files = ITS_NUM_ASSETS + 1, /* Extra file for atomic replacement */
+#if ITS_LOG_STRUCTURED
+    .log_structured = ITS_FLASH_LOG_STRUCTURED,
+#endif
 };
 #endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
@@ -66,6 +83,9 @@ static struct its_flash_fs_config_t fs_cfg_ps = {
     .program_unit = PS_FLASH_ALIGNMENT,
     .max_file_size = ITS_UTILS_ALIGN(PS_MAX_OBJECT_SIZE, PS_FLASH_ALIGNMENT),
     .max_num_files = PS_MAX_NUM_OBJECTS,
+#if ITS_LOG_STRUCTURED
+    .log_structured = PS_FLASH_LOG_STRUCTURED,
+#endif
 };
 #endif
 
@@ -85,12 +105,199 @@ static its_flash_fs_ctx_t *get_fs_ctx(int32_t client_id)
 }
 
 #ifdef ITS_ENCRYPTION
+#if !defined(ITS_ENCRYPTION_CHUNKED) || ITS_TRANSACTION
 /* Buffer to store the encrypted asset data before it is stored in the
  * filesystem.
  */
-static uint8_t enc_asset_data[ITS_UTILS_ALIGN(ITS_BUF_SIZE,
+static uint8_t enc_asset_data[ITS_UTILS_ALIGN(ITS_ENC_STORED_SIZE(ITS_BUF_SIZE),
+                                              ITS_FLASH_MAX_ALIGNMENT)];
+#endif
+
+#ifdef ITS_ENCRYPTION_CHUNKED
+/* Buffers to stream an encrypted file one chunk at a time. A stored chunk is
+ * the nonce of the chunk, its ciphertext and its tag.
+ */
+static uint8_t enc_chunk_data[ITS_UTILS_ALIGN(ITS_ENC_CHUNK_STORED_SIZE,
                                               ITS_FLASH_MAX_ALIGNMENT)];
+static uint8_t plain_chunk_data[ITS_ENCRYPTION_CHUNK_SIZE];
+
+static bool tfm_its_is_encrypted(int32_t client_id)
+{
+/* With protected storage no encryption is used */
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    return client_id != TFM_SP_PS;
+#else
+    (void)client_id;
+    return true;
+#endif /* TFM_PARTITION_PROTECTED_STORAGE */
+}
+
+/* Context of the data source which encrypts the asset data from the caller */
+struct its_enc_src_ctx_t {
+    size_t data_length;         /* Size of the asset data left to encrypt */
+    uint32_t chunk_idx;         /* Index of the next chunk to encrypt */
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    const uint8_t *vec_data;    /* Asset data left to encrypt */
+#endif
+};
+
+/**
+ * \brief Data source of an encrypted file. Reads the next chunk of the asset
+ *        data from the caller and encrypts it.
+ *
+ * \details The parts requested by the filesystem are the stored chunks, in
+ *          order. See \ref its_flash_fs_data_src_t.
+ */
+static psa_status_t tfm_its_enc_get_data(void *ctx, size_t offset, size_t size,
+                                         const uint8_t **data)
+{
+    struct its_enc_src_ctx_t *enc_ctx = (struct its_enc_src_ctx_t *)ctx;
+    psa_status_t status;
+    const uint8_t *chunk;
+    size_t chunk_size;
+
+    /* Each chunk is encrypted only once, so it cannot be requested again */
+    if ((offset != enc_ctx->chunk_idx * ITS_ENC_CHUNK_STORED_SIZE) ||
+        (size > sizeof(enc_chunk_data))) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    chunk_size = ITS_UTILS_MIN(enc_ctx->data_length, ITS_ENCRYPTION_CHUNK_SIZE);
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    chunk = enc_ctx->vec_data;
+    enc_ctx->vec_data += chunk_size;
+#else
+    /* Read asset data from the caller */
+    (void)its_req_mngr_read(plain_chunk_data, chunk_size);
+    chunk = plain_chunk_data;
+#endif
+
+    status = tfm_its_crypt_chunk(&g_file_info, g_fid, sizeof(g_fid),
+                                 enc_ctx->chunk_idx, chunk, chunk_size,
+                                 enc_chunk_data, sizeof(enc_chunk_data),
+                                 true);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    enc_ctx->data_length -= chunk_size;
+    enc_ctx->chunk_idx++;
+    *data = enc_chunk_data;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Encrypts the asset data from the caller and writes it to the
+ *        filesystem, one chunk at a time.
+ *
+ * \details The chunks are encrypted while they are written, and the new file
+ *          content is committed in a single filesystem update. The old content
+ *          is kept if the write fails or is interrupted.
+ *
+ * \param[in] client_id    Identifier of the asset's owner (client)
+ * \param[in] data_length  Size of the asset data in bytes
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t tfm_its_set_encrypted(int32_t client_id,
+                                          size_t data_length)
+{
+    psa_status_t status;
+    struct its_enc_src_ctx_t enc_ctx = {
+        .data_length = data_length,
+        .chunk_idx = 0,
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        .vec_data = its_req_mngr_get_vec_base(),
+#endif
+    };
+    const struct its_flash_fs_data_src_t src = {
+        .get_data = tfm_its_enc_get_data,
+        .ctx = &enc_ctx,
+        .part_size = ITS_ENC_CHUNK_STORED_SIZE,
+    };
+
+    status = tfm_its_crypt_init(&g_file_info, g_fid, sizeof(g_fid),
+                                data_length, true);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    return its_flash_fs_file_write_src(get_fs_ctx(client_id), g_fid,
+                                       &g_file_info,
+                                       ITS_ENC_STORED_SIZE(data_length), 0,
+                                       &src);
+}
+
+static psa_status_t tfm_its_get_encrypted(int32_t client_id,
+                         size_t data_offset,
+                         size_t data_size,
+                         size_t *p_data_length)
+{
+    psa_status_t status;
+    uint32_t chunk_idx = data_offset / ITS_ENCRYPTION_CHUNK_SIZE;
+    size_t chunk_offset = data_offset % ITS_ENCRYPTION_CHUNK_SIZE;
+    size_t chunk_size;
+    size_t copy_size;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    uint8_t *vec_data = its_req_mngr_get_vec_base();
+#endif
+
+    if (data_size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    status = tfm_its_crypt_init(&g_file_info, g_fid, sizeof(g_fid),
+                                g_file_info.size_current, false);
+    if (status != PSA_SUCCESS) {
+        *p_data_length = 0;
+        return status;
+    }
+
+    /* Only the chunks holding the requested data are read and decrypted */
+    do {
+        chunk_size = ITS_UTILS_MIN(g_file_info.size_current -
+                                   (chunk_idx * ITS_ENCRYPTION_CHUNK_SIZE),
+                                   ITS_ENCRYPTION_CHUNK_SIZE);
+
+        status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid,
+                                        chunk_size + ITS_ENC_CHUNK_OVERHEAD,
+                                        chunk_idx * ITS_ENC_CHUNK_STORED_SIZE,
+                                        enc_chunk_data);
+        if (status != PSA_SUCCESS) {
+            *p_data_length = 0;
+            return status;
+        }
+
+        status = tfm_its_crypt_chunk(&g_file_info, g_fid, sizeof(g_fid),
+                                     chunk_idx, enc_chunk_data,
+                                     chunk_size + ITS_ENC_CHUNK_OVERHEAD,
+                                     plain_chunk_data, sizeof(plain_chunk_data),
+                                     false);
+        if (status != PSA_SUCCESS) {
+            *p_data_length = 0;
+            return status;
+        }
+
+        copy_size = ITS_UTILS_MIN(chunk_size - chunk_offset, data_size);
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        memcpy(vec_data, plain_chunk_data + chunk_offset, copy_size);
+        vec_data += copy_size;
+#else
+        /* Write asset data to the caller */
+        its_req_mngr_write(plain_chunk_data + chunk_offset, copy_size);
+#endif
+
+        data_size -= copy_size;
+        chunk_offset = 0;
+        chunk_idx++;
+    } while (data_size > 0);
 
+    return PSA_SUCCESS;
+}
+#else
 static psa_status_t buffer_size_check(int32_t client_id, size_t buffer_size)
 {
 /* With protected storage no encryption is used */
@@ -188,6 +395,7 @@ static psa_status_t tfm_its_get_encrypted(int32_t client_id,
 
     return PSA_SUCCESS;
 }
+#endif /* ITS_ENCRYPTION_CHUNKED */
 #endif /* ITS_ENCRYPTION */
 
 /**
@@ -374,6 +582,10 @@ psa_status_t tfm_its_init(void)
 
 static psa_status_t get_file_info(psa_storage_uid_t uid, int32_t client_id)
 {
+#ifdef ITS_ENCRYPTION_CHUNKED
+    psa_status_t status;
+
+#endif
     /* Check that the UID is valid */
     if (uid == TFM_ITS_INVALID_UID) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -383,8 +595,21 @@ static psa_status_t get_file_info(psa_storage_uid_t uid, int32_t client_id)
     tfm_its_get_fid(client_id, uid, g_fid);
 
     /* Read file info */
+#ifdef ITS_ENCRYPTION_CHUNKED
+    status = its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
+                                        &g_file_info);
+    if (status == PSA_SUCCESS && tfm_its_is_encrypted(client_id)) {
+        /* Report the size of the plaintext, without the nonces and tags */
+        g_file_info.size_current =
+                            tfm_its_crypt_plain_size(g_file_info.size_current);
+        g_file_info.size_max = tfm_its_crypt_plain_size(g_file_info.size_max);
+    }
+
+    return status;
+#else
     return its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
                                       &g_file_info);
+#endif /* ITS_ENCRYPTION_CHUNKED */
 }
 
 
@@ -397,7 +622,7 @@ static psa_status_t tfm_its_write_data_to_fs(const int32_t client_id,
 {
     psa_status_t status;
     uint8_t *buffer_ptr = data;
-#ifdef ITS_ENCRYPTION /* ITS_ENCRYPTION */
+#if defined(ITS_ENCRYPTION) && !defined(ITS_ENCRYPTION_CHUNKED)
     status = tfm_its_crypt_data(client_id, &buffer_ptr, data_size, offset);
     if (status != PSA_SUCCESS) {
         return status;
@@ -437,7 +662,8 @@ psa_status_t tfm_its_set(int32_t client_id,
         return PSA_ERROR_NOT_SUPPORTED;
     }
 
-#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE && \
+    !defined ITS_ENCRYPTION_CHUNKED
     status = buffer_size_check(client_id, data_length);
     if (status != PSA_SUCCESS) {
         return status;
@@ -464,6 +690,11 @@ psa_status_t tfm_its_set(int32_t client_id,
     g_file_info.flags = (uint32_t)create_flags |
                         ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE;
 
+#ifdef ITS_ENCRYPTION_CHUNKED
+    if (tfm_its_is_encrypted(client_id)) {
+        return tfm_its_set_encrypted(client_id, data_length);
+    }
+#endif /* ITS_ENCRYPTION_CHUNKED */
 
 #ifndef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
     /* Write to the file in the file system
@@ -587,7 +818,8 @@ psa_status_t tfm_its_get(int32_t client_id,
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE && \
+    !defined ITS_ENCRYPTION_CHUNKED
     status = buffer_size_check(client_id, data_offset + data_size);
     if (status != PSA_SUCCESS) {
         return status;
@@ -677,3 +909,184 @@ psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
     /* Delete old file from the persistent area */
     return its_flash_fs_file_delete(get_fs_ctx(client_id), g_fid);
 }
+
+#if ITS_TRANSACTION && defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
+static struct its_flash_fs_txn_t g_txn;
+
+/**
+ * \brief Checks the operations of a transaction, before any data is read.
+ *
+ * \param[in] ops          Array of operations
+ * \param[in] num_ops      Number of operations in ops
+ * \param[in] data_length  Size of the data of the set operations
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t tfm_its_check_transaction(
+                                    const struct tfm_its_transaction_op_t *ops,
+                                    size_t num_ops,
+                                    size_t data_length)
+{
+    size_t total_length = 0;
+    size_t i;
+
+    for (i = 0; i < num_ops; i++) {
+        /* Check that the UID is valid */
+        if (ops[i].uid == TFM_ITS_INVALID_UID) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        if (ops[i].type == TFM_ITS_TRANSACTION_OP_SET) {
+            /* Check that the create_flags does not contain any unsupported
+             * flags
+             */
+            if (ops[i].create_flags & ~(PSA_STORAGE_FLAG_WRITE_ONCE |
+                                        PSA_STORAGE_FLAG_NO_CONFIDENTIALITY |
+                                        PSA_STORAGE_FLAG_NO_REPLAY_PROTECTION)) {
+                return PSA_ERROR_NOT_SUPPORTED;
+            }
+
+            if (ops[i].data_length > data_length - total_length) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+            total_length += ops[i].data_length;
+        } else if (ops[i].type != TFM_ITS_TRANSACTION_OP_REMOVE) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    /* The data must be fully used by the set operations */
+    if (total_length != data_length) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_transaction(int32_t client_id,
+                                 const struct tfm_its_transaction_op_t *ops,
+                                 size_t num_ops,
+                                 size_t data_length)
+{
+    const struct its_flash_fs_file_info_t *staged_info;
+    psa_status_t status;
+    const uint8_t *data;
+    size_t i;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    const uint8_t *vec_data = its_req_mngr_get_vec_base();
+#else
+    size_t offset = 0;
+#endif
+#ifdef ITS_ENCRYPTION
+    size_t enc_offset = 0;
+    size_t enc_size;
+#endif
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    /* The Protected Storage partition keeps its objects consistent itself */
+    if (client_id == TFM_SP_PS) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    status = tfm_its_check_transaction(ops, num_ops, data_length);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    its_flash_fs_txn_begin(&g_txn);
+
+    for (i = 0; i < num_ops; i++) {
+        /* Each operation applies to the uid as left by the earlier operations
+         * of the transaction, so read the staged file info if there is one.
+         */
+        tfm_its_get_fid(client_id, ops[i].uid, g_fid);
+        if (its_flash_fs_txn_get_staged(&g_txn, g_fid, &staged_info)) {
+            if (staged_info != NULL) {
+                g_file_info = *staged_info;
+                status = PSA_SUCCESS;
+            } else {
+                status = PSA_ERROR_DOES_NOT_EXIST;
+            }
+        } else {
+            status = get_file_info(ops[i].uid, client_id);
+        }
+
+        if (status == PSA_SUCCESS) {
+            /* If the object exists and has the write once flag set, then it
+             * cannot be modified or deleted.
+             */
+            if (g_file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+                return PSA_ERROR_NOT_PERMITTED;
+            }
+        } else if ((status != PSA_ERROR_DOES_NOT_EXIST) ||
+                   (ops[i].type == TFM_ITS_TRANSACTION_OP_REMOVE)) {
+            return status;
+        }
+
+        if (ops[i].type == TFM_ITS_TRANSACTION_OP_REMOVE) {
+            status = its_flash_fs_txn_stage_delete(&g_txn, g_fid);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+            continue;
+        }
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        data = vec_data;
+        vec_data += ops[i].data_length;
+#else
+        /* All the data must be held until the transaction is committed. Each
+         * set operation starts at an offset aligned with the max flash program
+         * unit to meet the alignment requirement of the filesystem.
+         */
+        if (ops[i].data_length > sizeof(asset_data) - offset) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Read asset data from the caller */
+        (void)its_req_mngr_read(asset_data + offset, ops[i].data_length);
+        data = asset_data + offset;
+        offset = ITS_UTILS_MIN(ITS_UTILS_ALIGN(offset + ops[i].data_length,
+                                               ITS_FLASH_MAX_ALIGNMENT),
+                               sizeof(asset_data));
+#endif
+
+        g_file_info.flags = (uint32_t)ops[i].create_flags;
+
+#ifdef ITS_ENCRYPTION
+        enc_size = ITS_ENC_STORED_SIZE(ops[i].data_length);
+        if (enc_size > sizeof(enc_asset_data) - enc_offset) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        status = tfm_its_crypt_file(&g_file_info,
+                                    g_fid,
+                                    sizeof(g_fid),
+                                    data,
+                                    ops[i].data_length,
+                                    enc_asset_data + enc_offset,
+                                    sizeof(enc_asset_data) - enc_offset,
+                                    true);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+        data = enc_asset_data + enc_offset;
+        enc_offset = ITS_UTILS_MIN(ITS_UTILS_ALIGN(enc_offset + enc_size,
+                                                   ITS_FLASH_MAX_ALIGNMENT),
+                                   sizeof(enc_asset_data));
+
+        status = its_flash_fs_txn_stage_write(&g_txn, g_fid, &g_file_info,
+                                              enc_size, data);
+#else
+        status = its_flash_fs_txn_stage_write(&g_txn, g_fid, &g_file_info,
+                                              ops[i].data_length, data);
+#endif
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return its_flash_fs_txn_commit(get_fs_ctx(client_id), &g_txn);
+}
+#endif /* ITS_TRANSACTION && TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
@@ -17,6 +17,7 @@
 
 #include "flash_fs/its_flash_fs.h"
 #include "its_utils.h"
+#include "tfm_its_defs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -163,6 +164,48 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
  */
 psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid);
 
+#if ITS_TRANSACTION
+/**
+ * \brief Set and remove several uid/value pairs in one filesystem update
+ *
+ * Either all the operations take effect or none does. The data of the set
+ * operations is read from the caller in the order of the operations.
+ *
+ * \param[in] client_id    Identifier of the assets' owner (client)
+ * \param[in] ops          Array of operations
+ * \param[in] num_ops      Number of operations in `ops`
+ * \param[in] data_length  The size in bytes of the data of the set operations
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_NOT_PERMITTED         The operation failed because one of
+ *                                         the uids was created with
+ *                                         PSA_STORAGE_FLAG_WRITE_ONCE
+ * \retval PSA_ERROR_DOES_NOT_EXIST        The operation failed because a uid
+ *                                         to remove was not found in the
+ *                                         storage
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because one of
+ *                                         the flags is not supported, or the
+ *                                         assets to replace are spread over
+ *                                         too many data blocks
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because there
+ *                                         was insufficient space on the
+ *                                         storage medium
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because one of
+ *                                         the operations is invalid, or the
+ *                                         data does not fit in the internal
+ *                                         buffers
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ */
+psa_status_t tfm_its_transaction(int32_t client_id,
+                                 const struct tfm_its_transaction_op_t *ops,
+                                 size_t num_ops,
+                                 size_t data_length);
+#endif /* ITS_TRANSACTION */
+
 #ifdef __cplusplus
 }
 #endif
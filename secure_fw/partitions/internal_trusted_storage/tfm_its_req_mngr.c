@@ -25,6 +25,10 @@ static uint8_t *p_data;
 static psa_handle_t handle;
 #endif
 
+#if ITS_TRANSACTION
+static struct tfm_its_transaction_op_t txn_ops[ITS_TRANSACTION_MAX_OPS];
+#endif
+
 static psa_status_t tfm_its_set_req(const psa_msg_t *msg)
 {
     psa_storage_uid_t uid;
@@ -147,6 +151,42 @@ static psa_status_t tfm_its_remove_req(const psa_msg_t *msg)
     return tfm_its_remove(msg->client_id, uid);
 }
 
+#if ITS_TRANSACTION
+static psa_status_t tfm_its_transaction_req(const psa_msg_t *msg)
+{
+    size_t num_ops;
+    size_t num;
+    size_t data_length;
+
+    if ((msg->in_size[0] % sizeof(txn_ops[0])) != 0) {
+        /* The size of the operations array is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num_ops = msg->in_size[0] / sizeof(txn_ops[0]);
+    if ((num_ops == 0) || (num_ops > ITS_TRANSACTION_MAX_OPS)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    num = psa_read(msg->handle, 0, txn_ops, msg->in_size[0]);
+    if (num != msg->in_size[0]) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    data_length = msg->in_size[1];
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    if (data_length) {
+        p_data = (uint8_t *)psa_map_invec(msg->handle, 1);
+    } else {
+        p_data = NULL;
+    }
+#else
+    handle = msg->handle;
+#endif
+    return tfm_its_transaction(msg->client_id, txn_ops, num_ops, data_length);
+}
+#endif /* ITS_TRANSACTION */
+
 psa_status_t tfm_its_entry(void)
 {
     return tfm_its_init();
@@ -163,6 +203,10 @@ psa_status_t tfm_internal_trusted_storage_service_sfn(const psa_msg_t *msg)
         return tfm_its_get_info_req(msg);
     case TFM_ITS_REMOVE:
         return tfm_its_remove_req(msg);
+#if ITS_TRANSACTION
+    case TFM_ITS_TRANSACTION:
+        return tfm_its_transaction_req(msg);
+#endif
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
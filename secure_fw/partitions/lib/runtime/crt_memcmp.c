@@ -1,26 +1,50 @@
 /*
- * Copyright (c) 2019-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
-#include <stddef.h>
-#include <stdint.h>
+#include "crt_impl_private.h"
 
+/*
+ * Note: memcmp() returns at the first difference. Use a constant-time
+ * comparison for secret data.
+ */
 int memcmp(const void *s1, const void *s2, size_t n)
 {
-    int result = 0;
-    const uint8_t *p1 = (const uint8_t *)s1;
-    const uint8_t *p2 = (const uint8_t *)s2;
+    union composite_addr_t p1, p2;
+
+    p1.uint_addr = (uintptr_t)s1;
+    p2.uint_addr = (uintptr_t)s2;
+
+    /* Words can only be compared if both addresses have the same alignment. */
+    if (ADDR_WORD_UNALIGNED(p1.uint_addr) ==
+        ADDR_WORD_UNALIGNED(p2.uint_addr)) {
+        while (n && ADDR_WORD_UNALIGNED(p1.uint_addr)) {
+            if (*p1.p_byte != *p2.p_byte) {
+                return *p1.p_byte - *p2.p_byte;
+            }
+            p1.p_byte++;
+            p2.p_byte++;
+            n--;
+        }
+
+        /* Locate the different byte in the word below if words differ. */
+        while ((n >= sizeof(uint32_t)) && (*p1.p_word == *p2.p_word)) {
+            p1.p_word++;
+            p2.p_word++;
+            n -= sizeof(uint32_t);
+        }
+    }
 
     while (n--) {
-        if ((*p1 != *p2) && (result == 0)) {
-            result = *p1 - *p2;
-        } else {
-            p1++;
-            p2++;
+        if (*p1.p_byte != *p2.p_byte) {
+            return *p1.p_byte - *p2.p_byte;
         }
+        p1.p_byte++;
+        p2.p_byte++;
     }
-    return result;
+
+    return 0;
 }
@@ -48,6 +48,8 @@ void ns_agent_mailbox_entry(void)
 #if CONFIG_TFM_SPM_BACKEND_IPC == 1
         } else if (signals & ASYNC_MSG_REPLY) {
             tfm_rpc_client_call_reply();
+            /* The connection of the replied call can be used again now */
+            tfm_rpc_client_call_resume();
 #endif
         } else {
             psa_panic();
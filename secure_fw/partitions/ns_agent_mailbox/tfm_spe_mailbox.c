@@ -15,8 +15,11 @@
 
 #include "async.h"
 #include "config_impl.h"
+#include "current.h"
+#include "fih.h"
 #include "internal_status_code.h"
 #include "psa/error.h"
+#include "psa/service.h"
 #include "utilities.h"
 #include "private/assert.h"
 #include "tfm_arch.h"
@@ -24,6 +27,7 @@
 #include "tfm_psa_call_pack.h"
 #include "tfm_spe_mailbox.h"
 #include "tfm_rpc.h"
+#include "tfm_hal_isolation.h"
 #include "tfm_hal_multi_core.h"
 #include "tfm_multi_core.h"
 #include "ffm/mailbox_agent_api.h"
@@ -39,6 +43,10 @@
 #define MAILBOX_INVALIDATE_CACHE(addr, size) SCB_InvalidateDCache_by_Addr((addr), (size))
 #endif
 
+#if (NUM_MAILBOX_SPE_QUEUE_SLOT < 1) || (NUM_MAILBOX_SPE_QUEUE_SLOT > 255)
+#error "Error: Invalid NUM_MAILBOX_SPE_QUEUE_SLOT. The value should be >= 1 and <= 255"
+#endif
+
 static struct secure_mailbox_queue_t spe_mailbox_queue;
 
 /*
@@ -52,31 +60,44 @@ struct vectors {
     size_t out_len;
     bool in_use;
 };
-static struct vectors vectors[NUM_MAILBOX_QUEUE_SLOT] = {0};
+static struct vectors vectors[NUM_MAILBOX_SPE_QUEUE_SLOT] = {0};
+
+/* Number of replies written to NSPE but not notified yet */
+static uint32_t nr_unnotified_replies;
+
+/* Whether NSPE messages are left pending because no SPE slot was free */
+static bool is_backlogged;
 
+/* Number of batches waiting to pass their next call into SPM */
+static uint32_t nr_pending_batches;
 
-__STATIC_INLINE void set_spe_queue_empty_status(uint8_t idx)
+
+/*
+ * Takes an SPE mailbox queue slot from the free list.
+ * Returns NUM_MAILBOX_SPE_QUEUE_SLOT if no slot is free.
+ */
+__STATIC_INLINE uint8_t acquire_spe_queue_slot(void)
 {
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        spe_mailbox_queue.empty_slots |= (1 << idx);
+    if (!spe_mailbox_queue.nr_free_slots) {
+        return NUM_MAILBOX_SPE_QUEUE_SLOT;
     }
+
+    spe_mailbox_queue.nr_free_slots--;
+
+    return spe_mailbox_queue.free_slots[spe_mailbox_queue.nr_free_slots];
 }
 
-__STATIC_INLINE void clear_spe_queue_empty_status(uint8_t idx)
+__STATIC_INLINE void release_spe_queue_slot(uint8_t idx)
 {
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        spe_mailbox_queue.empty_slots &= ~(1 << idx);
-    }
+    spe_mailbox_queue.free_slots[spe_mailbox_queue.nr_free_slots] = idx;
+    spe_mailbox_queue.nr_free_slots++;
 }
 
-__STATIC_INLINE bool get_spe_queue_empty_status(uint8_t idx)
+/* A slot in use always holds a valid message handle */
+__STATIC_INLINE bool is_spe_queue_slot_in_use(uint8_t idx)
 {
-    if ((idx < NUM_MAILBOX_QUEUE_SLOT) &&
-        (spe_mailbox_queue.empty_slots & (1 << idx))) {
-        return true;
-    }
-
-    return false;
+    return (idx < NUM_MAILBOX_SPE_QUEUE_SLOT) &&
+           (spe_mailbox_queue.queue[idx].msg_handle != MAILBOX_MSG_NULL_HANDLE);
 }
 
 __STATIC_INLINE mailbox_queue_status_t get_nspe_queue_pend_status(
@@ -104,10 +125,61 @@ __STATIC_INLINE void clear_nspe_queue_pend_status(
     MAILBOX_CLEAN_CACHE(ns_status, sizeof(*ns_status));
 }
 
+#ifdef MAILBOX_RING_TRANSPORT
+/* SPE is the only consumer of the request ring */
+__STATIC_INLINE bool pop_nspe_req_ring(uint8_t *ns_slot_idx)
+{
+    struct mailbox_ring_t *ring = &spe_mailbox_queue.ns_rings->req;
+    uint32_t tail = spe_mailbox_queue.req_tail;
+    uint8_t *entry = &ring->entries[MAILBOX_RING_ENTRY(tail)];
+    uint32_t head;
+
+    MAILBOX_INVALIDATE_CACHE(&ring->head, sizeof(ring->head));
+    head = ring->head.val;
+
+    /* The head index is written by NSPE. Ignore any invalid value. */
+    if ((head >= (2 * MAILBOX_RING_SIZE)) || (head == tail) ||
+        (MAILBOX_RING_COUNT(head, tail) > MAILBOX_RING_SIZE)) {
+        return false;
+    }
+
+    /* Don't read the entry before the head index which covers it */
+    __DMB();
+    MAILBOX_INVALIDATE_CACHE(entry, sizeof(*entry));
+    *ns_slot_idx = *entry;
+
+    spe_mailbox_queue.req_tail = MAILBOX_RING_NEXT(tail);
+    ring->tail.val = spe_mailbox_queue.req_tail;
+    MAILBOX_CLEAN_CACHE(&ring->tail, sizeof(ring->tail));
+
+    return true;
+}
+
+/*
+ * SPE is the only producer of the reply ring. Each NSPE slot is pushed once
+ * per message, so the ring never overflows.
+ */
+__STATIC_INLINE void push_nspe_reply_ring(uint8_t ns_slot_idx)
+{
+    struct mailbox_ring_t *ring = &spe_mailbox_queue.ns_rings->reply;
+    uint32_t head = spe_mailbox_queue.reply_head;
+    uint8_t *entry = &ring->entries[MAILBOX_RING_ENTRY(head)];
+
+    /* The entry must reach NSPE before the head index moves past it */
+    *entry = ns_slot_idx;
+    MAILBOX_CLEAN_CACHE(entry, sizeof(*entry));
+    __DMB();
+
+    spe_mailbox_queue.reply_head = MAILBOX_RING_NEXT(head);
+    ring->head.val = spe_mailbox_queue.reply_head;
+    MAILBOX_CLEAN_CACHE(&ring->head, sizeof(ring->head));
+}
+#endif /* MAILBOX_RING_TRANSPORT */
+
 __STATIC_INLINE int32_t get_spe_mailbox_msg_handle(uint8_t idx,
                                                    mailbox_msg_handle_t *handle)
 {
-    if ((idx >= NUM_MAILBOX_QUEUE_SLOT) || !handle) {
+    if ((idx >= NUM_MAILBOX_SPE_QUEUE_SLOT) || !handle) {
         return MAILBOX_INVAL_PARAMS;
     }
 
@@ -119,7 +191,8 @@ __STATIC_INLINE int32_t get_spe_mailbox_msg_handle(uint8_t idx,
 __STATIC_INLINE int32_t get_spe_mailbox_msg_idx(mailbox_msg_handle_t handle,
                                                 uint8_t *idx)
 {
-    if ((handle == MAILBOX_MSG_NULL_HANDLE) || !idx) {
+    if ((handle <= MAILBOX_MSG_NULL_HANDLE) ||
+        (handle > NUM_MAILBOX_SPE_QUEUE_SLOT) || !idx) {
         return MAILBOX_INVAL_PARAMS;
     }
 
@@ -130,20 +203,25 @@ __STATIC_INLINE int32_t get_spe_mailbox_msg_idx(mailbox_msg_handle_t handle,
 
 static void mailbox_clean_queue_slot(uint8_t idx)
 {
-    if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
+    if (!is_spe_queue_slot_in_use(idx)) {
         return;
     }
 
+#ifdef MAILBOX_RING_TRANSPORT
+    spe_mailbox_queue.ns_slots_in_flight &=
+                        ~(1UL << spe_mailbox_queue.queue[idx].ns_slot_idx);
+#endif
+
     spm_memset(&spe_mailbox_queue.queue[idx], 0,
                          sizeof(spe_mailbox_queue.queue[idx]));
-    set_spe_queue_empty_status(idx);
+    release_spe_queue_slot(idx);
 }
 
 __STATIC_INLINE struct mailbox_reply_t *get_nspe_reply_addr(uint8_t idx)
 {
     uint8_t ns_slot_idx;
 
-    if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
+    if (idx >= NUM_MAILBOX_SPE_QUEUE_SLOT) {
         psa_panic();
     }
 
@@ -155,18 +233,24 @@ __STATIC_INLINE struct mailbox_reply_t *get_nspe_reply_addr(uint8_t idx)
     return &spe_mailbox_queue.ns_slots[ns_slot_idx].reply;
 }
 
-static void mailbox_direct_reply(uint8_t idx, uint32_t result)
+/* Copies the outvec lengths of the completed psa_call() back to NSPE */
+static void mailbox_copy_out_vec_len(uint8_t idx)
 {
-    struct mailbox_reply_t *reply_ptr;
-    uint32_t ret_result = result;
-
-    /* Copy outvec lengths back if necessary */
     if (vectors[idx].in_use) {
         for (int i = 0; i < vectors[idx].out_len; i++) {
             vectors[idx].original_out_vec[i].len = vectors[idx].out_vec[i].len;
         }
         vectors[idx].in_use = false;
     }
+}
+
+static void mailbox_direct_reply(uint8_t idx, uint32_t result)
+{
+    struct mailbox_reply_t *reply_ptr;
+    uint32_t ret_result = result;
+
+    /* Copy outvec lengths back if necessary */
+    mailbox_copy_out_vec_len(idx);
 
     /* Get reply address */
     reply_ptr = get_nspe_reply_addr(idx);
@@ -174,14 +258,57 @@ static void mailbox_direct_reply(uint8_t idx, uint32_t result)
                sizeof(reply_ptr->return_val));
     MAILBOX_CLEAN_CACHE(reply_ptr, sizeof(*reply_ptr));
 
+#ifdef MAILBOX_RING_TRANSPORT
+    /* The reply ring is updated without any critical section between cores */
+    push_nspe_reply_ring(spe_mailbox_queue.queue[idx].ns_slot_idx);
+#endif
+
     mailbox_clean_queue_slot(idx);
 
+    nr_unnotified_replies++;
+
     /*
      * Skip NSPE queue status update after single reply.
      * Update NSPE queue status after all the mailbox messages are completed
      */
 }
 
+/*
+ * Returns true if the PSA client call results of other mailbox messages are
+ * ready to be replied right away.
+ */
+__STATIC_INLINE bool mailbox_replies_pending(void)
+{
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    return (psa_wait(ASYNC_MSG_REPLY, PSA_POLL) & ASYNC_MSG_REPLY) != 0;
+#else
+    /* All the PSA client calls are completed synchronously */
+    return false;
+#endif
+}
+
+/*
+ * Notifies NSPE of the replies written so far.
+ * As long as other results are ready to be replied and fewer than
+ * MAILBOX_REPLY_COALESCE_THRESHOLD replies are waiting, the notification is
+ * deferred so that a burst of replies is signalled only once.
+ */
+static void mailbox_notify_replies(void)
+{
+    if (!nr_unnotified_replies) {
+        return;
+    }
+
+    if ((nr_unnotified_replies < MAILBOX_REPLY_COALESCE_THRESHOLD) &&
+        mailbox_replies_pending()) {
+        return;
+    }
+
+    nr_unnotified_replies = 0;
+
+    tfm_mailbox_hal_notify_peer();
+}
+
 __STATIC_INLINE int32_t check_mailbox_msg(const struct mailbox_msg_t *msg)
 {
     /*
@@ -192,8 +319,134 @@ __STATIC_INLINE int32_t check_mailbox_msg(const struct mailbox_msg_t *msg)
     return MAILBOX_SUCCESS;
 }
 
+/*
+ * Passes a psa_call() into SPM, with the invecs and outvecs copied into the
+ * vectors of SPE slot idx.
+ * Returns true if the result in psa_ret is to be replied immediately, or false
+ * if it is replied later via tfm_mailbox_reply_msg().
+ */
+static bool mailbox_psa_call(uint8_t idx, int32_t client_id,
+                             psa_handle_t handle, int32_t type,
+                             const psa_invec *in_vec, size_t in_len,
+                             psa_outvec *out_vec, size_t out_len,
+                             psa_status_t *psa_ret)
+{
+    struct client_params_t client_params = {0};
+    uint32_t control = PARAM_PACK(type, in_len, out_len);
+
+    /* TODO check vector validity before use */
+    /* Make local copy of invecs and outvecs */
+    vectors[idx].in_use = true;
+    vectors[idx].out_len = out_len;
+    vectors[idx].original_out_vec = out_vec;
+    for (int i = 0; i < PSA_MAX_IOVEC; i++) {
+        if (i < in_len) {
+            vectors[idx].in_vec[i] = in_vec[i];
+        } else {
+            vectors[idx].in_vec[i].base = 0;
+            vectors[idx].in_vec[i].len = 0;
+        }
+    }
+
+    control = PARAM_SET_NS_INVEC(control);
+
+    for (int i = 0; i < PSA_MAX_IOVEC; i++) {
+        if (i < out_len) {
+            vectors[idx].out_vec[i] = out_vec[i];
+        } else {
+            vectors[idx].out_vec[i].base = 0;
+            vectors[idx].out_vec[i].len = 0;
+        }
+    }
+
+    control = PARAM_SET_NS_OUTVEC(control);
+
+    client_params.ns_client_id_stateless = client_id;
+    client_params.p_invecs = vectors[idx].in_vec;
+    client_params.p_outvecs = vectors[idx].out_vec;
+    *psa_ret = tfm_rpc_psa_call(handle, control, &client_params,
+                                &spe_mailbox_queue.queue[idx].msg_handle);
+
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    /* The result is replied asynchronously unless an error happens */
+    return *psa_ret != PSA_SUCCESS;
+#else
+    return true;
+#endif
+}
+
+/* Records the result of the call in progress in the batch of SPE slot idx */
+static void mailbox_batch_complete_call(uint8_t idx, psa_status_t status)
+{
+    struct secure_mailbox_slot_t *slot = &spe_mailbox_queue.queue[idx];
+    struct mailbox_batch_call_t *call =
+                    &slot->msg.params.psa_call_batch_params.calls[slot->batch_idx];
+
+    mailbox_copy_out_vec_len(idx);
+
+    call->status = status;
+    MAILBOX_CLEAN_CACHE(call, sizeof(*call));
+
+    slot->batch_idx++;
+}
+
+/*
+ * Checks that NSPE can read and write the whole array of calls in a batch.
+ * SPE mailbox reads the calls and writes their results back on behalf of NSPE.
+ */
+static bool mailbox_batch_is_accessible(
+                            const struct psa_client_params_t *params)
+{
+    const struct partition_t *curr_partition = GET_CURRENT_COMPONENT();
+    fih_int fih_rc = FIH_FAILURE;
+
+    /* nr_calls is limited to MAILBOX_MAX_BATCH_CALLS. It cannot overflow. */
+    FIH_CALL(tfm_hal_memory_check, fih_rc,
+             curr_partition->boundary,
+             (uintptr_t)params->psa_call_batch_params.calls,
+             params->psa_call_batch_params.nr_calls *
+             sizeof(struct mailbox_batch_call_t),
+             TFM_HAL_ACCESS_READWRITE | TFM_HAL_ACCESS_NS);
+
+    return fih_eq(fih_rc, fih_int_encode(PSA_SUCCESS));
+}
+
+/*
+ * Passes the remaining calls in the batch of SPE slot idx into SPM one after
+ * another.
+ * Returns true once all the calls are completed, or false if a call is
+ * completed later via tfm_mailbox_reply_msg().
+ */
+static bool mailbox_batch_dispatch(uint8_t idx)
+{
+    struct secure_mailbox_slot_t *slot = &spe_mailbox_queue.queue[idx];
+    const struct psa_client_params_t *params = &slot->msg.params;
+    struct mailbox_batch_call_t call;
+    psa_status_t psa_ret;
+
+    while (slot->batch_idx < params->psa_call_batch_params.nr_calls) {
+        /* Take a local copy as NSPE can modify the call in the meantime */
+        MAILBOX_INVALIDATE_CACHE(
+                        &params->psa_call_batch_params.calls[slot->batch_idx],
+                        sizeof(call));
+        spm_memcpy(&call,
+                   &params->psa_call_batch_params.calls[slot->batch_idx],
+                   sizeof(call));
+
+        if (!mailbox_psa_call(idx, slot->client_id, call.handle, call.type,
+                              call.in_vec, call.in_len,
+                              call.out_vec, call.out_len, &psa_ret)) {
+            return false;
+        }
+
+        mailbox_batch_complete_call(idx, psa_ret);
+    }
+
+    return true;
+}
+
 /* Passes the request from the mailbox message into SPM.
- * idx indicates the slot used to use for any immediate reply.
+ * idx indicates the SPE slot used to use for any immediate reply.
  * If it queues the reply immediately, updates reply_slots accordingly.
  */
 static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
@@ -201,14 +454,8 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
                                     mailbox_queue_status_t *reply_slots)
 {
     const struct psa_client_params_t *params = &msg_ptr->params;
-    struct client_params_t client_params = {0};
-    uint32_t control = PARAM_PACK(params->psa_call_params.type,
-                                  params->psa_call_params.in_len,
-                                  params->psa_call_params.out_len);
     int32_t client_id;
     psa_status_t psa_ret = PSA_ERROR_GENERIC_ERROR;
-    mailbox_msg_handle_t *mb_msg_handle =
-        &spe_mailbox_queue.queue[idx].msg_handle;
 
 #if CONFIG_TFM_SPM_BACKEND_IPC == 1
     /* Assume asynchronous. Set to synchronous when an error happens. */
@@ -232,48 +479,51 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
         break;
 
     case MAILBOX_PSA_CALL:
-        /* TODO check vector validity before use */
-        /* Make local copy of invecs and outvecs */
-        vectors[idx].in_use = true;
-        vectors[idx].out_len = params->psa_call_params.out_len;
-        vectors[idx].original_out_vec = params->psa_call_params.out_vec;
-        for (int i = 0; i < PSA_MAX_IOVEC; i++) {
-            if (i < params->psa_call_params.in_len) {
-                vectors[idx].in_vec[i] = params->psa_call_params.in_vec[i];
-            } else {
-                vectors[idx].in_vec[i].base = 0;
-                vectors[idx].in_vec[i].len = 0;
-            }
+        if (tfm_multi_core_hal_client_id_translate(CLIENT_ID_OWNER_MAGIC,
+                                                   msg_ptr->client_id,
+                                                   &client_id) != SPM_SUCCESS) {
+            sync = true;
+            psa_ret = PSA_ERROR_INVALID_ARGUMENT;
+            break;
         }
+        sync = mailbox_psa_call(idx, client_id,
+                                params->psa_call_params.handle,
+                                params->psa_call_params.type,
+                                params->psa_call_params.in_vec,
+                                params->psa_call_params.in_len,
+                                params->psa_call_params.out_vec,
+                                params->psa_call_params.out_len,
+                                &psa_ret);
+        break;
 
-        control = PARAM_SET_NS_INVEC(control);
+    case MAILBOX_PSA_CALL_BATCH:
+        /*
+         * The results of the calls are written into the batch. The message
+         * itself is replied once the last call is completed.
+         */
+        sync = true;
+        psa_ret = PSA_ERROR_INVALID_ARGUMENT;
 
-        for (int i = 0; i < PSA_MAX_IOVEC; i++) {
-            if (i < params->psa_call_params.out_len) {
-                vectors[idx].out_vec[i] = params->psa_call_params.out_vec[i];
-            } else {
-                vectors[idx].out_vec[i].base = 0;
-                vectors[idx].out_vec[i].len = 0;
-            }
+        if (!params->psa_call_batch_params.calls ||
+            (params->psa_call_batch_params.nr_calls == 0) ||
+            (params->psa_call_batch_params.nr_calls > MAILBOX_MAX_BATCH_CALLS)) {
+            break;
         }
 
-        control = PARAM_SET_NS_OUTVEC(control);
+        if (!mailbox_batch_is_accessible(params)) {
+            break;
+        }
 
         if (tfm_multi_core_hal_client_id_translate(CLIENT_ID_OWNER_MAGIC,
                                                    msg_ptr->client_id,
                                                    &client_id) != SPM_SUCCESS) {
-            sync = true;
-            psa_ret = PSA_ERROR_INVALID_ARGUMENT;
             break;
         }
-        client_params.ns_client_id_stateless = client_id;
-        client_params.p_invecs = vectors[idx].in_vec;
-        client_params.p_outvecs = vectors[idx].out_vec;
-        psa_ret = tfm_rpc_psa_call(params->psa_call_params.handle,
-                                   control, &client_params, mb_msg_handle);
-        if (psa_ret != PSA_SUCCESS) {
-            sync = true;
-        }
+        spe_mailbox_queue.queue[idx].client_id = client_id;
+        spe_mailbox_queue.queue[idx].batch_idx = 0;
+
+        sync = mailbox_batch_dispatch(idx);
+        psa_ret = PSA_SUCCESS;
         break;
 
 /* Following cases are only needed by connection-based services */
@@ -289,7 +539,7 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
         psa_ret = tfm_rpc_psa_connect(params->psa_connect_params.sid,
                                       params->psa_connect_params.version,
                                       client_id,
-                                      mb_msg_handle);
+                                      &spe_mailbox_queue.queue[idx].msg_handle);
         if (psa_ret != PSA_SUCCESS) {
             sync = true;
         }
@@ -316,19 +566,94 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
 
     /* Any synchronous result should be returned immediately */
     if (sync) {
-        *reply_slots |= (1 << idx);
+        *reply_slots |= (1 << spe_mailbox_queue.queue[idx].ns_slot_idx);
         mailbox_direct_reply(idx, (uint32_t)psa_ret);
     }
 
     return MAILBOX_SUCCESS;
 }
 
+/*
+ * Fetches the mailbox message in NSPE slot ns_slot_idx into the free SPE slot
+ * idx and passes it into SPM.
+ */
+static void mailbox_handle_slot(uint8_t idx, uint8_t ns_slot_idx,
+                                mailbox_queue_status_t *reply_slots)
+{
+    struct mailbox_msg_t *msg_ptr;
+
+    get_spe_mailbox_msg_handle(idx,
+                               &spe_mailbox_queue.queue[idx].msg_handle);
+    spe_mailbox_queue.queue[idx].ns_slot_idx = ns_slot_idx;
+
+    msg_ptr = &spe_mailbox_queue.queue[idx].msg;
+    MAILBOX_INVALIDATE_CACHE(&spe_mailbox_queue.ns_slots[ns_slot_idx].msg,
+                             sizeof(*msg_ptr));
+    spm_memcpy(msg_ptr, &spe_mailbox_queue.ns_slots[ns_slot_idx].msg,
+               sizeof(*msg_ptr));
+
+    if (check_mailbox_msg(msg_ptr) != MAILBOX_SUCCESS) {
+        mailbox_clean_queue_slot(idx);
+        return;
+    }
+
+    if (tfm_mailbox_dispatch(msg_ptr, idx, reply_slots) != MAILBOX_SUCCESS) {
+        mailbox_clean_queue_slot(idx);
+    }
+}
+
+#ifdef MAILBOX_RING_TRANSPORT
 int32_t tfm_mailbox_handle_msg(void)
 {
-    uint8_t idx;
+    uint8_t idx, ns_slot_idx;
+    mailbox_queue_status_t reply_slots = 0;
+    bool is_handled = false;
+
+    SPM_ASSERT(spe_mailbox_queue.ns_rings != NULL);
+
+    /*
+     * Leave the requests in the ring while no SPE slot is free. They are
+     * handled as soon as a reply releases a slot.
+     */
+    while (spe_mailbox_queue.nr_free_slots) {
+        /* Check if NSPE mailbox did assert a PSA client call request */
+        if (!pop_nspe_req_ring(&ns_slot_idx)) {
+            break;
+        }
+
+        is_handled = true;
+
+        /*
+         * Skip a slot index out of range, or one whose message is still in
+         * progress. NSPE can reuse a slot only after it is replied.
+         */
+        if ((ns_slot_idx >= spe_mailbox_queue.ns_slot_count) ||
+            (spe_mailbox_queue.ns_slots_in_flight & (1UL << ns_slot_idx))) {
+            continue;
+        }
+
+        spe_mailbox_queue.ns_slots_in_flight |= (1UL << ns_slot_idx);
+        idx = acquire_spe_queue_slot();
+        mailbox_handle_slot(idx, ns_slot_idx, &reply_slots);
+    }
+
+    is_backlogged = !spe_mailbox_queue.nr_free_slots;
+
+    mailbox_notify_replies();
+
+    if (!is_handled) {
+        return MAILBOX_NO_PEND_EVENT;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+#else /* MAILBOX_RING_TRANSPORT */
+int32_t tfm_mailbox_handle_msg(void)
+{
+    uint8_t idx, ns_slot_idx;
     mailbox_queue_status_t mask_bits, pend_slots, reply_slots = 0;
+    mailbox_queue_status_t handled_slots = 0;
     struct mailbox_status_t *ns_status = spe_mailbox_queue.ns_status;
-    struct mailbox_msg_t *msg_ptr;
 
     SPM_ASSERT(ns_status != NULL);
 
@@ -343,95 +668,111 @@ int32_t tfm_mailbox_handle_msg(void)
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    for (idx = 0; idx < spe_mailbox_queue.ns_slot_count; idx++) {
-        mask_bits = (1 << idx);
+    is_backlogged = false;
+
+    for (ns_slot_idx = 0; ns_slot_idx < spe_mailbox_queue.ns_slot_count;
+         ns_slot_idx++) {
+        mask_bits = (1 << ns_slot_idx);
         /* Check if current NSPE mailbox queue slot is pending for handling */
         if (!(pend_slots & mask_bits)) {
             continue;
         }
 
         /*
-         * TODO
-         * The operations are simplified here. Use the SPE mailbox queue
-         * slot with the same idx as that of the NSPE mailbox queue slot.
-         * A more general implementation should dynamically search and
-         * select an empty SPE mailbox queue slot.
+         * Leave the slot pending while no SPE slot is free. It is handled as
+         * soon as a reply releases a slot.
          */
-        clear_spe_queue_empty_status(idx);
-        spe_mailbox_queue.queue[idx].ns_slot_idx = idx;
-
-        msg_ptr = &spe_mailbox_queue.queue[idx].msg;
-        MAILBOX_INVALIDATE_CACHE(&spe_mailbox_queue.ns_slots[idx].msg, sizeof(*msg_ptr));
-        spm_memcpy(msg_ptr, &spe_mailbox_queue.ns_slots[idx].msg, sizeof(*msg_ptr));
-
-        if (check_mailbox_msg(msg_ptr) != MAILBOX_SUCCESS) {
-            mailbox_clean_queue_slot(idx);
-            continue;
+        idx = acquire_spe_queue_slot();
+        if (idx == NUM_MAILBOX_SPE_QUEUE_SLOT) {
+            is_backlogged = true;
+            break;
         }
 
-        get_spe_mailbox_msg_handle(idx,
-                                   &spe_mailbox_queue.queue[idx].msg_handle);
-
-        if (tfm_mailbox_dispatch(msg_ptr, idx, &reply_slots) != MAILBOX_SUCCESS) {
-            mailbox_clean_queue_slot(idx);
-            continue;
-        }
+        handled_slots |= mask_bits;
+        mailbox_handle_slot(idx, ns_slot_idx, &reply_slots);
     }
 
     tfm_mailbox_hal_enter_critical();
 
     /* Clean the NSPE mailbox pending status. */
-    clear_nspe_queue_pend_status(ns_status, pend_slots);
+    clear_nspe_queue_pend_status(ns_status, handled_slots);
 
     /* Set the NSPE mailbox replied status */
     set_nspe_queue_replied_status(ns_status, reply_slots);
 
     tfm_mailbox_hal_exit_critical();
 
-    if (reply_slots) {
-        tfm_mailbox_hal_notify_peer();
-    }
+    mailbox_notify_replies();
 
     return MAILBOX_SUCCESS;
 }
+#endif /* MAILBOX_RING_TRANSPORT */
 
-int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
+/* Replies to the mailbox message in SPE slot idx and releases the slot */
+static void mailbox_reply_slot(uint8_t idx, int32_t reply)
 {
-    uint8_t idx;
-    int32_t ret;
+#ifndef MAILBOX_RING_TRANSPORT
+    uint8_t ns_slot_idx = spe_mailbox_queue.queue[idx].ns_slot_idx;
     struct mailbox_status_t *ns_status = spe_mailbox_queue.ns_status;
 
     SPM_ASSERT(ns_status != NULL);
+#endif
+
+    mailbox_direct_reply(idx, (uint32_t)reply);
+
+#ifndef MAILBOX_RING_TRANSPORT
+    tfm_mailbox_hal_enter_critical();
+
+    /* Set the NSPE mailbox replied status */
+    set_nspe_queue_replied_status(ns_status, (1 << ns_slot_idx));
+
+    tfm_mailbox_hal_exit_critical();
+#endif
+}
+
+int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
+{
+    uint8_t idx;
+    int32_t ret;
 
     /*
-     * If handle == MAILBOX_MSG_NULL_HANDLE, reply to the mailbox message
-     * in the first slot.
-     * When multiple ongoing PSA client calls from NSPE are supported,
-     * additional check might be necessary to avoid spoofing the first slot.
+     * A NULL handle doesn't identify any mailbox message. It is rejected
+     * rather than replied to an arbitrary slot.
      */
-    if (handle == MAILBOX_MSG_NULL_HANDLE) {
-        idx = 0;
-    } else {
-        ret = get_spe_mailbox_msg_idx(handle, &idx);
-        if (ret != MAILBOX_SUCCESS) {
-            return ret;
-        }
+    ret = get_spe_mailbox_msg_idx(handle, &idx);
+    if (ret != MAILBOX_SUCCESS) {
+        /* Don't hold back the replies deferred for this one */
+        mailbox_notify_replies();
+        return ret;
     }
 
-    if (get_spe_queue_empty_status(idx)) {
+    if (!is_spe_queue_slot_in_use(idx)) {
+        mailbox_notify_replies();
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    mailbox_direct_reply(idx, (uint32_t)reply);
-
-    tfm_mailbox_hal_enter_critical();
+    /*
+     * A call in a batch is completed. The next one may use the same
+     * connection, which is released only after this reply returns. Pass it
+     * into SPM from mailbox_resume() instead.
+     */
+    if (spe_mailbox_queue.queue[idx].msg.call_type == MAILBOX_PSA_CALL_BATCH) {
+        mailbox_batch_complete_call(idx, (psa_status_t)reply);
+
+        if (spe_mailbox_queue.queue[idx].batch_idx <
+            spe_mailbox_queue.queue[idx].msg.params.psa_call_batch_params.nr_calls) {
+            spe_mailbox_queue.queue[idx].is_batch_pending = true;
+            nr_pending_batches++;
+            mailbox_notify_replies();
+            return MAILBOX_SUCCESS;
+        }
 
-    /* Set the NSPE mailbox replied status */
-    set_nspe_queue_replied_status(ns_status, (1 << idx));
+        reply = PSA_SUCCESS;
+    }
 
-    tfm_mailbox_hal_exit_critical();
+    mailbox_reply_slot(idx, reply);
 
-    tfm_mailbox_hal_notify_peer();
+    mailbox_notify_replies();
 
     return MAILBOX_SUCCESS;
 }
@@ -455,22 +796,60 @@ static void mailbox_reply(const void *owner, int32_t ret)
     (void)tfm_mailbox_reply_msg(handle, ret);
 }
 
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+/*
+ * RPC resume() callback.
+ * The connection of the last replied call is released. Pass in the next calls
+ * of the batches and the messages held back since then.
+ */
+static void mailbox_resume(void)
+{
+    uint8_t idx;
+
+    for (idx = 0; (idx < NUM_MAILBOX_SPE_QUEUE_SLOT) && nr_pending_batches;
+         idx++) {
+        if (!is_spe_queue_slot_in_use(idx) ||
+            !spe_mailbox_queue.queue[idx].is_batch_pending) {
+            continue;
+        }
+
+        spe_mailbox_queue.queue[idx].is_batch_pending = false;
+        nr_pending_batches--;
+
+        if (mailbox_batch_dispatch(idx)) {
+            mailbox_reply_slot(idx, PSA_SUCCESS);
+        }
+    }
+
+    /* The SPE slots are free again. Handle the messages left pending. */
+    if (is_backlogged) {
+        (void)tfm_mailbox_handle_msg();
+    }
+
+    mailbox_notify_replies();
+}
+#endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
+
 /* Mailbox specific operations callback for TF-M RPC */
 static const struct tfm_rpc_ops_t mailbox_rpc_ops = {
     .handle_req = mailbox_handle_req,
     .reply      = mailbox_reply,
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    .resume     = mailbox_resume,
+#endif
 };
 
 static int32_t tfm_mailbox_init(void)
 {
     int32_t ret;
+    uint32_t idx;
 
     spm_memset(&spe_mailbox_queue, 0, sizeof(spe_mailbox_queue));
 
-    spe_mailbox_queue.empty_slots =
-            (mailbox_queue_status_t)((1UL << (NUM_MAILBOX_QUEUE_SLOT - 1)) - 1);
-    spe_mailbox_queue.empty_slots +=
-            (mailbox_queue_status_t)(1UL << (NUM_MAILBOX_QUEUE_SLOT - 1));
+    /* All the SPE slots are free. Slot 0 is taken first. */
+    for (idx = 0; idx < NUM_MAILBOX_SPE_QUEUE_SLOT; idx++) {
+        release_spe_queue_slot(NUM_MAILBOX_SPE_QUEUE_SLOT - 1 - idx);
+    }
 
     /* Register RPC callbacks */
     ret = tfm_rpc_register_ops(&mailbox_rpc_ops);
@@ -490,6 +869,14 @@ static int32_t tfm_mailbox_init(void)
         return ret;
     }
 
+#ifdef MAILBOX_RING_TRANSPORT
+    if (!spe_mailbox_queue.ns_rings) {
+        tfm_rpc_unregister_ops();
+
+        return MAILBOX_INIT_ERROR;
+    }
+#endif
+
     return MAILBOX_SUCCESS;
 }
 
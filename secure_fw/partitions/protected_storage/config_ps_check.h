@@ -24,6 +24,10 @@
 #error "Invalid config: NOT PS_ROLLBACK_PROTECTION and PS_ENCRYPTION and PSA_ALG_GCM or PSA_ALG_CCM!"
 #endif
 
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES < 1
+#error "Invalid config: PS_OBJ_TABLE_WRITE_BACK_UPDATES shall be at least 1"
+#endif
+
 /*
  * ITS_VALIDATE_METADATA_FROM_FLASH shall be enabled when PS_VALIDATE_METADATA_FROM_FLASH is
  * enabled
@@ -9,6 +9,7 @@
 
 #include "ps_encrypted_object.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -27,9 +28,34 @@
 
 #define PS_OBJECT_START_POSITION  0
 
+#ifdef PS_ENCRYPTION_CHUNKED
+/* Buffer to store the maximum encrypted object, with its chunk metadata */
+#define PS_MAX_ENCRYPTED_OBJ_SIZE \
+    PS_ENCRYPT_SIZE(PS_OBJ_CHUNKS_INFO_SIZE(PS_MAX_OBJECT_DATA_SIZE) \
+                    + PS_MAX_OBJECT_DATA_SIZE)
+
+/* Gets the stored size of the header of an object with the given data size.
+ * The chunk metadata is encrypted together with the object information.
+ */
+#define PS_STORED_HEADER_SIZE(size) \
+    (STORED_HEADER_DATA_SIZE + PS_ENCRYPT_SIZE(PS_OBJ_CHUNKS_INFO_SIZE(size)))
+
+/* Gets the position of a chunk in an object with the given data size */
+#define PS_CHUNK_POSITION(size, chunk_idx) \
+    (PS_STORED_HEADER_SIZE(size) + ((chunk_idx) * PS_ENCRYPTION_CHUNK_SIZE))
+
+/* Gets the size of a chunk in an object with the given data size */
+#define PS_CHUNK_SIZE(size, chunk_idx) \
+    PS_UTILS_MIN(PS_ENCRYPTION_CHUNK_SIZE, \
+                 (size) - ((chunk_idx) * PS_ENCRYPTION_CHUNK_SIZE))
+
+/* Stored size of a chunk metadata and of a full chunk */
+#define PS_CHUNK_STORED_SIZE \
+    (sizeof(struct ps_obj_chunk_t) + PS_ENCRYPTION_CHUNK_SIZE)
+#else
 /* Buffer to store the maximum encrypted object */
-/* FIXME: Do partial encrypt/decrypt to reduce the size of internal buffer */
 #define PS_MAX_ENCRYPTED_OBJ_SIZE PS_ENCRYPT_SIZE(PS_MAX_OBJECT_DATA_SIZE)
+#endif /* PS_ENCRYPTION_CHUNKED */
 
 /* Add the tag length to the crypto buffer size to account for the tag
  * being appended to the ciphertext by the crypto layer.
@@ -122,6 +148,317 @@ static psa_status_t ps_object_auth_encrypt(uint32_t fid,
     return PSA_SUCCESS;
 }
 
+#ifdef PS_ENCRYPTION_CHUNKED
+/**
+ * \brief Performs authenticated encryption or decryption of a chunk of the
+ *        object data in place, with the chunk index as the associated data.
+ *
+ * \param[in,out] obj        Pointer to the object structure. The crypto
+ *                           metadata of the chunk is updated on encryption.
+ * \param[in]     chunk_idx  Index of the chunk in the object data
+ * \param[in,out] data       Pointer to the chunk data. It must be followed by
+ *                           PS_TAG_LEN_BYTES bytes of buffer, which are kept.
+ * \param[in]     size       Size of the chunk data
+ * \param[in]     encrypt    True to encrypt the chunk, false to decrypt it
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_chunk_crypt(struct ps_object_t *obj,
+                                          uint32_t chunk_idx,
+                                          uint8_t *data,
+                                          uint32_t size,
+                                          bool encrypt)
+{
+    psa_status_t err;
+    union ps_crypto_t crypto;
+    struct ps_obj_chunk_t *chunk = (struct ps_obj_chunk_t *)obj->data
+                                   + chunk_idx;
+    uint8_t next_data[PS_TAG_LEN_BYTES];
+    size_t out_len = 0;
+
+    /* The chunks are encrypted with the object key. The chunk index is the
+     * associated data, so that the chunks cannot be reordered. The File ID is
+     * not, so that the chunks which are not modified are kept as they are
+     * when the object is written to a new file.
+     */
+    crypto.ref.uid = obj->header.crypto.ref.uid;
+    crypto.ref.client_id = obj->header.crypto.ref.client_id;
+
+    /* The crypto layer places the tag after the data, which is the start of
+     * the next chunk.
+     */
+    (void)memcpy(next_data, data + size, PS_TAG_LEN_BYTES);
+
+    if (encrypt) {
+        /* Get a new IV for each encryption */
+        err = ps_crypto_get_iv(&crypto);
+        if (err == PSA_SUCCESS) {
+            err = ps_crypto_encrypt_and_tag(&crypto,
+                                            (const uint8_t *)&chunk_idx,
+                                            sizeof(chunk_idx),
+                                            data, size,
+                                            data, size + PS_TAG_LEN_BYTES,
+                                            &out_len);
+        }
+        if (err == PSA_SUCCESS) {
+            (void)memcpy(chunk->iv, crypto.ref.iv, PS_IV_LEN_BYTES);
+            (void)memcpy(chunk->tag, crypto.ref.tag, PS_TAG_LEN_BYTES);
+        }
+    } else {
+        (void)memcpy(crypto.ref.iv, chunk->iv, PS_IV_LEN_BYTES);
+        (void)memcpy(crypto.ref.tag, chunk->tag, PS_TAG_LEN_BYTES);
+
+        err = ps_crypto_auth_and_decrypt(&crypto,
+                                         (const uint8_t *)&chunk_idx,
+                                         sizeof(chunk_idx),
+                                         data, size,
+                                         data, size + PS_TAG_LEN_BYTES,
+                                         &out_len);
+    }
+
+    (void)memcpy(data + size, next_data, PS_TAG_LEN_BYTES);
+
+    if (err != PSA_SUCCESS || out_len != size) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Checks if a chunk of the object data is modified by a write.
+ *
+ * \param[in] size       Size of the object data after the write
+ * \param[in] chunk_idx  Index of the chunk in the object data
+ * \param[in] offset     Offset of the written range in the object data
+ * \param[in] wrt_size   Size of the written range
+ *
+ * \return Returns true if the chunk overlaps the written range
+ */
+static bool ps_object_chunk_is_written(uint32_t size, uint32_t chunk_idx,
+                                       uint32_t offset, uint32_t wrt_size)
+{
+    uint32_t chunk_start = chunk_idx * PS_ENCRYPTION_CHUNK_SIZE;
+
+    return (wrt_size > 0) && (chunk_start < offset + wrt_size)
+           && (chunk_start + PS_CHUNK_SIZE(size, chunk_idx) > offset);
+}
+
+psa_status_t ps_encrypted_object_read_header(uint32_t fid,
+                                             struct ps_object_t *obj)
+{
+    psa_status_t err;
+    struct psa_storage_info_t info;
+    uint32_t stored_size;
+    uint32_t num_chunks;
+    uint32_t data_size;
+    size_t data_length;
+
+    /* The size of the chunk metadata depends on the object data size, which
+     * is encrypted. Get it from the size of the stored object instead.
+     */
+    err = psa_its_get_info(fid, &info);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (info.size < PS_STORED_HEADER_SIZE(0)) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    /* Each chunk adds its metadata to the stored size, the last chunk may be
+     * shorter than the others.
+     */
+    stored_size = info.size - PS_STORED_HEADER_SIZE(0);
+    num_chunks = (stored_size + PS_CHUNK_STORED_SIZE - 1)
+                 / PS_CHUNK_STORED_SIZE;
+    if (stored_size < (num_chunks * sizeof(struct ps_obj_chunk_t))) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    data_size = stored_size - (num_chunks * sizeof(struct ps_obj_chunk_t));
+    if (data_size > PS_MAX_OBJECT_DATA_SIZE
+        || PS_OBJ_NUM_CHUNKS(data_size) != num_chunks) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    /* Read the IV and the encrypted object information and chunk metadata */
+    err = psa_its_get(fid, PS_OBJECT_START_POSITION,
+                      PS_STORED_HEADER_SIZE(data_size),
+                      (void *)obj->header.crypto.ref.iv,
+                      &data_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (data_length != PS_STORED_HEADER_SIZE(data_size)) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    err = ps_object_auth_decrypt(fid,
+                    PS_ENCRYPT_SIZE(PS_OBJ_CHUNKS_INFO_SIZE(data_size)), obj);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (obj->header.info.current_size != data_size) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_encrypted_object_read_chunk(uint32_t fid,
+                                            const struct ps_object_t *obj,
+                                            uint32_t chunk_idx,
+                                            uint8_t *buf,
+                                            uint32_t *chunk_size)
+{
+    psa_status_t err;
+    uint32_t size = obj->header.info.current_size;
+    uint32_t rd_size;
+    size_t data_length;
+
+    if (chunk_idx >= PS_OBJ_NUM_CHUNKS(size)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    rd_size = PS_CHUNK_SIZE(size, chunk_idx);
+
+    err = psa_its_get(fid, PS_CHUNK_POSITION(size, chunk_idx), rd_size,
+                      (void *)buf, &data_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (data_length != rd_size) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    /* The object is not modified when decrypting */
+    err = ps_object_chunk_crypt((struct ps_object_t *)obj, chunk_idx, buf,
+                                rd_size, false);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    *chunk_size = rd_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_encrypted_object_load_chunks(uint32_t fid,
+                                             struct ps_object_t *obj,
+                                             uint32_t offset,
+                                             uint32_t size)
+{
+    psa_status_t err;
+    uint32_t old_size = obj->header.info.current_size;
+    uint32_t new_size = PS_UTILS_MAX(old_size, offset + size);
+    uint8_t *p_data = obj->data + PS_OBJ_CHUNKS_INFO_SIZE(new_size);
+    uint32_t chunk_idx;
+    uint32_t chunk_start;
+    uint32_t rd_size;
+    size_t data_length;
+
+    /* The metadata of the new chunks is filled in when they are encrypted */
+    (void)memset(obj->data + PS_OBJ_CHUNKS_INFO_SIZE(old_size),
+                 PS_DEFAULT_EMPTY_BUFF_VAL,
+                 PS_OBJ_CHUNKS_INFO_SIZE(new_size)
+                 - PS_OBJ_CHUNKS_INFO_SIZE(old_size));
+
+    /* The chunk metadata stays at the start of the buffer, the chunks are
+     * loaded at their position for the new object data size.
+     */
+    for (chunk_idx = 0; chunk_idx < PS_OBJ_NUM_CHUNKS(old_size); chunk_idx++) {
+        chunk_start = chunk_idx * PS_ENCRYPTION_CHUNK_SIZE;
+
+        if (offset <= chunk_start && chunk_start
+                + PS_CHUNK_SIZE(new_size, chunk_idx) <= offset + size) {
+            /* The chunk is fully overwritten */
+            continue;
+        }
+
+        rd_size = PS_CHUNK_SIZE(old_size, chunk_idx);
+
+        err = psa_its_get(fid, PS_CHUNK_POSITION(old_size, chunk_idx),
+                          rd_size, (void *)(p_data + chunk_start),
+                          &data_length);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (data_length != rd_size) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+
+        if (ps_object_chunk_is_written(new_size, chunk_idx, offset, size)) {
+            /* The chunk is partially overwritten, the rest of its data is
+             * needed to encrypt it again.
+             */
+            err = ps_object_chunk_crypt(obj, chunk_idx, p_data + chunk_start,
+                                        rd_size, false);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    obj->header.info.current_size = new_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_encrypted_object_write_chunks(uint32_t fid,
+                                              struct ps_object_t *obj,
+                                              uint32_t offset,
+                                              uint32_t size)
+{
+    psa_status_t err;
+    uint32_t obj_size = obj->header.info.current_size;
+    uint8_t *p_data = PS_OBJECT_DATA(obj);
+    uint8_t first_data[PS_TAG_LEN_BYTES];
+    uint32_t chunk_idx;
+    uint32_t chunk_start;
+
+    /* Encrypt the chunks in the written range only */
+    for (chunk_idx = offset / PS_ENCRYPTION_CHUNK_SIZE;
+         chunk_idx < PS_OBJ_NUM_CHUNKS(obj_size); chunk_idx++) {
+        if (!ps_object_chunk_is_written(obj_size, chunk_idx, offset, size)) {
+            break;
+        }
+
+        chunk_start = chunk_idx * PS_ENCRYPTION_CHUNK_SIZE;
+
+        err = ps_object_chunk_crypt(obj, chunk_idx, p_data + chunk_start,
+                                    PS_CHUNK_SIZE(obj_size, chunk_idx), true);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Authenticate and encrypt the object information and chunk metadata.
+     * The crypto layer places the tag over the start of the object data.
+     */
+    (void)memcpy(first_data, p_data, PS_TAG_LEN_BYTES);
+
+    err = ps_object_auth_encrypt(fid,
+                    PS_ENCRYPT_SIZE(PS_OBJ_CHUNKS_INFO_SIZE(obj_size)), obj);
+
+    (void)memcpy(p_data, first_data, PS_TAG_LEN_BYTES);
+
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Write the IV, the encrypted header and the chunks to the persistent
+     * area. The tag is not copied as it is stored in the object table.
+     */
+    return psa_its_set(fid, PS_STORED_HEADER_SIZE(obj_size) + obj_size,
+                       (const void *)obj->header.crypto.ref.iv,
+                       PSA_STORAGE_FLAG_NONE);
+}
+#else
 psa_status_t ps_encrypted_object_read(uint32_t fid, struct ps_object_t *obj)
 {
     psa_status_t err;
@@ -182,3 +519,4 @@ psa_status_t ps_encrypted_object_write(uint32_t fid, struct ps_object_t *obj)
     return psa_its_set(fid, wrt_size, (const void *)obj->header.crypto.ref.iv,
                        PSA_STORAGE_FLAG_NONE);
 }
+#endif /* PS_ENCRYPTION_CHUNKED */
@@ -16,6 +16,81 @@
 extern "C" {
 #endif
 
+#ifdef PS_ENCRYPTION_CHUNKED
+/**
+ * \brief Reads and authenticates the header of the object referenced by the
+ *        object File ID, without reading the object data.
+ *
+ * \param[in]     fid  File ID
+ * \param[in,out] obj  Pointer to the object structure to fill in. The UID
+ *                     and client ID of its crypto metadata must be set.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_header(uint32_t fid,
+                                             struct ps_object_t *obj);
+
+/**
+ * \brief Reads and decrypts one chunk of the object data.
+ *
+ * \param[in]  fid         File ID
+ * \param[in]  obj         Pointer to the object structure, with the header
+ *                         read by \ref ps_encrypted_object_read_header
+ * \param[in]  chunk_idx   Index of the chunk in the object data
+ * \param[out] buf         Buffer to fill in with the chunk data. It must be
+ *                         PS_TAG_LEN_BYTES longer than the chunk.
+ * \param[out] chunk_size  Pointer to store the size of the chunk data
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_chunk(uint32_t fid,
+                                            const struct ps_object_t *obj,
+                                            uint32_t chunk_idx,
+                                            uint8_t *buf,
+                                            uint32_t *chunk_size);
+
+/**
+ * \brief Prepares the object data for a write of the given range, growing
+ *        the object if the range ends past its current size.
+ *
+ * \details The chunks not modified by the write are loaded still encrypted.
+ *          Only the chunks partially overwritten are decrypted, so the ones
+ *          fully overwritten are neither read nor decrypted.
+ *
+ * \param[in]     fid     File ID
+ * \param[in,out] obj     Pointer to the object structure, with the header
+ *                        read by \ref ps_encrypted_object_read_header
+ * \param[in]     offset  Offset of the range to write in the object data
+ * \param[in]     size    Size of the range to write
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_load_chunks(uint32_t fid,
+                                             struct ps_object_t *obj,
+                                             uint32_t offset,
+                                             uint32_t size);
+
+/**
+ * \brief Encrypts the chunks of the object data in the given range and writes
+ *        the object.
+ *
+ * \param[in]     fid     File ID
+ * \param[in,out] obj     Pointer to the object structure to write. All the
+ *                        chunks outside the range must be encrypted.
+ * \param[in]     offset  Offset of the written range in the object data
+ * \param[in]     size    Size of the written range
+ *
+ * Note: The function will use obj to store the encrypted data before write it
+ *       into the flash. So, this object will contain the encrypted object
+ *       stored in the flash.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_write_chunks(uint32_t fid,
+                                              struct ps_object_t *obj,
+                                              uint32_t offset,
+                                              uint32_t size);
+#else
 /**
  * \brief Reads object referenced by the object File ID.
  *
@@ -43,6 +118,7 @@ psa_status_t ps_encrypted_object_read(uint32_t fid,
  */
 psa_status_t ps_encrypted_object_write(uint32_t fid,
                                        struct ps_object_t *obj);
+#endif /* PS_ENCRYPTION_CHUNKED */
 
 #ifdef __cplusplus
 }
@@ -48,7 +48,33 @@ struct ps_obj_header_t {
 
 #define PS_MAX_OBJECT_DATA_SIZE  PS_MAX_ASSET_SIZE
 
-#ifdef PS_ENCRYPTION
+#if defined(PS_ENCRYPTION) && (PS_ENCRYPTION_CHUNK_SIZE > 0)
+/* Encrypted objects are split in chunks which are authenticated separately */
+#define PS_ENCRYPTION_CHUNKED
+
+/*!
+ * \struct ps_obj_chunk_t
+ *
+ * \brief Crypto metadata of an object data chunk, stored in the encrypted
+ *        part of the object header.
+ */
+struct ps_obj_chunk_t {
+    uint8_t iv[PS_IV_LEN_BYTES];   /*!< IV value of the chunk */
+    uint8_t tag[PS_TAG_LEN_BYTES]; /*!< MAC value of the chunk */
+};
+
+/* Number of chunks of an object with the given data size */
+#define PS_OBJ_NUM_CHUNKS(size) \
+    (((size) + PS_ENCRYPTION_CHUNK_SIZE - 1) / PS_ENCRYPTION_CHUNK_SIZE)
+
+/* Size of the chunk metadata of an object with the given data size */
+#define PS_OBJ_CHUNKS_INFO_SIZE(size) \
+    (PS_OBJ_NUM_CHUNKS(size) * sizeof(struct ps_obj_chunk_t))
+
+/* The chunk metadata is placed before the object data in the data buffer */
+#define PS_OBJECT_BUF_SIZE (PS_OBJ_CHUNKS_INFO_SIZE(PS_MAX_OBJECT_DATA_SIZE) \
+                            + PS_MAX_OBJECT_DATA_SIZE + PS_TAG_LEN_BYTES)
+#elif defined(PS_ENCRYPTION)
 #define PS_OBJECT_BUF_SIZE (PS_MAX_OBJECT_DATA_SIZE + PS_TAG_LEN_BYTES)
 #else
 #define PS_OBJECT_BUF_SIZE PS_MAX_OBJECT_DATA_SIZE
@@ -67,6 +93,14 @@ struct ps_object_t {
 };
 
 
+#ifdef PS_ENCRYPTION_CHUNKED
+/* Gets the start of the object data in the data buffer */
+#define PS_OBJECT_DATA(obj) \
+    ((obj)->data + PS_OBJ_CHUNKS_INFO_SIZE((obj)->header.info.current_size))
+#else
+#define PS_OBJECT_DATA(obj) ((obj)->data)
+#endif
+
 #define PS_OBJECT_HEADER_SIZE    sizeof(struct ps_obj_header_t)
 #define PS_MAX_OBJECT_SIZE       sizeof(struct ps_object_t)
 
@@ -76,7 +110,19 @@ struct ps_object_t {
  * \brief Specifies the maximum number of objects in the system, which is the
  *        number of defined assets, the object table and 2 temporary objects to
  *        store the temporary object table and temporary updated object.
+ *
+ * \details With PS_OBJ_TABLE_WRITE_BACK_UPDATES greater than 1, the files of
+ *          the objects replaced or deleted by the pending updates are kept
+ *          until the table is saved, so every entry of the object table
+ *          (PS_NUM_ASSETS + 1) can hold an object file when the table save
+ *          creates the temporary object table. One more file is then needed,
+ *          as the filesystem keeps a spare file for the atomic replacement of
+ *          a file.
  */
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+#define PS_MAX_NUM_OBJECTS (PS_NUM_ASSETS + 4)
+#else
 #define PS_MAX_NUM_OBJECTS (PS_NUM_ASSETS + 3)
+#endif
 
 #endif /* __PS_OBJECT_DEFS_H__ */
@@ -94,6 +94,50 @@ static psa_status_t ps_update_table(psa_storage_uid_t uid, int32_t client_id)
     return err;
 }
 
+#ifdef PS_ENCRYPTION_CHUNKED
+/**
+ * \brief Reads a range of the object data, based on its object table info
+ *        stored in g_obj_tbl_info, and writes it to the client.
+ *
+ * \details Only the chunks covering the range are read and decrypted, one at
+ *          a time, into the start of the object data buffer.
+ *
+ * \param[in] offset  Offset of the range in the object data
+ * \param[in] size    Size of the range, contained in the object data
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_read_object_chunks(uint32_t offset, uint32_t size)
+{
+    psa_status_t err;
+    uint8_t *p_chunk = PS_OBJECT_DATA(&g_ps_object);
+    uint32_t chunk_offset;
+    uint32_t chunk_size;
+    uint32_t rd_size;
+
+    while (size > 0) {
+        chunk_offset = offset % PS_ENCRYPTION_CHUNK_SIZE;
+
+        err = ps_encrypted_object_read_chunk(g_obj_tbl_info.fid, &g_ps_object,
+                                             offset / PS_ENCRYPTION_CHUNK_SIZE,
+                                             p_chunk, &chunk_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        rd_size = PS_UTILS_MIN(size, chunk_size - chunk_offset);
+
+        /* Copy the decrypted chunk data to the output buffer */
+        ps_req_mngr_write_asset_data(p_chunk + chunk_offset, rd_size);
+
+        offset += rd_size;
+        size -= rd_size;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* PS_ENCRYPTION_CHUNKED */
+
 #ifndef PS_ENCRYPTION
 enum read_type_t {
     READ_HEADER_ONLY = 0,
@@ -207,7 +251,11 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#ifdef PS_ENCRYPTION_CHUNKED
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+#endif
 #else
     /* Read object header */
     err = ps_read_object(READ_ALL_OBJECT);
@@ -225,8 +273,15 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
     size = PS_UTILS_MIN(size,
                         g_ps_object.header.info.current_size - offset);
 
+#ifdef PS_ENCRYPTION_CHUNKED
+    err = ps_read_object_chunks(offset, size);
+    if (err != PSA_SUCCESS) {
+        goto clear_data_and_return;
+    }
+#else
     /* Copy the decrypted object data to the output buffer */
     ps_req_mngr_write_asset_data(g_ps_object.data + offset, size);
+#endif
 
     *p_data_length = size;
 
@@ -265,7 +320,12 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
         g_ps_object.header.crypto.ref.uid = uid;
         g_ps_object.header.crypto.ref.client_id = client_id;
 
+#ifdef PS_ENCRYPTION_CHUNKED
+        err = ps_encrypted_object_read_header(g_obj_tbl_info.fid,
+                                              &g_ps_object);
+#else
         err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+#endif
 #else
         /* Read the object header */
         err = ps_read_object(READ_HEADER_ONLY);
@@ -283,9 +343,14 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
             goto clear_data_and_return;
         }
 
+#ifdef PS_ENCRYPTION_CHUNKED
+        /* The object content is replaced, including its chunk metadata */
+        ps_init_empty_object(uid, client_id, create_flags, size, &g_ps_object);
+#else
         /* Update the create flags and max object size */
         g_ps_object.header.info.create_flags = create_flags;
         g_ps_object.header.info.max_size = size;
+#endif
 
         /* Save old file ID */
         old_fid = g_obj_tbl_info.fid;
@@ -299,15 +364,15 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
         return err;
     }
 
+    /* Update the current object size */
+    g_ps_object.header.info.current_size = size;
+
     /* Update the object data */
-    err = ps_req_mngr_read_asset_data(g_ps_object.data, size);
+    err = ps_req_mngr_read_asset_data(PS_OBJECT_DATA(&g_ps_object), size);
     if (err != PSA_SUCCESS) {
         goto clear_data_and_return;
     }
 
-    /* Update the current object size */
-    g_ps_object.header.info.current_size = size;
-
     /* Get new file ID */
     err = ps_object_table_get_free_fid(fid_am_reserved,
                                        &g_obj_tbl_info.fid);
@@ -315,7 +380,10 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
         goto clear_data_and_return;
     }
 
-#ifdef PS_ENCRYPTION
+#ifdef PS_ENCRYPTION_CHUNKED
+    err = ps_encrypted_object_write_chunks(g_obj_tbl_info.fid, &g_ps_object,
+                                           0, size);
+#elif defined(PS_ENCRYPTION)
     err = ps_encrypted_object_write(g_obj_tbl_info.fid, &g_ps_object);
 #else
     wrt_size = PS_OBJECT_SIZE(g_ps_object.header.info.current_size);
@@ -334,7 +402,7 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
 
     if (old_fid != PS_INVALID_FID) {
         /* Remove old object */
-        err = psa_its_remove(old_fid);
+        err = ps_object_table_delete_old_object(old_fid);
     }
 
 clear_data_and_return:
@@ -367,7 +435,11 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#ifdef PS_ENCRYPTION_CHUNKED
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+#endif
 #else
     err = ps_read_object(READ_ALL_OBJECT);
 #endif
@@ -396,8 +468,20 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         goto clear_data_and_return;
     }
 
+#ifdef PS_ENCRYPTION_CHUNKED
+    /* Load the object data which is not overwritten. This updates the
+     * current object size.
+     */
+    err = ps_encrypted_object_load_chunks(g_obj_tbl_info.fid, &g_ps_object,
+                                          offset, size);
+    if (err != PSA_SUCCESS) {
+        goto clear_data_and_return;
+    }
+#endif
+
     /* Update the object data */
-    err = ps_req_mngr_read_asset_data(g_ps_object.data + offset, size);
+    err = ps_req_mngr_read_asset_data(PS_OBJECT_DATA(&g_ps_object) + offset,
+                                      size);
     if (err != PSA_SUCCESS) {
         goto clear_data_and_return;
     }
@@ -416,7 +500,10 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         goto clear_data_and_return;
     }
 
-#ifdef PS_ENCRYPTION
+#ifdef PS_ENCRYPTION_CHUNKED
+    err = ps_encrypted_object_write_chunks(g_obj_tbl_info.fid, &g_ps_object,
+                                           offset, size);
+#elif defined(PS_ENCRYPTION)
     err = ps_encrypted_object_write(g_obj_tbl_info.fid, &g_ps_object);
 #else
     wrt_size = PS_OBJECT_SIZE(g_ps_object.header.info.current_size);
@@ -435,7 +522,7 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
 
     if (old_fid != PS_INVALID_FID) {
         /* Remove old object */
-        err = psa_its_remove(old_fid);
+        err = ps_object_table_delete_old_object(old_fid);
     }
 
 clear_data_and_return:
@@ -463,7 +550,11 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#ifdef PS_ENCRYPTION_CHUNKED
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+#endif
 #else
     err = ps_read_object(READ_HEADER_ONLY);
 #endif
@@ -499,7 +590,11 @@ psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#ifdef PS_ENCRYPTION_CHUNKED
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+#endif
 #else
     err = ps_read_object(READ_HEADER_ONLY);
 #endif
@@ -528,7 +623,7 @@ psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
     }
 
     /* Delete old file from the persistent area */
-    err = psa_its_remove(g_obj_tbl_info.fid);
+    err = ps_object_table_delete_old_object(g_obj_tbl_info.fid);
 
 clear_data_and_return:
     /* Remove data stored in the object before leaving the function */
@@ -7,6 +7,7 @@
 
 #include "ps_object_table.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -126,6 +127,30 @@ struct ps_obj_table_t {
 #define PS_OBJECT_FS_ID_TO_IDX(fid) ((fid - 1) - \
                                       PS_TABLE_FS_ID(PS_OBJ_TABLE_IDX_1))
 
+#if (PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1) || PS_OBJ_TABLE_INDEX
+/* Number of words of the bitmaps with one bit per object table entry */
+#define PS_OBJ_TABLE_BITMAP_WORDS ((PS_OBJ_TABLE_ENTRIES + 31) / 32)
+
+#define PS_OBJ_TABLE_BIT_IS_SET(bitmap, idx) \
+    ((((bitmap)[(idx) / 32]) >> ((idx) % 32)) & 1U)
+#define PS_OBJ_TABLE_BIT_SET(bitmap, idx) \
+    ((bitmap)[(idx) / 32] |= (1UL << ((idx) % 32)))
+#define PS_OBJ_TABLE_BIT_CLEAR(bitmap, idx) \
+    ((bitmap)[(idx) / 32] &= ~(1UL << ((idx) % 32)))
+#endif /* (PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1) || PS_OBJ_TABLE_INDEX */
+
+#if PS_OBJ_TABLE_INDEX
+/* Number of buckets of the hash index, which is kept at most half full */
+#define PS_OBJ_TABLE_INDEX_NUM_BUCKETS (2 * PS_OBJ_TABLE_ENTRIES)
+
+/* Value of an empty bucket of the hash index */
+#define PS_OBJ_TABLE_INDEX_EMPTY 0xFFFFU
+
+/* Check at compilation time if the entry indexes fit in the buckets */
+PS_UTILS_BOUND_CHECK(OBJ_TABLE_ENTRIES_NOT_FIT_IN_INDEX_BUCKETS,
+                     PS_OBJ_TABLE_ENTRIES, PS_OBJ_TABLE_INDEX_EMPTY);
+#endif /* PS_OBJ_TABLE_INDEX */
+
 /*!
  * \struct ps_obj_table_ctx_t
  *
@@ -135,6 +160,22 @@ struct ps_obj_table_ctx_t {
     struct ps_obj_table_t obj_table;  /*!< Object tables */
     uint8_t active_table;             /*!< Active object table */
     uint8_t scratch_table;            /*!< Scratch object table */
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    uint32_t dirty_entries[PS_OBJ_TABLE_BITMAP_WORDS]; /*!< Entries changed
+                                                        *   since the table
+                                                        *   was last saved
+                                                        */
+    uint32_t saved_entries[PS_OBJ_TABLE_BITMAP_WORDS]; /*!< Entries in use in
+                                                        *   the last saved
+                                                        *   table
+                                                        */
+    uint32_t pending_updates;         /*!< Updates not saved yet */
+    struct ps_obj_table_stats_t stats; /*!< Write-back statistics */
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+#if PS_OBJ_TABLE_INDEX
+    uint16_t index[PS_OBJ_TABLE_INDEX_NUM_BUCKETS]; /*!< UID hash index */
+    uint32_t free_entries[PS_OBJ_TABLE_BITMAP_WORDS]; /*!< Free entries */
+#endif /* PS_OBJ_TABLE_INDEX */
 };
 
 /* Object table context */
@@ -617,6 +658,239 @@ static psa_status_t ps_object_table_save_table(
     return err;
 }
 
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+/**
+ * \brief Saves the object table, if it has updates which are not saved yet.
+ *
+ * \details The object files which are only referred to by the previously saved
+ *          table are removed after the save. A file left behind by a failed
+ *          removal is removed when its file ID is reused.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_flush(void)
+{
+    psa_status_t err;
+    uint32_t i;
+    struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+
+    if (ps_obj_table_ctx.pending_updates == 0) {
+        return PSA_SUCCESS;
+    }
+
+    err = ps_object_table_save_table(p_table);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    (void)psa_its_remove(PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table));
+
+    /* Only the entries changed since the last save need to be checked */
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        if (!PS_OBJ_TABLE_BIT_IS_SET(ps_obj_table_ctx.dirty_entries, i)) {
+            continue;
+        }
+
+        if (p_table->obj_db[i].uid != TFM_PS_INVALID_UID) {
+            PS_OBJ_TABLE_BIT_SET(ps_obj_table_ctx.saved_entries, i);
+        } else if (PS_OBJ_TABLE_BIT_IS_SET(ps_obj_table_ctx.saved_entries, i)) {
+            PS_OBJ_TABLE_BIT_CLEAR(ps_obj_table_ctx.saved_entries, i);
+            (void)psa_its_remove(PS_OBJECT_FS_ID(i));
+        }
+    }
+
+    (void)memset(ps_obj_table_ctx.dirty_entries, 0,
+                 sizeof(ps_obj_table_ctx.dirty_entries));
+    ps_obj_table_ctx.pending_updates = 0;
+    ps_obj_table_ctx.stats.saves++;
+
+    return PSA_SUCCESS;
+}
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+
+/**
+ * \brief Persists an update of the object table entries.
+ *
+ * \details With PS_OBJ_TABLE_WRITE_BACK_UPDATES greater than 1, the table is
+ *          only saved once that number of updates is pending. Until then, the
+ *          last saved table and the object files it refers to are kept
+ *          untouched, so a power failure reverts the pending updates.
+ *
+ * \param[in,out] obj_table  Pointer to the object table to save
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_update(struct ps_obj_table_t *obj_table)
+{
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    psa_status_t err;
+
+    (void)obj_table;
+
+    ps_obj_table_ctx.pending_updates++;
+    if (ps_obj_table_ctx.pending_updates < PS_OBJ_TABLE_WRITE_BACK_UPDATES) {
+        ps_obj_table_ctx.stats.saves_avoided++;
+        return PSA_SUCCESS;
+    }
+
+    err = ps_object_table_flush();
+    if (err != PSA_SUCCESS) {
+        /* The caller rolls this update back, so it is not pending */
+        ps_obj_table_ctx.pending_updates--;
+    }
+
+    return err;
+#else
+    return ps_object_table_save_table(obj_table);
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+}
+
+#if PS_OBJ_TABLE_INDEX
+/**
+ * \brief Gets the first hash index bucket to probe for an object.
+ *
+ * \param[in] uid        Object UID
+ * \param[in] client_id  Client UID
+ *
+ * \return Bucket index
+ */
+static uint32_t ps_table_index_hash(psa_storage_uid_t uid, int32_t client_id)
+{
+    uint32_t i;
+    /* FNV-1a */
+    uint32_t hash = 2166136261U;
+
+    for (i = 0; i < sizeof(uid); i++) {
+        hash ^= (uint8_t)(uid >> (8 * i));
+        hash *= 16777619U;
+    }
+
+    for (i = 0; i < sizeof(client_id); i++) {
+        hash ^= (uint8_t)((uint32_t)client_id >> (8 * i));
+        hash *= 16777619U;
+    }
+
+    return hash % PS_OBJ_TABLE_INDEX_NUM_BUCKETS;
+}
+
+/**
+ * \brief Looks up an object in the hash index.
+ *
+ * \param[in]  uid        Object UID
+ * \param[in]  client_id  Client UID
+ * \param[out] bucket     Pointer to store the bucket of the object, or the
+ *                        empty bucket which ends its probe sequence
+ *
+ * \return Returns true if the object is in the index, false otherwise
+ */
+static bool ps_table_index_find(psa_storage_uid_t uid, int32_t client_id,
+                                uint32_t *bucket)
+{
+    const struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    uint32_t b = ps_table_index_hash(uid, client_id);
+    uint16_t idx;
+
+    /* The index is never full, so an empty bucket ends every probe */
+    while ((idx = ps_obj_table_ctx.index[b]) != PS_OBJ_TABLE_INDEX_EMPTY) {
+        if (p_table->obj_db[idx].uid == uid
+            && p_table->obj_db[idx].client_id == client_id) {
+            break;
+        }
+        b = (b + 1) % PS_OBJ_TABLE_INDEX_NUM_BUCKETS;
+    }
+
+    *bucket = b;
+
+    return idx != PS_OBJ_TABLE_INDEX_EMPTY;
+}
+
+/**
+ * \brief Adds an entry in use to the hash index.
+ *
+ * \note If another entry has the same UID and client ID, the entry is not
+ *       added, which matches the result of a linear scan of the table.
+ *
+ * \param[in] idx  Entry index to add
+ */
+static void ps_table_index_add(uint32_t idx)
+{
+    const struct ps_obj_table_entry_t *entry =
+                                    &ps_obj_table_ctx.obj_table.obj_db[idx];
+    uint32_t bucket;
+
+    PS_OBJ_TABLE_BIT_CLEAR(ps_obj_table_ctx.free_entries, idx);
+
+    if (!ps_table_index_find(entry->uid, entry->client_id, &bucket)) {
+        ps_obj_table_ctx.index[bucket] = (uint16_t)idx;
+    }
+}
+
+/**
+ * \brief Removes an entry in use from the hash index.
+ *
+ * \details The entries following the removed one in its probe sequence are
+ *          shifted back, so that no deleted marker is needed.
+ *
+ * \param[in] idx  Entry index to remove
+ */
+static void ps_table_index_remove(uint32_t idx)
+{
+    const struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    uint32_t hole;
+    uint32_t b;
+    uint32_t home;
+
+    PS_OBJ_TABLE_BIT_SET(ps_obj_table_ctx.free_entries, idx);
+
+    if (!ps_table_index_find(p_table->obj_db[idx].uid,
+                             p_table->obj_db[idx].client_id, &hole)
+        || ps_obj_table_ctx.index[hole] != idx) {
+        return;
+    }
+
+    b = hole;
+    for (;;) {
+        ps_obj_table_ctx.index[hole] = PS_OBJ_TABLE_INDEX_EMPTY;
+
+        /* Find the next entry which may be moved into the hole */
+        do {
+            b = (b + 1) % PS_OBJ_TABLE_INDEX_NUM_BUCKETS;
+            if (ps_obj_table_ctx.index[b] == PS_OBJ_TABLE_INDEX_EMPTY) {
+                return;
+            }
+            home = ps_table_index_hash(
+                            p_table->obj_db[ps_obj_table_ctx.index[b]].uid,
+                            p_table->obj_db[ps_obj_table_ctx.index[b]].client_id);
+            /* The entry stays if its home bucket is cyclically in (hole, b] */
+        } while ((hole < b) ? (home > hole && home <= b)
+                            : (home > hole || home <= b));
+
+        ps_obj_table_ctx.index[hole] = ps_obj_table_ctx.index[b];
+        hole = b;
+    }
+}
+
+/**
+ * \brief Rebuilds the hash index and the free entries from the table.
+ */
+static void ps_table_index_rebuild(void)
+{
+    uint32_t i;
+
+    (void)memset(ps_obj_table_ctx.index, 0xFF, sizeof(ps_obj_table_ctx.index));
+    (void)memset(ps_obj_table_ctx.free_entries, 0,
+                 sizeof(ps_obj_table_ctx.free_entries));
+
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        if (ps_obj_table_ctx.obj_table.obj_db[i].uid == TFM_PS_INVALID_UID) {
+            PS_OBJ_TABLE_BIT_SET(ps_obj_table_ctx.free_entries, i);
+        } else {
+            ps_table_index_add(i);
+        }
+    }
+}
+#endif /* PS_OBJ_TABLE_INDEX */
+
 /**
  * \brief Checks the validity of the table version.
  *
@@ -768,6 +1042,18 @@ static psa_status_t ps_get_object_entry_idx(psa_storage_uid_t uid,
                                             int32_t client_id,
                                             uint32_t *idx)
 {
+#if PS_OBJ_TABLE_INDEX
+    uint32_t bucket;
+
+    if (uid == TFM_PS_INVALID_UID) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    if (ps_table_index_find(uid, client_id, &bucket)) {
+        *idx = ps_obj_table_ctx.index[bucket];
+        return PSA_SUCCESS;
+    }
+#else
     uint32_t i;
     struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
 
@@ -778,10 +1064,62 @@ static psa_status_t ps_get_object_entry_idx(psa_storage_uid_t uid,
             return PSA_SUCCESS;
         }
     }
+#endif /* PS_OBJ_TABLE_INDEX */
 
     return PSA_ERROR_DOES_NOT_EXIST;
 }
 
+/**
+ * \brief Checks if a table entry can be allocated to a new object.
+ *
+ * \param[in] idx  Entry index to check
+ *
+ * \note With write-back, an entry is only free once it is also free in the
+ *       last saved table, as that table may still refer to the object file.
+ *
+ * \return Returns true if the entry is free, false otherwise
+ */
+__attribute__ ((always_inline))
+__STATIC_INLINE bool ps_table_entry_is_free(uint32_t idx)
+{
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    if (PS_OBJ_TABLE_BIT_IS_SET(ps_obj_table_ctx.saved_entries, idx)) {
+        return false;
+    }
+#endif
+
+    return ps_obj_table_ctx.obj_table.obj_db[idx].uid == TFM_PS_INVALID_UID;
+}
+
+/**
+ * \brief Marks a table entry as changed since the table was last saved.
+ *
+ * \param[in] idx  Entry index to mark
+ */
+__attribute__ ((always_inline))
+__STATIC_INLINE void ps_table_mark_dirty(uint32_t idx)
+{
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    PS_OBJ_TABLE_BIT_SET(ps_obj_table_ctx.dirty_entries, idx);
+#else
+    (void)idx;
+#endif
+}
+
+/**
+ * \brief Records that a table entry has been filled in with an object.
+ *
+ * \param[in] idx  Entry index
+ */
+static void ps_table_use_entry(uint32_t idx)
+{
+#if PS_OBJ_TABLE_INDEX
+    ps_table_index_add(idx);
+#endif
+
+    ps_table_mark_dirty(idx);
+}
+
 /**
  * \brief Gets free index in the table
  *
@@ -802,18 +1140,37 @@ __STATIC_INLINE psa_status_t ps_table_free_idx(uint32_t idx_num,
 {
     uint32_t i;
     uint32_t last_free = 0;
-    struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+#if PS_OBJ_TABLE_INDEX
+    uint32_t w;
+    uint32_t word;
+#endif
 
     if (idx_num == 0) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if PS_OBJ_TABLE_INDEX
+    /* Skip 32 entries at a time while none of them is free */
+    for (w = 0; w < PS_OBJ_TABLE_BITMAP_WORDS && idx_num > 0; w++) {
+        word = ps_obj_table_ctx.free_entries[w];
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+        word &= ~ps_obj_table_ctx.saved_entries[w];
+#endif
+        for (i = w * 32; word != 0 && idx_num > 0; i++, word >>= 1) {
+            if (word & 1U) {
+                last_free = i;
+                idx_num--;
+            }
+        }
+    }
+#else
     for (i = 0; i < PS_OBJ_TABLE_ENTRIES && idx_num > 0; i++) {
-        if (p_table->obj_db[i].uid == TFM_PS_INVALID_UID) {
+        if (ps_table_entry_is_free(i)) {
             last_free = i;
             idx_num--;
         }
     }
+#endif /* PS_OBJ_TABLE_INDEX */
 
     if (idx_num != 0) {
         return PSA_ERROR_INSUFFICIENT_STORAGE;
@@ -831,9 +1188,17 @@ __STATIC_INLINE psa_status_t ps_table_free_idx(uint32_t idx_num,
  */
 static void ps_table_delete_entry(uint32_t idx)
 {
+#if PS_OBJ_TABLE_INDEX
+    if (ps_obj_table_ctx.obj_table.obj_db[idx].uid != TFM_PS_INVALID_UID) {
+        ps_table_index_remove(idx);
+    }
+#endif
+
     /* Initialise object table entry structure */
     (void)memset(&ps_obj_table_ctx.obj_table.obj_db[idx],
                  PS_DEFAULT_EMPTY_BUFF_VAL, PS_OBJECTS_TABLE_ENTRY_SIZE);
+
+    ps_table_mark_dirty(idx);
 }
 
 psa_status_t ps_object_table_create(void)
@@ -857,6 +1222,10 @@ psa_status_t ps_object_table_create(void)
 
     p_table->version = PS_OBJECT_SYSTEM_VERSION;
 
+#if PS_OBJ_TABLE_INDEX
+    ps_table_index_rebuild();
+#endif
+
     /* Save object table contents */
     return ps_object_table_save_table(p_table);
 }
@@ -903,6 +1272,25 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
         return err;
     }
 
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    /* The entries in use are the ones of the last saved table */
+    (void)memset(ps_obj_table_ctx.dirty_entries, 0,
+                 sizeof(ps_obj_table_ctx.dirty_entries));
+    (void)memset(ps_obj_table_ctx.saved_entries, 0,
+                 sizeof(ps_obj_table_ctx.saved_entries));
+    ps_obj_table_ctx.pending_updates = 0;
+
+    for (uint32_t i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        if (ps_obj_table_ctx.obj_table.obj_db[i].uid != TFM_PS_INVALID_UID) {
+            PS_OBJ_TABLE_BIT_SET(ps_obj_table_ctx.saved_entries, i);
+        }
+    }
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+
+#if PS_OBJ_TABLE_INDEX
+    ps_table_index_rebuild();
+#endif
+
     /* Remove the old object table file */
     err = psa_its_remove(PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table));
     if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
@@ -940,6 +1328,19 @@ psa_status_t ps_object_table_get_free_fid(uint32_t fid_num,
     uint32_t idx;
 
     err = ps_table_free_idx(fid_num, &idx);
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    if (err == PSA_ERROR_INSUFFICIENT_STORAGE) {
+        /* The entries freed by the pending updates can only be reused once
+         * the table is saved.
+         */
+        err = ps_object_table_flush();
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = ps_table_free_idx(fid_num, &idx);
+    }
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -996,6 +1397,7 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
     idx = PS_OBJECT_FS_ID_TO_IDX(obj_tbl_info->fid);
     p_table->obj_db[idx].uid = uid;
     p_table->obj_db[idx].client_id = client_id;
+    ps_table_use_entry(idx);
 
     /* Add new object information */
 #ifdef PS_ENCRYPTION
@@ -1005,15 +1407,16 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
     p_table->obj_db[idx].version = obj_tbl_info->version;
 #endif
 
-    err = ps_object_table_save_table(p_table);
+    err = ps_object_table_update(p_table);
     if (err != PSA_SUCCESS) {
+        ps_table_delete_entry(idx);
+
         if (backup_entry.uid != TFM_PS_INVALID_UID) {
             /* Rollback the change in the table */
             (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
                          PS_OBJECTS_TABLE_ENTRY_SIZE);
+            ps_table_use_entry(backup_idx);
         }
-
-        ps_table_delete_entry(idx);
     }
 
     return err;
@@ -1070,11 +1473,12 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
 
     ps_table_delete_entry(backup_idx);
 
-    err = ps_object_table_save_table(p_table);
+    err = ps_object_table_update(p_table);
     if (err != PSA_SUCCESS) {
        /* Rollback the change in the table */
        (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
                     PS_OBJECTS_TABLE_ENTRY_SIZE);
+       ps_table_use_entry(backup_idx);
     }
 
     return err;
@@ -1082,7 +1486,44 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
 
 psa_status_t ps_object_table_delete_old_table(void)
 {
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    /* The old table is removed when the table is saved */
+    return PSA_SUCCESS;
+#else
     uint32_t table_id = PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table);
 
     return psa_its_remove(table_id);
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+}
+
+psa_status_t ps_object_table_delete_old_object(uint32_t fid)
+{
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+    psa_status_t err;
+
+    /* The last saved table may still refer to the file, in which case it is
+     * removed when the table is next saved.
+     */
+    if (PS_OBJ_TABLE_BIT_IS_SET(ps_obj_table_ctx.saved_entries,
+                                PS_OBJECT_FS_ID_TO_IDX(fid))) {
+        return PSA_SUCCESS;
+    }
+
+    /* The file is already gone if the save was done by this update */
+    err = psa_its_remove(fid);
+    if (err == PSA_ERROR_DOES_NOT_EXIST) {
+        return PSA_SUCCESS;
+    }
+
+    return err;
+#else
+    return psa_its_remove(fid);
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+}
+
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+void ps_object_table_get_stats(struct ps_obj_table_stats_t *stats)
+{
+    *stats = ps_obj_table_ctx.stats;
 }
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
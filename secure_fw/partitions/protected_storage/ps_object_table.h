@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 
+#include "config_tfm.h"
 #include "psa/protected_storage.h"
 
 #ifdef __cplusplus
@@ -30,6 +31,21 @@ struct ps_obj_table_info_t {
 #endif
 };
 
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+/*!
+ * \struct ps_obj_table_stats_t
+ *
+ * \brief Object table write-back statistics.
+ */
+struct ps_obj_table_stats_t {
+    uint32_t saves;          /*!< Number of times the table was saved */
+    uint32_t saves_avoided;  /*!< Number of updates which did not save the
+                              *   table, as they were coalesced into a later
+                              *   save
+                              */
+};
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+
 /**
  * \brief Creates object table.
  *
@@ -130,6 +146,28 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
  */
 psa_status_t ps_object_table_delete_old_table(void);
 
+/**
+ * \brief Deletes the file of an object which is no longer in the object
+ *        table from the persistent area.
+ *
+ * \param[in] fid  File ID of the object
+ *
+ * \note With PS_OBJ_TABLE_WRITE_BACK_UPDATES greater than 1, the file is kept
+ *       until the table is saved if the last saved table still refers to it.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t ps_object_table_delete_old_object(uint32_t fid);
+
+#if PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1
+/**
+ * \brief Gets the object table write-back statistics.
+ *
+ * \param[out] stats  Pointer to the location to store the statistics
+ */
+void ps_object_table_get_stats(struct ps_obj_table_stats_t *stats);
+#endif /* PS_OBJ_TABLE_WRITE_BACK_UPDATES > 1 */
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,21 +10,70 @@
 void *memcpy(void *dest, const void *src, size_t n)
 {
     union composite_addr_t p_dst, p_src;
+    uint32_t shift, word_lo, word_hi;
 
     p_dst.uint_addr = (uintptr_t)dest;
     p_src.uint_addr = (uintptr_t)src;
 
-    /* Byte copy for unaligned address. check the last bit of address. */
-    while (n && (ADDR_WORD_UNALIGNED(p_dst.uint_addr) ||
-                 ADDR_WORD_UNALIGNED(p_src.uint_addr))) {
+    /* Byte copy until destination is aligned. */
+    while (n && ADDR_WORD_UNALIGNED(p_dst.uint_addr)) {
         *p_dst.p_byte++ = *p_src.p_byte++;
         n--;
     }
 
-    /* Quad byte copy for aligned address. */
-    while (n >= sizeof(uint32_t)) {
-        *(p_dst.p_word)++ = *(p_src.p_word)++;
-        n -= sizeof(uint32_t);
+    if (!ADDR_WORD_UNALIGNED(p_src.uint_addr)) {
+#if CRT_MEM_UNROLL
+        /* Quad word copy for aligned addresses. */
+        while (n >= CRT_MEM_UNROLL_BYTES) {
+            p_dst.p_word[0] = p_src.p_word[0];
+            p_dst.p_word[1] = p_src.p_word[1];
+            p_dst.p_word[2] = p_src.p_word[2];
+            p_dst.p_word[3] = p_src.p_word[3];
+            p_dst.p_word += 4;
+            p_src.p_word += 4;
+            n -= CRT_MEM_UNROLL_BYTES;
+        }
+#endif
+
+        /* Quad byte copy for aligned addresses. */
+        while (n >= sizeof(uint32_t)) {
+            *(p_dst.p_word)++ = *(p_src.p_word)++;
+            n -= sizeof(uint32_t);
+        }
+    } else if (n >= sizeof(uint32_t)) {
+        /*
+         * Source is misaligned to destination. Read aligned source words and
+         * shift them into destination words.
+         */
+        shift = ADDR_WORD_OFFSET_BITS(p_src.uint_addr);
+        p_src.uint_addr -= shift / 8;
+        word_lo = *(p_src.p_word)++;
+
+#if CRT_MEM_UNROLL
+        while (n >= CRT_MEM_UNROLL_BYTES) {
+            word_hi = p_src.p_word[0];
+            p_dst.p_word[0] = WORD_MERGE(word_lo, word_hi, shift);
+            word_lo = p_src.p_word[1];
+            p_dst.p_word[1] = WORD_MERGE(word_hi, word_lo, shift);
+            word_hi = p_src.p_word[2];
+            p_dst.p_word[2] = WORD_MERGE(word_lo, word_hi, shift);
+            word_lo = p_src.p_word[3];
+            p_dst.p_word[3] = WORD_MERGE(word_hi, word_lo, shift);
+            p_dst.p_word += 4;
+            p_src.p_word += 4;
+            n -= CRT_MEM_UNROLL_BYTES;
+        }
+#endif
+
+        while (n >= sizeof(uint32_t)) {
+            word_hi = *(p_src.p_word)++;
+            *(p_dst.p_word)++ = WORD_MERGE(word_lo, word_hi, shift);
+            word_lo = word_hi;
+            n -= sizeof(uint32_t);
+        }
+
+        /* Rewind to the first source byte not copied yet. */
+        p_src.uint_addr -= sizeof(uint32_t) - shift / 8;
     }
 
     /* Byte copy for the remaining bytes. */
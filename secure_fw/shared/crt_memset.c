@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,14 +13,24 @@ void *memset(void *s, int c, size_t n)
     uint32_t pattern_word;
 
     p_mem.p_byte = (uint8_t *)s;
-    pattern_word = (((uint32_t)c) << 24) | (((uint32_t)c) << 16) |
-                   (((uint32_t)c) << 8) | ((uint32_t)c);
+    pattern_word = (((uint32_t)c) & 0xFF) * 0x01010101UL;
 
     while (n && ADDR_WORD_UNALIGNED(p_mem.uint_addr)) {
         *p_mem.p_byte++ = (uint8_t)c;
         n--;
     }
 
+#if CRT_MEM_UNROLL
+    while (n >= CRT_MEM_UNROLL_BYTES) {
+        p_mem.p_word[0] = pattern_word;
+        p_mem.p_word[1] = pattern_word;
+        p_mem.p_word[2] = pattern_word;
+        p_mem.p_word[3] = pattern_word;
+        p_mem.p_word += 4;
+        n -= CRT_MEM_UNROLL_BYTES;
+    }
+#endif
+
     while (n >= sizeof(uint32_t)) {
         *p_mem.p_word++ = pattern_word;
         n -= sizeof(uint32_t);
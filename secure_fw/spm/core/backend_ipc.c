@@ -410,6 +410,8 @@ psa_status_t backend_assert_signal(struct partition_t *p_pt, psa_signal_t signal
     p_pt->signals_asserted |= signal;
 
     if (p_pt->signals_asserted & p_pt->signals_waiting) {
+        /* Let the scheduler query the waiting thread again */
+        thrd_wake_up(&p_pt->thrd);
         ret = STATUS_NEED_SCHEDULE;
     }
     CRITICAL_SECTION_LEAVE(cs_signal);
@@ -16,6 +16,125 @@
 #include "tfm_psa_call_pack.h"
 #include "utilities.h"
 
+#if CONFIG_TFM_IOVEC_CHECK_CACHE_NUM > 0
+/* A memory region which has passed tfm_hal_memory_check() */
+struct iovec_check_entry_t {
+    uintptr_t boundary;         /* Boundary the region is checked against */
+    uintptr_t base;             /* Base address of the region */
+    size_t    size;             /* Size of the region, 0 if entry is free */
+    uint32_t  access_type;      /* Access types the region is checked for */
+};
+
+static struct iovec_check_entry_t
+                        iovec_check_cache[CONFIG_TFM_IOVEC_CHECK_CACHE_NUM];
+static uint32_t iovec_check_cache_next;     /* Next entry to be replaced */
+
+void spm_iovec_check_cache_invalidate(void)
+{
+    struct critical_section_t cs_cache = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_cache);
+    spm_memset(iovec_check_cache, 0, sizeof(iovec_check_cache));
+    iovec_check_cache_next = 0;
+    CRITICAL_SECTION_LEAVE(cs_cache);
+}
+
+/*
+ * Look up the region in the cache. A cached region covering the given one and
+ * checked for the same boundary is a hit if it was checked for at least the
+ * same READ/WRITE permissions. The other access type bits must match exactly.
+ * For example, TFM_HAL_ACCESS_NS selects the address space rather than grants
+ * a permission.
+ */
+static bool iovec_check_cache_lookup(uintptr_t boundary, uintptr_t base,
+                                     size_t size, uint32_t access_type)
+{
+    const struct iovec_check_entry_t *p_entry;
+    uint32_t i;
+
+    for (i = 0; i < CONFIG_TFM_IOVEC_CHECK_CACHE_NUM; i++) {
+        p_entry = &iovec_check_cache[i];
+
+        if ((p_entry->size != 0) &&
+            (p_entry->boundary == boundary) &&
+            ((p_entry->access_type & ~TFM_HAL_ACCESS_READWRITE) ==
+             (access_type & ~TFM_HAL_ACCESS_READWRITE)) &&
+            ((p_entry->access_type & access_type & TFM_HAL_ACCESS_READWRITE) ==
+             (access_type & TFM_HAL_ACCESS_READWRITE)) &&
+            (base >= p_entry->base) &&
+            (size <= p_entry->size) &&
+            ((base - p_entry->base) <= (p_entry->size - size))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Check a memory region referenced by a PSA call through the validation
+ * cache. The regions which pass the check are added into the cache.
+ */
+static FIH_RET_TYPE(enum tfm_hal_status_t) iovec_memory_check(
+                                           uintptr_t boundary, uintptr_t base,
+                                           size_t size, uint32_t access_type)
+{
+    struct critical_section_t cs_cache = CRITICAL_SECTION_STATIC_INIT;
+    struct iovec_check_entry_t *p_entry;
+    fih_int fih_rc = FIH_FAILURE;
+    bool hit;
+
+    if (size == 0) {
+        FIH_CALL(tfm_hal_memory_check, fih_rc,
+                 boundary, base, size, access_type);
+        FIH_RET(fih_rc);
+    }
+
+    CRITICAL_SECTION_ENTER(cs_cache);
+    hit = iovec_check_cache_lookup(boundary, base, size, access_type);
+    CRITICAL_SECTION_LEAVE(cs_cache);
+
+    if (hit) {
+        FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
+    }
+
+    FIH_CALL(tfm_hal_memory_check, fih_rc, boundary, base, size, access_type);
+    if (fih_eq(fih_rc, fih_int_encode(TFM_HAL_SUCCESS))) {
+        CRITICAL_SECTION_ENTER(cs_cache);
+        p_entry = &iovec_check_cache[iovec_check_cache_next];
+        p_entry->boundary    = boundary;
+        p_entry->base        = base;
+        p_entry->size        = size;
+        p_entry->access_type = access_type;
+        iovec_check_cache_next = (iovec_check_cache_next + 1) %
+                                 CONFIG_TFM_IOVEC_CHECK_CACHE_NUM;
+        CRITICAL_SECTION_LEAVE(cs_cache);
+    }
+
+    FIH_RET(fih_rc);
+}
+
+/*
+ * The memory accessible to a TrustZone NS agent depends on the non-secure MPU
+ * settings of the current NS thread, which SPM is not aware of. Always check
+ * the regions from it.
+ */
+#define SPM_MEMORY_CHECK(fih_rc, p_pt, base, size, access_type)               \
+    do {                                                                      \
+        if (IS_NS_AGENT_TZ((p_pt)->p_ldinf)) {                                \
+            FIH_CALL(tfm_hal_memory_check, fih_rc, (p_pt)->boundary,          \
+                     base, size, access_type);                                \
+        } else {                                                              \
+            FIH_CALL(iovec_memory_check, fih_rc, (p_pt)->boundary,            \
+                     base, size, access_type);                                \
+        }                                                                     \
+    } while (0)
+#else
+#define SPM_MEMORY_CHECK(fih_rc, p_pt, base, size, access_type)               \
+    FIH_CALL(tfm_hal_memory_check, fih_rc, (p_pt)->boundary,                  \
+             base, size, access_type)
+#endif /* CONFIG_TFM_IOVEC_CHECK_CACHE_NUM > 0 */
+
 psa_status_t spm_associate_call_params(struct connection_t *p_connection,
                                        uint32_t            ctrl_param,
                                        const psa_invec     *inptr,
@@ -58,9 +177,9 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * if the memory reference for the wrap input vector is invalid or not
      * readable.
      */
-    FIH_CALL(tfm_hal_memory_check, fih_rc,
-             curr_partition->boundary, (uintptr_t)inptr,
-             ivec_num * sizeof(psa_invec), TFM_HAL_ACCESS_READABLE | ns_access);
+    SPM_MEMORY_CHECK(fih_rc, curr_partition, (uintptr_t)inptr,
+                     ivec_num * sizeof(psa_invec),
+                     TFM_HAL_ACCESS_READABLE | ns_access);
     if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
@@ -73,9 +192,9 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * actual length later. It is a PROGRAMMER ERROR if the memory reference for
      * the wrap output vector is invalid or not read-write.
      */
-    FIH_CALL(tfm_hal_memory_check, fih_rc,
-             curr_partition->boundary, (uintptr_t)outptr,
-             ovec_num * sizeof(psa_outvec), TFM_HAL_ACCESS_READWRITE | ns_access);
+    SPM_MEMORY_CHECK(fih_rc, curr_partition, (uintptr_t)outptr,
+                     ovec_num * sizeof(psa_outvec),
+                     TFM_HAL_ACCESS_READWRITE | ns_access);
     if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
@@ -113,9 +232,9 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * memory reference was invalid or not readable.
      */
     for (i = 0; i < ivec_num; i++) {
-        FIH_CALL(tfm_hal_memory_check, fih_rc,
-                 curr_partition->boundary, (uintptr_t)ivecs_local[i].base,
-                 ivecs_local[i].len, TFM_HAL_ACCESS_READABLE | ns_access);
+        SPM_MEMORY_CHECK(fih_rc, curr_partition,
+                         (uintptr_t)ivecs_local[i].base, ivecs_local[i].len,
+                         TFM_HAL_ACCESS_READABLE | ns_access);
         if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
             return PSA_ERROR_PROGRAMMER_ERROR;
         }
@@ -136,9 +255,9 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * payload memory reference was invalid or not read-write.
      */
     for (i = 0; i < ovec_num; i++) {
-        FIH_CALL(tfm_hal_memory_check, fih_rc,
-                 curr_partition->boundary, (uintptr_t)ovecs_local[i].base,
-                 ovecs_local[i].len, TFM_HAL_ACCESS_READWRITE | ns_access);
+        SPM_MEMORY_CHECK(fih_rc, curr_partition,
+                         (uintptr_t)ovecs_local[i].base, ovecs_local[i].len,
+                         TFM_HAL_ACCESS_READWRITE | ns_access);
         if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
             return PSA_ERROR_PROGRAMMER_ERROR;
         }
@@ -82,7 +82,7 @@ psa_status_t spm_psa_connect_client_id_associated(struct connection_t **p_connec
      * protected.
      * Protection should be established after the context management is implemented.
      */
-    connection = spm_allocate_connection();
+    connection = spm_allocate_connection(client_id);
     if (!connection) {
         return PSA_ERROR_CONNECTION_BUSY;
     }
@@ -139,7 +139,11 @@ int32_t tfm_spm_partition_get_running_partition_id(void);
 /******************** Service handle management functions ********************/
 void spm_init_connection_space(void);
 
-struct connection_t *spm_allocate_connection(void);
+/*
+ * Allocate a connection for the given client. NULL is returned if no
+ * connection is available or the client has reached its quota.
+ */
+struct connection_t *spm_allocate_connection(int32_t client_id);
 
 psa_status_t spm_validate_connection(const struct connection_t *p_connection);
 
@@ -260,6 +264,17 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
                                        const psa_invec     *inptr,
                                        psa_outvec          *outptr);
 
+#if CONFIG_TFM_IOVEC_CHECK_CACHE_NUM > 0
+/**
+ * \brief                   Drop all the regions in the IOVEC validation
+ *                          cache. It shall be called once the isolation
+ *                          settings of any boundary are changed, i.e. once a
+ *                          partition is bound to its boundary or the platform
+ *                          updates the isolation settings.
+ */
+void spm_iovec_check_cache_invalidate(void);
+#endif
+
 /**
  * \brief                   Check the client version according to
  *                          version policy
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -22,17 +22,6 @@ TFM_POOL_DECLARE(connection_pool, sizeof(struct connection_t),
 
 /*********************** Connection handle conversion APIs *******************/
 
-#define CONVERSION_FACTOR_BITOFFSET    3
-#define CONVERSION_FACTOR_VALUE        (1 << CONVERSION_FACTOR_BITOFFSET)
-/* Set 32 as the maximum */
-#define CONVERSION_FACTOR_VALUE_MAX    0x20
-
-#if CONVERSION_FACTOR_VALUE > CONVERSION_FACTOR_VALUE_MAX
-#error "CONVERSION FACTOR OUT OF RANGE"
-#endif
-
-static uint32_t loop_index;
-
 /*
  * A connection instance connection_t allocated inside SPM is actually a memory
  * address among the connection pool. Return this connection to the client directly
@@ -40,65 +29,74 @@ static uint32_t loop_index;
  * connection into another handle value does not represent the memory address
  * to avoid exposing secure memory directly to clients.
  *
- * This function converts the connection instance into another value by scaling
- * the connection in pool offset, the converted value is named as a user handle.
+ * The handle carries the index of the connection in the pool and the
+ * generation of that pool slot. The generation is bumped each time the
+ * connection is freed, so that a stale handle of a freed connection no longer
+ * matches the slot once it is reused.
  *
  * The formula:
- *  handle =      (p_connection - POOL_START) * CONVERSION_FACTOR_VALUE +
- *                CLIENT_HANDLE_VALUE_MIN + loop_index
+ *  handle =      ((index << CONN_HANDLE_GEN_BITS) | generation) +
+ *                CLIENT_HANDLE_VALUE_MIN
  * where:
- *  CONVERSION_FACTOR_VALUE = 1 << CONVERSION_FACTOR_BITOFFSET, and should not
- *  exceed CONVERSION_FACTOR_VALUE_MAX.
- *
- *  p_connection    in RANGE[POOL_START, POOL_END]
+ *  index           in RANGE[0, CONFIG_TFM_CONN_HANDLE_MAX_NUM - 1]
+ *  generation      in RANGE[0, CONN_HANDLE_GEN_MASK]
  *  handle          in RANGE[CLIENT_HANDLE_VALUE_MIN, 0x3FFFFFFF]
- *  loop_index      in RANGE[0, CONVERSION_FACTOR_VALUE - 1]
- *
- *  note:
- *  loop_index is used to promise same connection instance is converted into
- *  different user handles in short time.
  */
+#define CONN_HANDLE_GEN_BITS           16
+#define CONN_HANDLE_GEN_MASK           ((1UL << CONN_HANDLE_GEN_BITS) - 1)
+
+/* Handles shall not reach the static handle indicator bit */
+#if CONFIG_TFM_CONN_HANDLE_MAX_NUM >= \
+    (1UL << (STATIC_HANDLE_INDICATOR_OFFSET - CONN_HANDLE_GEN_BITS))
+#error "CONFIG_TFM_CONN_HANDLE_MAX_NUM is too large to be encoded in handles."
+#endif
+
+/* Generation of each connection in the pool */
+static uint16_t conn_generation[CONFIG_TFM_CONN_HANDLE_MAX_NUM];
+
+#if (CONFIG_TFM_CONN_QUOTA_PER_PARTITION > 0) || \
+    (CONFIG_TFM_CONN_QUOTA_PER_NS_CLIENT > 0)
+#define CONN_QUOTA_ENABLED
+
+/* Client ID holding each connection. 0 if the connection is free. */
+static int32_t conn_client_id[CONFIG_TFM_CONN_HANDLE_MAX_NUM];
+#endif
+
 psa_handle_t connection_to_handle(struct connection_t *p_connection)
 {
-    psa_handle_t handle;
+    uint32_t index;
 
-    loop_index = (loop_index + 1) % CONVERSION_FACTOR_VALUE;
-    handle = (psa_handle_t)((((uintptr_t)p_connection -
-                  (uintptr_t)connection_pool) << CONVERSION_FACTOR_BITOFFSET) +
-                  CLIENT_HANDLE_VALUE_MIN + loop_index);
+    index = (uint32_t)tfm_pool_get_chunk_index(connection_pool, p_connection);
 
-    return handle;
+    return (psa_handle_t)(((index << CONN_HANDLE_GEN_BITS) |
+                           conn_generation[index]) + CLIENT_HANDLE_VALUE_MIN);
 }
 
 /*
  * This function converts a user handle into a corresponded connection instance.
- * The converted value is validated before returning, an invalid handle instance
- * is returned as NULL.
- *
- * The formula:
- *  p_connection =    ((handle - CLIENT_HANDLE_VALUE_MIN) /
- *                    CONVERSION_FACTOR_VALUE) + POOL_START
- * where:
- *  CONVERSION_FACTOR_VALUE = 1 << CONVERSION_FACTOR_BITOFFSET, and should not
- *  exceed CONVERSION_FACTOR_VALUE_MAX.
- *
- *  p_connection    in RANGE[POOL_START, POOL_END]
- *  handle          in RANGE[CLIENT_HANDLE_VALUE_MIN, 0x3FFFFFFF]
- *  loop_index      in RANGE[0, CONVERSION_FACTOR_VALUE - 1]
+ * An invalid handle, including a handle of a freed connection, is returned as
+ * NULL. The connection returned still needs to be validated by
+ * spm_validate_connection() to check that it is allocated.
  */
 struct connection_t *handle_to_connection(psa_handle_t handle)
 {
-    struct connection_t *p_connection;
+    uint32_t index, generation;
 
-    if (handle == PSA_NULL_HANDLE) {
+    if (handle < CLIENT_HANDLE_VALUE_MIN) {
         return NULL;
     }
 
-    p_connection = (struct connection_t *)((((uintptr_t)handle -
-                    CLIENT_HANDLE_VALUE_MIN) >> CONVERSION_FACTOR_BITOFFSET) +
-                    (uintptr_t)connection_pool);
+    index = ((uint32_t)handle - CLIENT_HANDLE_VALUE_MIN) >> CONN_HANDLE_GEN_BITS;
+    generation = ((uint32_t)handle - CLIENT_HANDLE_VALUE_MIN) &
+                 CONN_HANDLE_GEN_MASK;
 
-    return p_connection;
+    if ((index >= CONFIG_TFM_CONN_HANDLE_MAX_NUM) ||
+        (generation != conn_generation[index])) {
+        return NULL;
+    }
+
+    return (struct connection_t *)tfm_pool_get_chunk_data(connection_pool,
+                                                          index);
 }
 
 /* Service handle management functions */
@@ -112,10 +110,65 @@ void spm_init_connection_space(void)
     }
 }
 
-struct connection_t *spm_allocate_connection(void)
+#ifdef CONN_QUOTA_ENABLED
+/* Check whether the client holds as many connections as its quota allows */
+static bool connection_quota_reached(int32_t client_id)
 {
+    uint32_t quota, count = 0;
+    uint32_t i;
+
+    if (TFM_CLIENT_ID_IS_NS(client_id)) {
+        quota = CONFIG_TFM_CONN_QUOTA_PER_NS_CLIENT;
+    } else {
+        quota = CONFIG_TFM_CONN_QUOTA_PER_PARTITION;
+    }
+
+    if (quota == 0) {
+        return false;
+    }
+
+    for (i = 0; i < CONFIG_TFM_CONN_HANDLE_MAX_NUM; i++) {
+        if (conn_client_id[i] == client_id) {
+            count++;
+        }
+    }
+
+    return count >= quota;
+}
+#endif
+
+struct connection_t *spm_allocate_connection(int32_t client_id)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    struct connection_t *p_connection = NULL;
+#ifdef CONN_QUOTA_ENABLED
+    uint32_t index;
+#endif
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+#ifdef CONN_QUOTA_ENABLED
+    if (connection_quota_reached(client_id)) {
+        CRITICAL_SECTION_LEAVE(cs_assert);
+        return NULL;
+    }
+#else
+    (void)client_id;
+#endif
+
     /* Get buffer for handle list structure from handle pool */
-    return (struct connection_t *)tfm_pool_alloc(connection_pool);
+    p_connection = (struct connection_t *)tfm_pool_alloc(connection_pool);
+#ifdef CONN_QUOTA_ENABLED
+    if (p_connection != NULL) {
+        index = (uint32_t)tfm_pool_get_chunk_index(connection_pool,
+                                                   p_connection);
+        conn_client_id[index] = client_id;
+    }
+#endif
+
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    return p_connection;
 }
 
 psa_status_t spm_validate_connection(const struct connection_t *p_connection)
@@ -132,10 +185,20 @@ psa_status_t spm_validate_connection(const struct connection_t *p_connection)
 void spm_free_connection(struct connection_t *p_connection)
 {
     struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t index;
 
     SPM_ASSERT(p_connection != NULL);
 
     CRITICAL_SECTION_ENTER(cs_assert);
+
+    /* Invalidate the handles of this connection */
+    index = (uint32_t)tfm_pool_get_chunk_index(connection_pool, p_connection);
+    conn_generation[index] = (conn_generation[index] + 1) &
+                             CONN_HANDLE_GEN_MASK;
+#ifdef CONN_QUOTA_ENABLED
+    conn_client_id[index] = 0;
+#endif
+
     /* Back handle buffer to pool */
     tfm_pool_free(connection_pool, p_connection);
     CRITICAL_SECTION_LEAVE(cs_assert);
@@ -46,6 +46,10 @@
 static struct service_head_t services_listhead;
 struct service_t *stateless_services_ref_tbl[STATIC_HANDLE_NUM_LIMIT];
 
+/* Services indexed by the perfect hash of SID generated by manifest tool */
+static struct service_t *services_lookup_tbl[SERVICE_LOOKUP_TABLE_SIZE];
+static const uint16_t services_lookup_disp[] = SERVICE_LOOKUP_DISP_INIT;
+
 /* Partition management functions */
 
 /* This API is only used in IPC backend. */
@@ -110,15 +114,37 @@ struct connection_t *spm_get_handle_by_signal(struct partition_t *p_ptn,
 }
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
 
-const struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
+static uint32_t get_service_lookup_slot(uint32_t sid)
 {
-    struct service_t *p_prev, *p_curr;
+    uint32_t hash = SERVICE_LOOKUP_HASH(sid);
 
-    UNI_LIST_FOREACH_NODE_PREV(p_prev, p_curr, &services_listhead, next) {
-        if (p_curr->p_ldinf->sid == sid) {
-            UNI_LIST_MOVE_AFTER(&services_listhead, p_prev, p_curr, next);
-            return p_curr;
+    return SERVICE_LOOKUP_SLOT(hash,
+                               services_lookup_disp[SERVICE_LOOKUP_BUCKET(hash)]);
+}
+
+/* Index all the loaded services by SID. Panic if the slots collide. */
+static void build_service_lookup_tbl(void)
+{
+    struct service_t *p_service;
+    uint32_t slot;
+
+    UNI_LIST_FOREACH(p_service, &services_listhead, next) {
+        slot = get_service_lookup_slot(p_service->p_ldinf->sid);
+        if (services_lookup_tbl[slot]) {
+            tfm_core_panic();
         }
+        services_lookup_tbl[slot] = p_service;
+    }
+}
+
+const struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
+{
+    struct service_t *p_service;
+
+    /* Any SID unknown to manifest tool also lands on a slot. Check it. */
+    p_service = services_lookup_tbl[get_service_lookup_slot(sid)];
+    if (p_service && (p_service->p_ldinf->sid == sid)) {
+        return p_service;
     }
 
     return NULL;
@@ -256,7 +282,7 @@ psa_status_t spm_get_idle_connection(struct connection_t **p_connection,
          * Protection should be established after the context management is
          * implemented.
          */
-        connection = spm_allocate_connection();
+        connection = spm_allocate_connection(client_id);
         if (connection == NULL) {
             return PSA_ERROR_CONNECTION_BUSY;
         }
@@ -429,9 +455,16 @@ uint32_t tfm_spm_init(void)
             tfm_core_panic();
         }
 
+#if CONFIG_TFM_IOVEC_CHECK_CACHE_NUM > 0
+        /* The regions checked before the binding may no longer be valid */
+        spm_iovec_check_cache_invalidate();
+#endif
+
         backend_init_comp_assuredly(partition, service_setting);
     }
 
+    build_service_lookup_tbl();
+
 #if CONFIG_TFM_POST_PARTITION_INIT_HOOK == 1
     /*
      * Platform can use CONFIG_TFM_POST_PARTITION_INIT_HOOK option to add extra initialization
@@ -441,6 +474,11 @@ uint32_t tfm_spm_init(void)
     if (fih_not_eq(fih_rc, fih_int_encode(TFM_HAL_SUCCESS))) {
         tfm_core_panic();
     }
+
+#if CONFIG_TFM_IOVEC_CHECK_CACHE_NUM > 0
+    /* The hook may have changed the isolation settings of the boundaries */
+    spm_iovec_check_cache_invalidate();
+#endif
 #endif /* CONFIG_TFM_POST_PARTITION_INIT_HOOK == 1 */
 
     return backend_system_run();
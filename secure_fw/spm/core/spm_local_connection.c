@@ -79,8 +79,10 @@ void spm_init_connection_space(void)
      */
 }
 
-struct connection_t *spm_allocate_connection(void)
+struct connection_t *spm_allocate_connection(int32_t client_id)
 {
+    (void)client_id;
+
     return alloc_conn_from_stack_top();
 }
 
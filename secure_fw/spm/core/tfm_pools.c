@@ -95,6 +95,27 @@ void tfm_pool_free(struct tfm_pool_instance_t *pool, void *ptr)
 #endif
 }
 
+size_t tfm_pool_get_chunk_index(struct tfm_pool_instance_t *pool, void *data)
+{
+    struct tfm_pool_chunk_t *pchunk;
+
+    pchunk = TO_CONTAINER(data, struct tfm_pool_chunk_t, data);
+
+    return ((uintptr_t)pchunk - (uintptr_t)pool->chunks) /
+           (pool->chunksz + sizeof(struct tfm_pool_chunk_t));
+}
+
+void *tfm_pool_get_chunk_data(struct tfm_pool_instance_t *pool, size_t index)
+{
+    struct tfm_pool_chunk_t *pchunk;
+
+    pchunk = (struct tfm_pool_chunk_t *)
+             &pool->chunks[index * (pool->chunksz +
+                                    sizeof(struct tfm_pool_chunk_t))];
+
+    return &(pchunk->data);
+}
+
 bool is_valid_chunk_data_in_pool(struct tfm_pool_instance_t *pool,
                                  uint8_t *data)
 {
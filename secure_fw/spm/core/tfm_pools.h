@@ -85,6 +85,29 @@ void *tfm_pool_alloc(struct tfm_pool_instance_t *pool);
  */
 void tfm_pool_free(struct tfm_pool_instance_t *pool, void *ptr);
 
+/**
+ * \brief Get the index of a chunk in the pool from its data pointer.
+ *
+ * \param[in] pool              Pointer to memory pool declared by
+ *                              \ref TFM_POOL_DECLARE.
+ * \param[in] data              Chunk data pointer in the pool.
+ *
+ * \return The index of the chunk.
+ */
+size_t tfm_pool_get_chunk_index(struct tfm_pool_instance_t *pool, void *data);
+
+/**
+ * \brief Get the data pointer of a chunk in the pool from its index.
+ *
+ * \param[in] pool              Pointer to memory pool declared by
+ *                              \ref TFM_POOL_DECLARE.
+ * \param[in] index             Index of the chunk. It shall be less than the
+ *                              number of chunks in the pool.
+ *
+ * \return The data pointer of the chunk.
+ */
+void *tfm_pool_get_chunk_data(struct tfm_pool_instance_t *pool, size_t index);
+
 /**
  * \brief Checks whether a pointer points to a valid allocated chunk of data in
  *        the pool.
@@ -31,6 +31,7 @@ static void default_mailbox_reply(const void *owner, int32_t ret)
 static struct tfm_rpc_ops_t rpc_ops = {
     .handle_req = default_handle_req,
     .reply      = default_mailbox_reply,
+    .resume     = NULL,
 };
 
 uint32_t tfm_rpc_psa_framework_version(void)
@@ -91,6 +92,7 @@ int32_t tfm_rpc_register_ops(const struct tfm_rpc_ops_t *ops_ptr)
 
     rpc_ops.handle_req = ops_ptr->handle_req;
     rpc_ops.reply = ops_ptr->reply;
+    rpc_ops.resume = ops_ptr->resume;
 
     return TFM_RPC_SUCCESS;
 }
@@ -99,6 +101,7 @@ void tfm_rpc_unregister_ops(void)
 {
     rpc_ops.handle_req = default_handle_req;
     rpc_ops.reply = default_mailbox_reply;
+    rpc_ops.resume = NULL;
 }
 
 void tfm_rpc_client_call_handler(void)
@@ -121,4 +124,11 @@ void tfm_rpc_client_call_reply(void)
         handle->status = TFM_HANDLE_STATUS_IDLE;
     }
 }
+
+void tfm_rpc_client_call_resume(void)
+{
+    if (rpc_ops.resume) {
+        rpc_ops.resume();
+    }
+}
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
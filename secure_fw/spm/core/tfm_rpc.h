@@ -37,10 +37,13 @@
  * handle_req() - Handle PSA client call request from NSPE
  * reply()      - Reply PSA client call return result to NSPE. The parameter
  *                owner identifies the owner of the PSA client call.
+ * resume()     - Optional. Continue the work held back by reply(), once the
+ *                connection of the replied call is released.
  */
 struct tfm_rpc_ops_t {
     void (*handle_req)(void);
     void (*reply)(const void *owner, int32_t ret);
+    void (*resume)(void);
 };
 
 /**
@@ -160,6 +163,16 @@ void tfm_rpc_client_call_handler(void);
  * \param[in] void
  */
 void tfm_rpc_client_call_reply(void);
+
+/**
+ * \brief Continue the work held back by the last reply
+ *
+ * \note It must be called after \ref tfm_rpc_client_call_reply has returned,
+ *       so that the connection of the replied call can be used again.
+ *
+ * \param[in] void
+ */
+void tfm_rpc_client_call_resume(void);
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
 #endif /* TFM_PARTITION_NS_AGENT_MAILBOX */
 #endif /* __TFM_RPC_H__ */
@@ -20,11 +20,20 @@ struct thread_t *p_curr_thrd;
 
 /* Force ZERO in case ZI(bss) clear is missing. */
 static struct thread_t *p_thrd_head = NULL; /* Point to the first thread. */
-static struct thread_t *p_rnbl_head = NULL; /* Point to the first runnable. */
+
+/* First thread of each priority group in the priority sorted list. */
+static struct thread_t *p_grp_head[THRD_PRIOR_GROUP_NUM] = {NULL};
+
+/*
+ * Priority groups which may contain ready threads. A bit can be left set after
+ * the threads in the group are blocked, thrd_next() clears it then.
+ */
+static uint32_t rnbl_bitmap = 0;
 
 /* Define Macro to fetch global to support future expansion (PERCPU e.g.) */
 #define LIST_HEAD   p_thrd_head
-#define RNBL_HEAD   p_rnbl_head
+#define GRP_HEAD    p_grp_head
+#define RNBL_BITMAP rnbl_bitmap
 
 /* Callback function pointer for thread to query current state. */
 static thrd_query_state_t query_state_cb = (thrd_query_state_t)NULL;
@@ -36,33 +45,48 @@ void thrd_set_query_callback(thrd_query_state_t fn)
 
 struct thread_t *thrd_next(void)
 {
-    struct thread_t *p_thrd = RNBL_HEAD;
+    struct thread_t *p_thrd = NULL;
     uint32_t retval = 0;
+    uint32_t grp;
     struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
 
     CRITICAL_SECTION_ENTER(cs_signal);
     /*
-     * First runnable thread has highest priority since threads are
-     * sorted by priority.
+     * The first runnable thread in the highest priority group has highest
+     * priority since threads are sorted by priority.
      */
-    while (p_thrd) {
-        /* Change thread state if any signal changed */
-        p_thrd->state = query_state_cb(p_thrd, &retval);
-
-        if (p_thrd->state == THRD_STATE_RET_VAL_AVAIL) {
-            tfm_arch_set_context_ret_code(p_thrd->p_context_ctrl, retval);
-            p_thrd->state = THRD_STATE_RUNNABLE;
+    while (RNBL_BITMAP != 0) {
+        grp = __CLZ(RNBL_BITMAP);
+
+        for (p_thrd = GRP_HEAD[grp];
+             p_thrd && (THRD_PRIOR_GROUP(p_thrd->priority) == grp);
+             p_thrd = p_thrd->next) {
+            if (!(p_thrd->flags & THRD_FLAG_READY)) {
+                continue;
+            }
+
+            /* Change thread state if any signal changed */
+            p_thrd->state = query_state_cb(p_thrd, &retval);
+
+            if (p_thrd->state == THRD_STATE_RET_VAL_AVAIL) {
+                tfm_arch_set_context_ret_code(p_thrd->p_context_ctrl, retval);
+                p_thrd->state = THRD_STATE_RUNNABLE;
+            }
+
+            if (p_thrd->state == THRD_STATE_RUNNABLE) {
+                CRITICAL_SECTION_LEAVE(cs_signal);
+                return p_thrd;
+            }
+
+            /* Skip it until an event wakes it up */
+            p_thrd->flags &= ~THRD_FLAG_READY;
         }
 
-        if (p_thrd->state == THRD_STATE_RUNNABLE) {
-            break;
-        }
-
-        p_thrd = p_thrd->next;
+        RNBL_BITMAP &= ~THRD_PRIOR_GROUP_BIT(grp);
     }
     CRITICAL_SECTION_LEAVE(cs_signal);
 
-    return p_thrd;
+    return NULL;
 }
 
 static void insert_by_prior(struct thread_t **head, struct thread_t *node)
@@ -82,12 +106,23 @@ static void insert_by_prior(struct thread_t **head, struct thread_t *node)
     }
 }
 
+static void insert_grp_head(struct thread_t *node)
+{
+    uint32_t grp = THRD_PRIOR_GROUP(node->priority);
+
+    if ((GRP_HEAD[grp] == NULL) ||
+        (node->priority <= GRP_HEAD[grp]->priority)) {
+        GRP_HEAD[grp] = node;
+    }
+}
+
 void thrd_start(struct thread_t *p_thrd, thrd_fn_t fn, thrd_fn_t exit_fn, void *param)
 {
     SPM_ASSERT(p_thrd != NULL);
 
     /* Insert a new thread with priority */
     insert_by_prior(&LIST_HEAD, p_thrd);
+    insert_grp_head(p_thrd);
 
     tfm_arch_init_context(p_thrd->p_context_ctrl, (uintptr_t)fn, param,
                           (uintptr_t)exit_fn);
@@ -102,18 +137,21 @@ void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state)
 
     p_thrd->state = new_state;
 
-    /*
-     * Set first runnable thread as head to reduce enumerate
-     * depth while searching for a first runnable thread.
-     */
-    if ((p_thrd->state == THRD_STATE_RUNNABLE) &&
-        ((RNBL_HEAD == NULL) || (p_thrd->priority < RNBL_HEAD->priority))) {
-        RNBL_HEAD = p_thrd;
+    if (p_thrd->state == THRD_STATE_RUNNABLE) {
+        thrd_wake_up(p_thrd);
     } else {
-        RNBL_HEAD = LIST_HEAD;
+        p_thrd->flags &= ~THRD_FLAG_READY;
     }
 }
 
+void thrd_wake_up(struct thread_t *p_thrd)
+{
+    SPM_ASSERT(p_thrd != NULL);
+
+    p_thrd->flags |= THRD_FLAG_READY;
+    RNBL_BITMAP |= THRD_PRIOR_GROUP_BIT(THRD_PRIOR_GROUP(p_thrd->priority));
+}
+
 uint32_t thrd_start_scheduler(struct thread_t **ppth)
 {
     struct thread_t *pth = thrd_next();
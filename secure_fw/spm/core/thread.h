@@ -31,6 +31,17 @@
 #define THRD_PRIOR_LOW            0x7F
 #define THRD_PRIOR_LOWEST         0xFF
 
+/*
+ * Priorities are grouped into 32 levels for the ready bitmap, so that bit 31
+ * stands for the highest priority group and __CLZ() gives the group index.
+ */
+#define THRD_PRIOR_GROUP(prior)   ((uint32_t)(prior) >> 3)
+#define THRD_PRIOR_GROUP_NUM      32
+#define THRD_PRIOR_GROUP_BIT(grp) (1UL << (31 - (grp)))
+
+/* Flags */
+#define THRD_FLAG_READY           (1U << 0) /* The thread may be runnable */
+
 /* Error codes */
 #define THRD_SUCCESS              0
 #define THRD_ERR_GENERIC          1
@@ -106,7 +117,7 @@ extern struct thread_t *p_curr_thrd;
 void thrd_set_query_callback(thrd_query_state_t fn);
 
 /*
- * Set thread state, and updates the runnable head.
+ * Set thread state, and updates the ready bitmap.
  *
  * Parameters :
  *  p_thrd         -     Pointer of thread_t struct
@@ -114,6 +125,16 @@ void thrd_set_query_callback(thrd_query_state_t fn);
  */
 void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state);
 
+/*
+ * Mark a thread as ready, so that the next thrd_next() queries its state.
+ * It should be called when an event may have unblocked the thread, with the
+ * critical section held.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ */
+void thrd_wake_up(struct thread_t *p_thrd);
+
 /*
  * Prepare thread context with given info and insert it into schedulable list.
  *
@@ -129,7 +150,11 @@ void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state);
 void thrd_start(struct thread_t *p_thrd, thrd_fn_t fn, thrd_fn_t exit_fn, void *param);
 
 /*
- * Get the next thread to run in list.
+ * Get the next thread to run in list. Only the threads marked as ready are
+ * queried, starting from the highest priority group in the ready bitmap.
+ * A thread found blocked is unmarked until it is woken up again.
+ * tools/sched_bench checks the selection against the thread list order on
+ * the host.
  *
  * Return :
  *  Pointer of next thread to run.
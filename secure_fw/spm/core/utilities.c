@@ -18,6 +18,27 @@
 #include "backtrace.h"
 #endif
 
+#ifdef CONFIG_TFM_SPM_COPY_ENGINE
+void *spm_copy_engine_memcpy(void *dest, const void *src, size_t n)
+{
+    enum tfm_hal_status_t status;
+
+    if (n >= CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE) {
+        status = tfm_hal_copy_engine_memcpy(dest, src, n);
+        if (status == TFM_HAL_SUCCESS) {
+            return dest;
+        }
+
+        /* Memcpy can't return an error, so panic on engine failures */
+        if (status != TFM_HAL_ERROR_NOT_SUPPORTED) {
+            tfm_core_panic();
+        }
+    }
+
+    return memcpy(dest, src, n);
+}
+#endif
+
 void tfm_core_panic(void)
 {
     (void)fih_delay();
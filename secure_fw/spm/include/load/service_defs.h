@@ -40,6 +40,23 @@
 #define SERVICE_ENABLED_MM_IOVEC(flag)          \
     ((flag) & SERVICE_FLAG_MM_IOVEC)
 
+/*
+ * Service lookup by SID. The manifest tool generates a perfect hash of the
+ * SIDs of all the services into config_impl.h. A SID is hashed into a bucket,
+ * and the displacement of the bucket moves the SID to a slot of the lookup
+ * table that no other SID occupies.
+ * Keep the calculation the same as process_service_lookup() in
+ * tfm_parse_manifest_list.py. tools/service_lookup_bench checks both on the
+ * host.
+ */
+#define SERVICE_LOOKUP_TABLE_SIZE               (1UL << SERVICE_LOOKUP_TABLE_BITS)
+#define SERVICE_LOOKUP_HASH(sid)                \
+    ((uint32_t)(sid) * SERVICE_LOOKUP_HASH_MULT)
+#define SERVICE_LOOKUP_BUCKET(hash)             \
+    ((hash) >> (32 - SERVICE_LOOKUP_BUCKET_BITS))
+#define SERVICE_LOOKUP_SLOT(hash, disp)         \
+    ((((hash) >> 16) + (disp)) & (SERVICE_LOOKUP_TABLE_SIZE - 1))
+
 #define STRID_TO_STRING_PTR(strid)              (const char *)(strid)
 #define STRING_PTR_TO_STRID(str)                (uintptr_t)(str)
 
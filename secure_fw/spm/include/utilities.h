@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -28,6 +28,11 @@ void tfm_core_panic(void);
 #define M2S(m) STRINGIFY_EXPAND(m)
 
 /* Runtime memory operations forwarding */
+#if defined(CONFIG_TFM_SPM_COPY_ENGINE) && !defined(spm_memcpy)
+/* Offload large copies to the platform copy engine */
+#define spm_memcpy spm_copy_engine_memcpy
+#endif
+
 #ifndef spm_memcpy
 #define spm_memcpy memcpy
 #else
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host test and microbenchmark of the SPM copies offloaded to the platform
+ * copy engine.
+ *
+ * spm_memcpy() of SPM, built with CONFIG_TFM_SPM_COPY_ENGINE, and memcpy() of
+ * the secure runtime library, which SPM falls back to, are built for the host
+ * over a simulated copy engine.
+ *
+ * The benchmark has the following modes:
+ *
+ * check: Copies buffers of sizes around CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE
+ *        at every word alignment, with the copy engine succeeding, rejecting
+ *        the regions and failing. It checks the bytes copied and around them,
+ *        which copies the engine is passed, and that SPM panics when the
+ *        engine fails.
+ * copy:  Reports the throughput of spm_memcpy() and of the CPU copies for a
+ *        few sizes and source alignments, and the copies passed to the copy
+ *        engine. The copy engine times are modelled, so the results of
+ *        spm_memcpy() beyond the threshold depend on the model.
+ *
+ * The number of copies for each size in copy mode is given by the iterations.
+ *
+ * Usage: copy_bench [check|copy] [iterations]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "copy_bench_platform.h"
+
+#include "config_tfm.h"
+#include "utilities.h"
+
+#define COPY_BENCH_DEFAULT_ITERATIONS 100000
+
+#define COPY_BENCH_MAX_SIZE \
+    ((4 * CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE) + 16384)
+
+/* Bytes checked around the destination */
+#define COPY_BENCH_GUARD              16
+
+#define COPY_BENCH_WORD_ALIGNMENTS    4
+
+/* memcpy() of the secure runtime library, renamed for the host */
+void *crt_memcpy(void *dest, const void *src, size_t n);
+
+/* A benchmark mode */
+struct copy_bench_mode_t {
+    const char *name;
+    int (*run)(uint32_t iterations);
+};
+
+static _Alignas(16) uint8_t src_buf[COPY_BENCH_MAX_SIZE + COPY_BENCH_GUARD];
+static _Alignas(16) uint8_t dst_buf[COPY_BENCH_MAX_SIZE +
+                                    (2 * COPY_BENCH_GUARD)];
+static _Alignas(16) uint8_t ref_buf[COPY_BENCH_MAX_SIZE +
+                                    (2 * COPY_BENCH_GUARD)];
+
+static uint32_t rand_state = 1;
+
+static uint32_t copy_bench_rand(void)
+{
+    /* Fixed seed xorshift, so that runs are reproducible */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static uint64_t copy_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static void copy_bench_fill(uint8_t *buf, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        buf[i] = (uint8_t)copy_bench_rand();
+    }
+}
+
+static const char *copy_bench_status_name(enum tfm_hal_status_t status)
+{
+    switch (status) {
+    case TFM_HAL_SUCCESS:
+        return "success";
+    case TFM_HAL_ERROR_NOT_SUPPORTED:
+        return "not supported";
+    default:
+        return "failure";
+    }
+}
+
+/*
+ * Copies n bytes from offset src_off of the source buffer to offset dst_off
+ * past the guard of the destination buffer with spm_memcpy(), the copy engine
+ * returning the given status.
+ */
+static int copy_bench_check_copy(size_t n, size_t dst_off, size_t src_off,
+                                 enum tfm_hal_status_t status)
+{
+    uint8_t *dest = &dst_buf[COPY_BENCH_GUARD + dst_off];
+    struct copy_bench_engine_stats_t stats;
+    /* Read after a panic, so kept in memory across longjmp() */
+    volatile bool is_panicked = false;
+    bool is_offloaded = (n >= CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE);
+    bool is_panic_expected = is_offloaded &&
+                             (status != TFM_HAL_SUCCESS) &&
+                             (status != TFM_HAL_ERROR_NOT_SUPPORTED);
+    void *ret = NULL;
+
+    copy_bench_fill(src_buf, sizeof(src_buf));
+    copy_bench_fill(dst_buf, sizeof(dst_buf));
+    (void)memcpy(ref_buf, dst_buf, sizeof(ref_buf));
+    if (!is_panic_expected) {
+        (void)memcpy(&ref_buf[COPY_BENCH_GUARD + dst_off], &src_buf[src_off],
+                     n);
+    }
+
+    copy_bench_engine_set_status(status);
+    copy_bench_engine_reset_stats();
+
+    if (setjmp(copy_bench_panic_env) == 0) {
+        ret = spm_memcpy(dest, &src_buf[src_off], n);
+    } else {
+        is_panicked = true;
+    }
+
+    stats = copy_bench_engine_get_stats();
+
+    if ((is_panicked != is_panic_expected) ||
+        (!is_panicked && (ret != dest)) ||
+        (stats.calls != (is_offloaded ? 1 : 0)) ||
+        (memcmp(dst_buf, ref_buf, sizeof(ref_buf)) != 0)) {
+        fprintf(stderr, "Copy of %zu bytes from offset %zu to offset %zu "
+                "failed with the copy engine returning %s\n", n, src_off,
+                dst_off, copy_bench_status_name(status));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int copy_bench_check(uint32_t iterations)
+{
+    static const enum tfm_hal_status_t statuses[] = {
+        TFM_HAL_SUCCESS,
+        TFM_HAL_ERROR_NOT_SUPPORTED,
+        TFM_HAL_ERROR_GENERIC,
+    };
+    const size_t min = CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE;
+    const size_t sizes[] = {
+        0, 1, 3, 4, 5, 15, 16, 17, 63, 64, 65,
+        (min > 0) ? (min - 1) : 0, min, min + 1, (4 * min) + 3,
+    };
+    size_t i, j, dst_off, src_off;
+    uint32_t nr_cases = 0;
+
+    (void)iterations;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (j = 0; j < sizeof(statuses) / sizeof(statuses[0]); j++) {
+            for (dst_off = 0; dst_off < COPY_BENCH_WORD_ALIGNMENTS;
+                 dst_off++) {
+                for (src_off = 0; src_off < COPY_BENCH_WORD_ALIGNMENTS;
+                     src_off++) {
+                    if (copy_bench_check_copy(sizes[i], dst_off, src_off,
+                                              statuses[j]) != EXIT_SUCCESS) {
+                        return EXIT_FAILURE;
+                    }
+                    nr_cases++;
+                }
+            }
+        }
+    }
+
+    copy_bench_engine_set_status(TFM_HAL_SUCCESS);
+
+    printf("%" PRIu32 " copies checked\n", nr_cases);
+
+    return EXIT_SUCCESS;
+}
+
+/* Throughput of a copy function in MB/s */
+static double copy_bench_throughput(void *(*copy)(void *, const void *,
+                                                  size_t),
+                                    size_t n, size_t src_off,
+                                    uint32_t iterations)
+{
+    uint64_t start = copy_bench_now_ns();
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++) {
+        (void)copy(&dst_buf[COPY_BENCH_GUARD], &src_buf[src_off], n);
+        __asm__ volatile("" ::: "memory");
+    }
+
+    return (double)n * iterations * 1e3 /
+           (double)(copy_bench_now_ns() - start);
+}
+
+static void *copy_bench_spm_memcpy(void *dest, const void *src, size_t n)
+{
+    return spm_memcpy(dest, src, n);
+}
+
+static int copy_bench_copy(uint32_t iterations)
+{
+    static const size_t sizes[] = {64, 256, 1024, 4096, 16384};
+    struct copy_bench_engine_stats_t stats;
+    double cpu_mbps, spm_mbps;
+    size_t i, src_off;
+
+    copy_bench_fill(src_buf, sizeof(src_buf));
+    copy_bench_engine_set_status(TFM_HAL_SUCCESS);
+
+    printf("%6s %8s %12s %12s %14s %14s\n", "bytes", "src off", "CPU MB/s",
+           "SPM MB/s", "engine/copy", "engine ns");
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (src_off = 0; src_off < 2; src_off++) {
+            cpu_mbps = copy_bench_throughput(crt_memcpy, sizes[i], src_off,
+                                             iterations);
+
+            copy_bench_engine_reset_stats();
+            spm_mbps = copy_bench_throughput(copy_bench_spm_memcpy, sizes[i],
+                                             src_off, iterations);
+            stats = copy_bench_engine_get_stats();
+
+            printf("%6zu %8zu %12.0f %12.0f %14.2f %14" PRIu64 "\n",
+                   sizes[i], src_off, cpu_mbps, spm_mbps,
+                   (double)stats.calls / (double)iterations,
+                   copy_bench_engine_time_ns(sizes[i]));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* Benchmark modes, the first one is the default */
+static const struct copy_bench_mode_t copy_bench_modes[] = {
+    {"check", copy_bench_check},
+    {"copy", copy_bench_copy},
+};
+
+#define COPY_BENCH_NUM_MODES \
+    (sizeof(copy_bench_modes) / sizeof(copy_bench_modes[0]))
+
+int main(int argc, char *argv[])
+{
+    size_t mode = 0;
+    uint32_t iterations = COPY_BENCH_DEFAULT_ITERATIONS;
+    int arg = 1;
+
+    if ((arg < argc) && ((argv[arg][0] < '0') || (argv[arg][0] > '9'))) {
+        for (mode = 0; mode < COPY_BENCH_NUM_MODES; mode++) {
+            if (strcmp(argv[arg], copy_bench_modes[mode].name) == 0) {
+                break;
+            }
+        }
+        arg++;
+    }
+
+    if (arg < argc) {
+        iterations = (uint32_t)strtoul(argv[arg], NULL, 0);
+        arg++;
+    }
+
+    if ((mode == COPY_BENCH_NUM_MODES) || (iterations == 0) ||
+        (arg < argc)) {
+        fprintf(stderr, "Usage: %s [check|copy] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("Copy engine threshold: %u bytes, %" PRIu32 " iterations\n",
+           (unsigned int)CONFIG_TFM_SPM_COPY_ENGINE_MIN_SIZE, iterations);
+
+    return copy_bench_modes[mode].run(iterations);
+}
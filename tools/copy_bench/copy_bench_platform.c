@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host implementations of the platform services the SPM copies depend on: the
+ * copy engine HAL and the system reset SPM panics with.
+ *
+ * The copy engine is a model of a DMA controller. A copy takes a setup time
+ * plus the time to move the bytes at a fixed bandwidth, whatever the host
+ * CPU takes to copy them. Both are set at build time with
+ * COPY_BENCH_ENGINE_SETUP_NS and COPY_BENCH_ENGINE_MB_PER_S.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "copy_bench_platform.h"
+
+#include "tfm_hal_platform.h"
+
+#ifndef COPY_BENCH_ENGINE_SETUP_NS
+#define COPY_BENCH_ENGINE_SETUP_NS      1000
+#endif
+
+#ifndef COPY_BENCH_ENGINE_MB_PER_S
+#define COPY_BENCH_ENGINE_MB_PER_S      1000
+#endif
+
+jmp_buf copy_bench_panic_env;
+
+static enum tfm_hal_status_t engine_status = TFM_HAL_SUCCESS;
+static struct copy_bench_engine_stats_t engine_stats;
+
+static uint64_t copy_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+void copy_bench_engine_set_status(enum tfm_hal_status_t status)
+{
+    engine_status = status;
+}
+
+struct copy_bench_engine_stats_t copy_bench_engine_get_stats(void)
+{
+    return engine_stats;
+}
+
+void copy_bench_engine_reset_stats(void)
+{
+    (void)memset(&engine_stats, 0, sizeof(engine_stats));
+}
+
+uint64_t copy_bench_engine_time_ns(size_t n)
+{
+    return COPY_BENCH_ENGINE_SETUP_NS +
+           ((uint64_t)n * 1000u / COPY_BENCH_ENGINE_MB_PER_S);
+}
+
+/* Platform copy engine */
+
+enum tfm_hal_status_t tfm_hal_copy_engine_memcpy(void *dest, const void *src,
+                                                 size_t n)
+{
+    uint64_t end = copy_bench_now_ns() + copy_bench_engine_time_ns(n);
+
+    engine_stats.calls++;
+    engine_stats.bytes += n;
+
+    if (engine_status != TFM_HAL_SUCCESS) {
+        return engine_status;
+    }
+
+    (void)memcpy(dest, src, n);
+
+    /* The copy is complete when the engine is done */
+    while (copy_bench_now_ns() < end) {
+        ;
+    }
+
+    return TFM_HAL_SUCCESS;
+}
+
+/* System reset and halt, on which SPM panics */
+
+void tfm_hal_system_reset(void)
+{
+    longjmp(copy_bench_panic_env, 1);
+}
+
+void tfm_hal_system_halt(void)
+{
+    longjmp(copy_bench_panic_env, 1);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __COPY_BENCH_PLATFORM_H__
+#define __COPY_BENCH_PLATFORM_H__
+
+#include <setjmp.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tfm_hal_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of copies and bytes handled by the simulated copy engine */
+struct copy_bench_engine_stats_t {
+    uint64_t calls;
+    uint64_t bytes;
+};
+
+/**
+ * \brief Sets the status the simulated copy engine returns. It only copies
+ *        the memory if the status is TFM_HAL_SUCCESS.
+ */
+void copy_bench_engine_set_status(enum tfm_hal_status_t status);
+
+/**
+ * \brief Returns the number of copies and bytes passed to the simulated copy
+ *        engine since the last reset, whatever the status it returned.
+ */
+struct copy_bench_engine_stats_t copy_bench_engine_get_stats(void);
+
+/**
+ * \brief Resets the statistics of the simulated copy engine.
+ */
+void copy_bench_engine_reset_stats(void);
+
+/**
+ * \brief Returns the time the simulated copy engine takes to copy n bytes,
+ *        in nanoseconds.
+ */
+uint64_t copy_bench_engine_time_ns(size_t n);
+
+/**
+ * \brief Where SPM resumes when it panics, instead of resetting the system.
+ *        It is only used while a panic is expected.
+ */
+extern jmp_buf copy_bench_panic_env;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __COPY_BENCH_PLATFORM_H__ */
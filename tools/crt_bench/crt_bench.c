@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host differential fuzzer and benchmark of the memory functions of the
+ * secure runtime library.
+ *
+ * The memcpy(), memmove(), memset() and memcmp() of the secure runtime library
+ * are built for the host as crt_memcpy(), crt_memmove(), crt_memset() and
+ * crt_memcmp(), and compared against the functions of the C library.
+ *
+ * The benchmark has the following modes:
+ *
+ * fuzz:  Runs every function for every word alignment of each buffer and
+ *        every length up to CRT_BENCH_FUZZ_MAX_LEN. memmove() is also run for
+ *        every distance between the buffers up to the length plus a word in
+ *        both directions, which covers all the overlaps. memcmp() is also run
+ *        with a difference at every position, in both directions. Random
+ *        cases with longer buffers follow. The whole buffers, including the
+ *        bytes around the destination, and the returned values must match
+ *        those of the C library.
+ * bench: Reports the throughput of the secure runtime library and C library
+ *        functions for a few sizes and source alignments.
+ *
+ * The unrolled loops are selected by CRT_MEM_UNROLL at build time. The number
+ * of random cases, or of calls for each size in bench mode, is given by the
+ * iterations.
+ *
+ * Usage: crt_bench [fuzz|bench] [iterations]
+ */
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CRT_BENCH_DEFAULT_ITERATIONS 100000
+
+/* Longest buffer of the exhaustive cases, covering many unrolled iterations */
+#define CRT_BENCH_FUZZ_MAX_LEN       160
+
+/* Longest buffer of the random cases */
+#define CRT_BENCH_RANDOM_MAX_LEN     4096
+
+/* Bytes checked around the destination */
+#define CRT_BENCH_GUARD              16
+
+#define CRT_BENCH_BUF_SIZE \
+    (3 * CRT_BENCH_RANDOM_MAX_LEN + 4 * CRT_BENCH_GUARD)
+
+#define CRT_BENCH_WORD_ALIGNMENTS    4
+
+/* The secure runtime library functions, renamed for the host */
+void *crt_memcpy(void *dest, const void *src, size_t n);
+void *crt_memmove(void *dest, const void *src, size_t n);
+void *crt_memset(void *s, int c, size_t n);
+int crt_memcmp(const void *s1, const void *s2, size_t n);
+
+/* A benchmark mode */
+struct crt_bench_mode_t {
+    const char *name;
+    int (*run)(uint32_t iterations);
+};
+
+/* Buffers run through the secure runtime library and the C library */
+static _Alignas(16) uint8_t crt_buf[CRT_BENCH_BUF_SIZE];
+static _Alignas(16) uint8_t ref_buf[CRT_BENCH_BUF_SIZE];
+
+static uint32_t rand_state = 1;
+
+/* Number of cases checked for each function */
+static uint64_t nr_memcpy_cases;
+static uint64_t nr_memmove_cases;
+static uint64_t nr_memset_cases;
+static uint64_t nr_memcmp_cases;
+
+static uint32_t crt_bench_rand(void)
+{
+    /* Fixed seed xorshift, so that runs are reproducible */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static uint64_t crt_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/* Fills both buffers with the same random bytes */
+static void crt_bench_fill(size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        crt_buf[i] = (uint8_t)crt_bench_rand();
+    }
+    memcpy(ref_buf, crt_buf, size);
+}
+
+static int crt_bench_fail(const char *func, size_t dst, size_t src, size_t len)
+{
+    fprintf(stderr, "%s mismatch: destination offset %zu, source offset %zu, "
+            "length %zu\n", func, dst, src, len);
+
+    return EXIT_FAILURE;
+}
+
+/*
+ * Copies len bytes from offset src to offset dst of the buffers, which must
+ * not overlap for memcpy(). The first size bytes of the buffers are checked.
+ */
+static int crt_bench_check_copy(const char *func, size_t dst, size_t src,
+                                size_t len, size_t size)
+{
+    void *crt_ret, *ref_ret;
+
+    if (strcmp(func, "memcpy") == 0) {
+        crt_ret = crt_memcpy(&crt_buf[dst], &crt_buf[src], len);
+        ref_ret = memcpy(&ref_buf[dst], &ref_buf[src], len);
+        nr_memcpy_cases++;
+    } else {
+        crt_ret = crt_memmove(&crt_buf[dst], &crt_buf[src], len);
+        ref_ret = memmove(&ref_buf[dst], &ref_buf[src], len);
+        nr_memmove_cases++;
+    }
+
+    if (((uint8_t *)crt_ret - crt_buf != (uint8_t *)ref_ret - ref_buf) ||
+        (memcmp(crt_buf, ref_buf, size) != 0)) {
+        return crt_bench_fail(func, dst, src, len);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int crt_bench_check_memset(size_t dst, int c, size_t len, size_t size)
+{
+    void *crt_ret, *ref_ret;
+
+    crt_ret = crt_memset(&crt_buf[dst], c, len);
+    ref_ret = memset(&ref_buf[dst], c, len);
+    nr_memset_cases++;
+
+    if (((uint8_t *)crt_ret - crt_buf != (uint8_t *)ref_ret - ref_buf) ||
+        (memcmp(crt_buf, ref_buf, size) != 0)) {
+        return crt_bench_fail("memset", dst, 0, len);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Compares len bytes at offsets s1 and s2 of the buffer, after making the
+ * byte at position diff of s2 greater or lower by delta. diff equal to len
+ * leaves both equal.
+ */
+static int crt_bench_check_memcmp(size_t s1, size_t s2, size_t len,
+                                  size_t diff, int delta)
+{
+    int crt_ret, ref_ret;
+
+    memcpy(&crt_buf[s2], &crt_buf[s1], len);
+    if (diff < len) {
+        crt_buf[s2 + diff] = (uint8_t)(crt_buf[s2 + diff] + delta);
+    }
+
+    crt_ret = crt_memcmp(&crt_buf[s1], &crt_buf[s2], len);
+    ref_ret = memcmp(&crt_buf[s1], &crt_buf[s2], len);
+    nr_memcmp_cases++;
+
+    /* Keep both buffers the same */
+    memcpy(&ref_buf[s2], &crt_buf[s2], len);
+
+    /* Only the sign of the result is specified */
+    if (((crt_ret > 0) != (ref_ret > 0)) || ((crt_ret < 0) != (ref_ret < 0))) {
+        return crt_bench_fail("memcmp", s1, s2, len);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int crt_bench_fuzz_exhaustive(void)
+{
+    size_t len, dst, src, pos, size;
+    ptrdiff_t dist;
+    int c;
+
+    for (len = 0; len <= CRT_BENCH_FUZZ_MAX_LEN; len++) {
+        for (dst = 0; dst < CRT_BENCH_WORD_ALIGNMENTS; dst++) {
+            /* Distinct buffers, the source after the destination */
+            for (src = 0; src < CRT_BENCH_WORD_ALIGNMENTS; src++) {
+                pos = (2 * CRT_BENCH_GUARD) + CRT_BENCH_FUZZ_MAX_LEN + 4 +
+                      src;
+                size = pos + len + CRT_BENCH_GUARD;
+                crt_bench_fill(size);
+                if ((crt_bench_check_copy("memcpy", CRT_BENCH_GUARD + dst,
+                                          pos, len, size) != EXIT_SUCCESS) ||
+                    (crt_bench_check_copy("memmove", CRT_BENCH_GUARD + dst,
+                                          pos, len, size) != EXIT_SUCCESS)) {
+                    return EXIT_FAILURE;
+                }
+            }
+
+            /* Source before, overlapping or after the destination */
+            size = (2 * CRT_BENCH_GUARD) + (3 * CRT_BENCH_FUZZ_MAX_LEN) + 16;
+            crt_bench_fill(size);
+            for (dist = -(ptrdiff_t)(len + 4); dist <= (ptrdiff_t)(len + 4);
+                 dist++) {
+                pos = CRT_BENCH_GUARD + CRT_BENCH_FUZZ_MAX_LEN + 8 + dst;
+                if (crt_bench_check_copy("memmove", pos, pos + dist, len,
+                                         size) != EXIT_SUCCESS) {
+                    return EXIT_FAILURE;
+                }
+            }
+
+            /* Values beyond a byte only use their low byte */
+            size = (2 * CRT_BENCH_GUARD) + CRT_BENCH_FUZZ_MAX_LEN + 4;
+            crt_bench_fill(size);
+            for (c = -1; c <= 0x1A5; c += 0xD3) {
+                if (crt_bench_check_memset(CRT_BENCH_GUARD + dst, c, len,
+                                           size) != EXIT_SUCCESS) {
+                    return EXIT_FAILURE;
+                }
+            }
+
+            /* Equal buffers, and a difference at each position */
+            crt_bench_fill(2 * (CRT_BENCH_FUZZ_MAX_LEN + 8));
+            for (src = 0; src < CRT_BENCH_WORD_ALIGNMENTS; src++) {
+                for (pos = 0; pos <= len; pos++) {
+                    if ((crt_bench_check_memcmp(dst,
+                                                CRT_BENCH_FUZZ_MAX_LEN + 8 +
+                                                src, len, pos,
+                                                1) != EXIT_SUCCESS) ||
+                        (crt_bench_check_memcmp(dst,
+                                                CRT_BENCH_FUZZ_MAX_LEN + 8 +
+                                                src, len, pos,
+                                                -1) != EXIT_SUCCESS)) {
+                        return EXIT_FAILURE;
+                    }
+                }
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int crt_bench_fuzz_random(uint32_t iterations)
+{
+    size_t len, dst, src, pos, size;
+    uint32_t i;
+    int ret;
+
+    size = CRT_BENCH_BUF_SIZE;
+
+    for (i = 0; i < iterations; i++) {
+        /* Refresh the contents once in a while, memset() wipes them */
+        if ((i % 256) == 0) {
+            crt_bench_fill(size);
+        }
+
+        len = crt_bench_rand() % (CRT_BENCH_RANDOM_MAX_LEN + 1);
+        dst = CRT_BENCH_GUARD + CRT_BENCH_RANDOM_MAX_LEN +
+              (crt_bench_rand() % (CRT_BENCH_RANDOM_MAX_LEN + 1));
+
+        switch (i % 4) {
+        case 0:
+            /* Source in the first third, destination in the others */
+            src = CRT_BENCH_GUARD +
+                  (crt_bench_rand() % (CRT_BENCH_RANDOM_MAX_LEN - len + 1));
+            ret = crt_bench_check_copy("memcpy", dst, src, len, size);
+            break;
+        case 1:
+            /* Source anywhere, possibly overlapping the destination */
+            src = CRT_BENCH_GUARD +
+                  (crt_bench_rand() % ((2 * CRT_BENCH_RANDOM_MAX_LEN) + 1));
+            ret = crt_bench_check_copy("memmove", dst, src, len, size);
+            break;
+        case 2:
+            ret = crt_bench_check_memset(dst, (int)crt_bench_rand(), len,
+                                         size);
+            break;
+        default:
+            /* First buffer in the first two thirds, second in the last */
+            src = CRT_BENCH_GUARD + (2 * CRT_BENCH_RANDOM_MAX_LEN) +
+                  (crt_bench_rand() % (CRT_BENCH_RANDOM_MAX_LEN - len + 1));
+            pos = crt_bench_rand() % (len + 1);
+            ret = crt_bench_check_memcmp(dst - CRT_BENCH_RANDOM_MAX_LEN, src,
+                                         len, pos,
+                                         (crt_bench_rand() & 1) ? 1 : -1);
+            if (ret == EXIT_SUCCESS) {
+                ret = (memcmp(crt_buf, ref_buf, size) == 0) ?
+                      EXIT_SUCCESS : EXIT_FAILURE;
+            }
+            break;
+        }
+
+        if (ret != EXIT_SUCCESS) {
+            return ret;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int crt_bench_fuzz(uint32_t iterations)
+{
+    if ((crt_bench_fuzz_exhaustive() != EXIT_SUCCESS) ||
+        (crt_bench_fuzz_random(iterations) != EXIT_SUCCESS)) {
+        return EXIT_FAILURE;
+    }
+
+    printf("%10s %12s\n", "function", "cases");
+    printf("%10s %12" PRIu64 "\n", "memcpy", nr_memcpy_cases);
+    printf("%10s %12" PRIu64 "\n", "memmove", nr_memmove_cases);
+    printf("%10s %12" PRIu64 "\n", "memset", nr_memset_cases);
+    printf("%10s %12" PRIu64 "\n", "memcmp", nr_memcmp_cases);
+
+    return EXIT_SUCCESS;
+}
+
+/* Throughput of a function in MB/s */
+#define CRT_BENCH_THROUGHPUT(call, len, iterations, mbps)                    \
+    do {                                                                     \
+        uint64_t _start = crt_bench_now_ns();                                \
+        uint32_t _i;                                                         \
+        for (_i = 0; _i < (iterations); _i++) {                              \
+            call;                                                            \
+            __asm__ volatile("" ::: "memory");                               \
+        }                                                                    \
+        (mbps) = (double)(len) * (iterations) * 1e3 /                        \
+                 (double)(crt_bench_now_ns() - _start);                      \
+    } while (0)
+
+static int crt_bench_bench(uint32_t iterations)
+{
+    static const size_t sizes[] = {16, 64, 256, 1024, 4096};
+    uint8_t *dst = &crt_buf[CRT_BENCH_GUARD];
+    uint8_t *src_base = &ref_buf[CRT_BENCH_GUARD];
+    size_t i, off, len;
+    double crt_mbps, ref_mbps;
+    volatile int cmp;
+
+    crt_bench_fill(CRT_BENCH_BUF_SIZE);
+
+    printf("%8s %6s %8s %12s %12s\n", "function", "bytes", "src off",
+           "CRT MB/s", "libc MB/s");
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        len = sizes[i];
+
+        for (off = 0; off < 2; off++) {
+            CRT_BENCH_THROUGHPUT(crt_memcpy(dst, src_base + off, len),
+                                 len, iterations, crt_mbps);
+            CRT_BENCH_THROUGHPUT(memcpy(dst, src_base + off, len),
+                                 len, iterations, ref_mbps);
+            printf("%8s %6zu %8zu %12.0f %12.0f\n", "memcpy", len, off,
+                   crt_mbps, ref_mbps);
+        }
+
+        /* Overlapping move towards higher addresses, copied backwards */
+        CRT_BENCH_THROUGHPUT(crt_memmove(dst + 1, dst, len),
+                             len, iterations, crt_mbps);
+        CRT_BENCH_THROUGHPUT(memmove(dst + 1, dst, len),
+                             len, iterations, ref_mbps);
+        printf("%8s %6zu %8d %12.0f %12.0f\n", "memmove", len, -1,
+               crt_mbps, ref_mbps);
+
+        CRT_BENCH_THROUGHPUT(crt_memset(dst, 0, len),
+                             len, iterations, crt_mbps);
+        CRT_BENCH_THROUGHPUT(memset(dst, 0, len),
+                             len, iterations, ref_mbps);
+        printf("%8s %6zu %8s %12.0f %12.0f\n", "memset", len, "-",
+               crt_mbps, ref_mbps);
+
+        /* Equal buffers, so that the whole length is compared */
+        memcpy(dst, src_base, len);
+        CRT_BENCH_THROUGHPUT(cmp = crt_memcmp(dst, src_base, len),
+                             len, iterations, crt_mbps);
+        CRT_BENCH_THROUGHPUT(cmp = memcmp(dst, src_base, len),
+                             len, iterations, ref_mbps);
+        printf("%8s %6zu %8d %12.0f %12.0f\n", "memcmp", len, 0,
+               crt_mbps, ref_mbps);
+    }
+
+    (void)cmp;
+
+    return EXIT_SUCCESS;
+}
+
+/* Benchmark modes, the first one is the default */
+static const struct crt_bench_mode_t crt_bench_modes[] = {
+    {"fuzz", crt_bench_fuzz},
+    {"bench", crt_bench_bench},
+};
+
+#define CRT_BENCH_NUM_MODES \
+    (sizeof(crt_bench_modes) / sizeof(crt_bench_modes[0]))
+
+int main(int argc, char *argv[])
+{
+    size_t mode = 0;
+    uint32_t iterations = CRT_BENCH_DEFAULT_ITERATIONS;
+    int arg = 1;
+
+    if ((arg < argc) && ((argv[arg][0] < '0') || (argv[arg][0] > '9'))) {
+        for (mode = 0; mode < CRT_BENCH_NUM_MODES; mode++) {
+            if (strcmp(argv[arg], crt_bench_modes[mode].name) == 0) {
+                break;
+            }
+        }
+        arg++;
+    }
+
+    if (arg < argc) {
+        iterations = (uint32_t)strtoul(argv[arg], NULL, 0);
+        arg++;
+    }
+
+    if ((mode == CRT_BENCH_NUM_MODES) || (iterations == 0) || (arg < argc)) {
+        fprintf(stderr, "Usage: %s [fuzz|bench] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("CRT_MEM_UNROLL: %d, %" PRIu32 " iterations\n",
+           CRT_MEM_UNROLL, iterations);
+
+    return crt_bench_modes[mode].run(iterations);
+}
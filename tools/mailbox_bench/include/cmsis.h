@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Barriers between the host threads which stand for the NSPE and SPE cores.
+ * The dcache is not emulated: __DCACHE_PRESENT is left undefined.
+ */
+
+#ifndef __CMSIS_H__
+#define __CMSIS_H__
+
+#include "cmsis_compiler.h"
+
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif /* __CMSIS_H__ */
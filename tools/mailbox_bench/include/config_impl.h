@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* SPM configuration seen by the SPE mailbox: the IPC backend, which replies
+ * to the PSA client calls asynchronously.
+ */
+
+#ifndef __CONFIG_IMPL_H__
+#define __CONFIG_IMPL_H__
+
+#define CONFIG_TFM_SPM_BACKEND_IPC                  1
+#define CONFIG_TFM_SPM_BACKEND_SFN                  0
+#define CONFIG_TFM_CONNECTION_BASED_SERVICE_API     0
+
+#endif /* __CONFIG_IMPL_H__ */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* The SPE mailbox runs in a single partition in the host mailbox benchmark */
+
+#ifndef __CURRENT_H__
+#define __CURRENT_H__
+
+#include <stdint.h>
+
+struct partition_t {
+    uintptr_t boundary;
+};
+
+extern struct partition_t mailbox_bench_partition;
+
+#define GET_CURRENT_COMPONENT()  (&mailbox_bench_partition)
+
+#endif /* __CURRENT_H__ */
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* SPM assertions abort the host mailbox benchmark */
+
+#ifndef __TFM_PRIV_ASSERT_H__
+#define __TFM_PRIV_ASSERT_H__
+
+#include <assert.h>
+
+#define SPM_ASSERT(cond) assert(cond)
+
+#endif /* __TFM_PRIV_ASSERT_H__ */
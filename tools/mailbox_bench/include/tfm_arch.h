@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* No architecture specific definition is used in the host mailbox benchmark */
+
+#ifndef __TFM_ARCH_H__
+#define __TFM_ARCH_H__
+
+#endif /* __TFM_ARCH_H__ */
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Memory check of the platform isolation HAL used by the SPE mailbox */
+
+#ifndef __TFM_HAL_ISOLATION_H__
+#define __TFM_HAL_ISOLATION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fih.h"
+
+/* Memory access attributes */
+#define TFM_HAL_ACCESS_READABLE         (1UL << 1)
+#define TFM_HAL_ACCESS_WRITABLE         (1UL << 2)
+#define TFM_HAL_ACCESS_NS               (1UL << 5)
+
+#define TFM_HAL_ACCESS_READWRITE  \
+        (TFM_HAL_ACCESS_READABLE | TFM_HAL_ACCESS_WRITABLE)
+
+fih_int tfm_hal_memory_check(uintptr_t boundary, uintptr_t base,
+                             size_t size, uint32_t access_type);
+
+#endif /* __TFM_HAL_ISOLATION_H__ */
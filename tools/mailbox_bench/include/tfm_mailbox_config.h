@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Mailbox build configuration. NUM_MAILBOX_QUEUE_SLOT and
+ * MAILBOX_RING_TRANSPORT are set by the benchmark CMakeLists.txt rather than
+ * generated from tfm_mailbox_config.h.in.
+ */
+
+#ifndef _TFM_MAILBOX_CONFIG_
+#define _TFM_MAILBOX_CONFIG_
+
+#ifndef NUM_MAILBOX_QUEUE_SLOT
+#define NUM_MAILBOX_QUEUE_SLOT              4
+#endif
+
+#endif /* _TFM_MAILBOX_CONFIG_ */
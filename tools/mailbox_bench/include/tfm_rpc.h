@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* The RPC interface of SPM used by the SPE mailbox, as declared by
+ * secure_fw/spm/core/tfm_rpc.h without the SPM internals. It is implemented by
+ * the simulated SPM of the host mailbox benchmark.
+ */
+
+#ifndef __TFM_RPC_H__
+#define __TFM_RPC_H__
+
+#include <stdint.h>
+
+#include "psa/client.h"
+#include "psa/service.h"
+#include "ffm/mailbox_agent_api.h"
+
+#define TFM_RPC_SUCCESS             (0)
+#define TFM_RPC_INVAL_PARAM         (INT32_MIN + 1)
+#define TFM_RPC_CONFLICT_CALLBACK   (INT32_MIN + 2)
+
+struct tfm_rpc_ops_t {
+    void (*handle_req)(void);
+    void (*reply)(const void *owner, int32_t ret);
+    void (*resume)(void);
+};
+
+uint32_t tfm_rpc_psa_framework_version(void);
+
+uint32_t tfm_rpc_psa_version(uint32_t sid);
+
+psa_status_t tfm_rpc_psa_call(psa_handle_t handle, uint32_t control,
+                              const struct client_params_t *params,
+                              const void *client_data_stateless);
+
+int32_t tfm_rpc_register_ops(const struct tfm_rpc_ops_t *ops_ptr);
+
+void tfm_rpc_unregister_ops(void);
+
+#endif /* __TFM_RPC_H__ */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* The SPE mailbox uses no SPM thread in the host mailbox benchmark */
+
+#ifndef __THREAD_H__
+#define __THREAD_H__
+
+#endif /* __THREAD_H__ */
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host stress test and benchmark of the NSPE and SPE mailboxes.
+ *
+ * The NSPE and SPE mailbox sources are built for the host. A thread stands for
+ * the SPE core: it runs the NS agent loop over a simulated SPM, which returns
+ * the handle of each call as its result. Another thread stands for the NSPE
+ * mailbox interrupt handler. Twice as many client threads as NSPE mailbox
+ * slots make PSA client calls concurrently, so that the NSPE slots are reused
+ * all the time. Each client checks that it gets the result of its own call.
+ *
+ * The benchmark has the following modes:
+ *
+ * calls:  SPM replies to the calls in the order they were passed in. It
+ *         reports the calls per second, the latency percentiles of a call, and
+ *         the replies per notification to NSPE.
+ * stress: Same as calls, except that both cores poll the mailbox all the time
+ *         instead of waiting for notifications. The producer and the consumer
+ *         of each ring then access it concurrently.
+ * ooo:    Same as calls, except that SPM replies to a random call among those
+ *         in progress. The SPE mailbox slots are then released in any order.
+ *
+ * The transport, bitmasks or rings, is selected at build time. The number of
+ * calls is given per client.
+ *
+ * Usage: mailbox_bench [calls|stress|ooo] [iterations]
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config_tfm.h"
+#include "mailbox_bench_platform.h"
+#include "tfm_multi_core.h"
+#include "tfm_ns_mailbox.h"
+
+#define MAILBOX_BENCH_DEFAULT_ITERATIONS 100000
+
+#define MAILBOX_BENCH_NUM_CLIENTS        (2 * NUM_MAILBOX_QUEUE_SLOT)
+
+/* The handle of a call identifies the client and the call */
+#define MAILBOX_BENCH_CALL_HANDLE(client, i) \
+    ((psa_handle_t)((((client) + 1) << 20) | ((i) & 0xFFFFF)))
+
+#ifdef MAILBOX_RING_TRANSPORT
+#define MAILBOX_BENCH_TRANSPORT          "rings"
+#else
+#define MAILBOX_BENCH_TRANSPORT          "bitmasks"
+#endif
+
+/* A benchmark mode */
+struct mailbox_bench_mode_t {
+    const char *name;
+    /* Picks the position of the call SPM replies to among nr_calls calls */
+    uint32_t (*pick_reply)(uint32_t nr_calls);
+    /* Whether the cores poll the mailbox rather than wait for notifications */
+    bool is_polling;
+};
+
+/* A client thread */
+struct mailbox_bench_client_t {
+    pthread_t thread;
+    uint32_t idx;
+    uint32_t iterations;
+    uint64_t *latencies;
+};
+
+static struct ns_mailbox_queue_t ns_queue;
+static const struct mailbox_bench_mode_t *bench_mode;
+static atomic_bool is_done;
+static uint32_t rand_state = 1;
+
+static uint64_t mailbox_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static int mailbox_bench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t mailbox_bench_reply_in_order(uint32_t nr_calls)
+{
+    (void)nr_calls;
+
+    return 0;
+}
+
+static uint32_t mailbox_bench_reply_out_of_order(uint32_t nr_calls)
+{
+    /* Fixed seed xorshift, so that runs are comparable */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state % nr_calls;
+}
+
+/* SPE core: the NS agent loop over the simulated SPM */
+static void *mailbox_bench_spe_thread(void *arg)
+{
+    (void)arg;
+
+    while (!atomic_load(&is_done)) {
+        if (mailbox_bench_spe_poll_doorbell() || bench_mode->is_polling) {
+            mailbox_bench_spm_handle_req();
+            if (bench_mode->is_polling) {
+                if (mailbox_bench_spm_nr_calls()) {
+                    mailbox_bench_spm_reply(
+                        bench_mode->pick_reply(mailbox_bench_spm_nr_calls()));
+                }
+                /* Let the other threads run on a host with few CPUs */
+                (void)sched_yield();
+            }
+        } else if (mailbox_bench_spm_nr_calls()) {
+            mailbox_bench_spm_reply(
+                    bench_mode->pick_reply(mailbox_bench_spm_nr_calls()));
+        } else {
+            mailbox_bench_spe_wait_doorbell();
+            mailbox_bench_spm_handle_req();
+        }
+    }
+
+    return NULL;
+}
+
+/* NSPE mailbox interrupt handler */
+static void *mailbox_bench_ns_isr_thread(void *arg)
+{
+    (void)arg;
+
+    while (!atomic_load(&is_done)) {
+        if (bench_mode->is_polling) {
+            (void)sched_yield();
+        } else {
+            mailbox_bench_ns_wait_doorbell();
+        }
+        (void)tfm_ns_mailbox_wake_reply_owner_isr();
+    }
+
+    return NULL;
+}
+
+/*
+ * A failed call leaves the other clients waiting for replies which may never
+ * come, so the benchmark stops at the first failure.
+ */
+static void *mailbox_bench_client_thread(void *arg)
+{
+    struct mailbox_bench_client_t *client = arg;
+    struct psa_client_params_t params;
+    int32_t reply;
+    int32_t ret;
+    uint64_t start;
+    uint32_t i;
+
+    (void)memset(&params, 0, sizeof(params));
+    params.psa_call_params.type = PSA_IPC_CALL;
+
+    for (i = 0; i < client->iterations; i++) {
+        params.psa_call_params.handle =
+                                MAILBOX_BENCH_CALL_HANDLE(client->idx, i);
+        reply = 0;
+
+        start = mailbox_bench_now_ns();
+        ret = tfm_ns_mailbox_client_call(MAILBOX_PSA_CALL, &params,
+                                         -(int32_t)(client->idx + 1), &reply);
+        client->latencies[i] = mailbox_bench_now_ns() - start;
+
+        if (ret != MAILBOX_SUCCESS) {
+            fprintf(stderr, "Client %" PRIu32 " call %" PRIu32 " failed: %d\n",
+                    client->idx, i, (int)ret);
+            exit(EXIT_FAILURE);
+        }
+
+        if (reply != params.psa_call_params.handle) {
+            fprintf(stderr, "Client %" PRIu32 " call %" PRIu32
+                    " got result 0x%" PRIx32 " instead of 0x%" PRIx32 "\n",
+                    client->idx, i, (uint32_t)reply,
+                    (uint32_t)params.psa_call_params.handle);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return NULL;
+}
+
+static int mailbox_bench_run(uint32_t iterations)
+{
+    struct mailbox_bench_client_t clients[MAILBOX_BENCH_NUM_CLIENTS];
+    uint32_t nr_calls = MAILBOX_BENCH_NUM_CLIENTS * iterations;
+    pthread_t spe_thread, ns_isr_thread;
+    uint64_t *latencies;
+    uint64_t start, elapsed;
+    uint32_t nr_notifications;
+    uint32_t i;
+
+    latencies = calloc(nr_calls, sizeof(*latencies));
+    if (!latencies) {
+        return EXIT_FAILURE;
+    }
+
+    if ((pthread_create(&spe_thread, NULL, mailbox_bench_spe_thread,
+                        NULL) != 0) ||
+        (pthread_create(&ns_isr_thread, NULL, mailbox_bench_ns_isr_thread,
+                        NULL) != 0)) {
+        fprintf(stderr, "Cannot create the core threads\n");
+        abort();
+    }
+
+    start = mailbox_bench_now_ns();
+
+    for (i = 0; i < MAILBOX_BENCH_NUM_CLIENTS; i++) {
+        clients[i].idx = i;
+        clients[i].iterations = iterations;
+        clients[i].latencies = &latencies[i * iterations];
+
+        if (pthread_create(&clients[i].thread, NULL,
+                           mailbox_bench_client_thread, &clients[i]) != 0) {
+            fprintf(stderr, "Cannot create the client threads\n");
+            abort();
+        }
+    }
+
+    for (i = 0; i < MAILBOX_BENCH_NUM_CLIENTS; i++) {
+        (void)pthread_join(clients[i].thread, NULL);
+    }
+
+    elapsed = mailbox_bench_now_ns() - start;
+
+    atomic_store(&is_done, true);
+    mailbox_bench_ring_doorbells();
+    (void)pthread_join(spe_thread, NULL);
+    (void)pthread_join(ns_isr_thread, NULL);
+
+    /* Every call is replied once the clients are done */
+    nr_notifications = mailbox_bench_nr_ns_notifications();
+
+    qsort(latencies, nr_calls, sizeof(*latencies), mailbox_bench_cmp_u64);
+
+    printf("%12s %10s %10s %10s %14s\n", "calls/s", "p50 ns", "p99 ns",
+           "max ns", "replies/notif");
+    printf("%12.0f %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %14.2f\n",
+           (double)nr_calls * 1e9 / (double)elapsed,
+           latencies[nr_calls / 2],
+           latencies[(uint64_t)nr_calls * 99 / 100],
+           latencies[nr_calls - 1],
+           nr_notifications ?
+               (double)nr_calls / (double)nr_notifications : 0.0);
+
+    free(latencies);
+
+    return EXIT_SUCCESS;
+}
+
+/* Benchmark modes, the first one is the default */
+static const struct mailbox_bench_mode_t mailbox_bench_modes[] = {
+    {"calls", mailbox_bench_reply_in_order, false},
+    {"stress", mailbox_bench_reply_in_order, true},
+    {"ooo", mailbox_bench_reply_out_of_order, false},
+};
+
+#define MAILBOX_BENCH_NUM_MODES \
+    (sizeof(mailbox_bench_modes) / sizeof(mailbox_bench_modes[0]))
+
+int main(int argc, char *argv[])
+{
+    size_t mode = 0;
+    uint32_t iterations = MAILBOX_BENCH_DEFAULT_ITERATIONS;
+    int arg = 1;
+
+    if ((arg < argc) && ((argv[arg][0] < '0') || (argv[arg][0] > '9'))) {
+        for (mode = 0; mode < MAILBOX_BENCH_NUM_MODES; mode++) {
+            if (strcmp(argv[arg], mailbox_bench_modes[mode].name) == 0) {
+                break;
+            }
+        }
+        arg++;
+    }
+
+    if (arg < argc) {
+        iterations = (uint32_t)strtoul(argv[arg], NULL, 0);
+        arg++;
+    }
+
+    if ((mode == MAILBOX_BENCH_NUM_MODES) || (iterations == 0) ||
+        (arg < argc)) {
+        fprintf(stderr, "Usage: %s [calls|stress|ooo] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench_mode = &mailbox_bench_modes[mode];
+
+    if ((tfm_ns_mailbox_init(&ns_queue) != MAILBOX_SUCCESS) ||
+        (tfm_inter_core_comm_init() != MAILBOX_SUCCESS)) {
+        fprintf(stderr, "Mailbox initialisation failed\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Transport: %s, %u NSPE slots, %u SPE slots, %u clients, "
+           "%" PRIu32 " calls per client\n",
+           MAILBOX_BENCH_TRANSPORT, (unsigned int)NUM_MAILBOX_QUEUE_SLOT,
+           (unsigned int)NUM_MAILBOX_SPE_QUEUE_SLOT,
+           (unsigned int)MAILBOX_BENCH_NUM_CLIENTS, iterations);
+
+    return mailbox_bench_run(iterations);
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host implementations of the services the NSPE and SPE mailboxes depend on:
+ * the inter-core HALs, the NSPE RTOS hooks and the SPM RPC interface. Each core
+ * is a host thread. The notifications between cores are semaphores and the
+ * critical section between cores is a mutex.
+ */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mailbox_bench_platform.h"
+
+#include "async.h"
+#include "config_tfm.h"
+#include "current.h"
+#include "internal_status_code.h"
+#include "psa/service.h"
+#include "tfm_hal_isolation.h"
+#include "tfm_hal_mailbox.h"
+#include "tfm_multi_core.h"
+#include "tfm_ns_mailbox.h"
+#include "tfm_rpc.h"
+
+/* An NSPE task waiting for the reply to its mailbox message */
+struct mailbox_bench_task_t {
+    sem_t reply_sem;
+    bool is_init;
+};
+
+/* A PSA client call passed into the simulated SPM, not replied yet */
+struct mailbox_bench_call_t {
+    const void *owner;
+    psa_handle_t handle;
+};
+
+struct partition_t mailbox_bench_partition;
+
+static struct ns_mailbox_queue_t *ns_queue;
+
+static sem_t spe_doorbell;
+static sem_t ns_doorbell;
+static uint32_t nr_ns_notifications;
+static pthread_mutex_t inter_core_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* NSPE RTOS objects */
+static sem_t ns_free_slots;
+static pthread_mutex_t ns_spin_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local struct mailbox_bench_task_t ns_task;
+
+/* Simulated SPM, only accessed by the SPE thread */
+static struct tfm_rpc_ops_t rpc_ops;
+static struct mailbox_bench_call_t spm_calls[NUM_MAILBOX_SPE_QUEUE_SLOT];
+static uint32_t spm_nr_calls;
+
+static void mailbox_bench_sem_wait(sem_t *sem)
+{
+    while (sem_wait(sem) != 0) {
+        ;
+    }
+}
+
+void mailbox_bench_spe_wait_doorbell(void)
+{
+    mailbox_bench_sem_wait(&spe_doorbell);
+}
+
+bool mailbox_bench_spe_poll_doorbell(void)
+{
+    return sem_trywait(&spe_doorbell) == 0;
+}
+
+void mailbox_bench_ns_wait_doorbell(void)
+{
+    mailbox_bench_sem_wait(&ns_doorbell);
+}
+
+void mailbox_bench_ring_doorbells(void)
+{
+    (void)sem_post(&spe_doorbell);
+    (void)sem_post(&ns_doorbell);
+}
+
+uint32_t mailbox_bench_nr_ns_notifications(void)
+{
+    return nr_ns_notifications;
+}
+
+uint32_t mailbox_bench_spm_nr_calls(void)
+{
+    return spm_nr_calls;
+}
+
+void mailbox_bench_spm_handle_req(void)
+{
+    rpc_ops.handle_req();
+}
+
+void mailbox_bench_spm_reply(uint32_t pos)
+{
+    struct mailbox_bench_call_t call = spm_calls[pos];
+
+    spm_nr_calls--;
+    (void)memmove(&spm_calls[pos], &spm_calls[pos + 1],
+                  (spm_nr_calls - pos) * sizeof(spm_calls[0]));
+
+    rpc_ops.reply(call.owner, (int32_t)call.handle);
+
+    if (rpc_ops.resume) {
+        rpc_ops.resume();
+    }
+}
+
+/* NSPE mailbox HAL */
+
+int32_t tfm_ns_mailbox_hal_init(struct ns_mailbox_queue_t *queue)
+{
+    ns_queue = queue;
+
+    if ((sem_init(&spe_doorbell, 0, 0) != 0) ||
+        (sem_init(&ns_doorbell, 0, 0) != 0)) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_hal_notify_peer(void)
+{
+    (void)sem_post(&spe_doorbell);
+
+    return MAILBOX_SUCCESS;
+}
+
+void tfm_ns_mailbox_hal_enter_critical(void)
+{
+    (void)pthread_mutex_lock(&inter_core_lock);
+}
+
+void tfm_ns_mailbox_hal_exit_critical(void)
+{
+    (void)pthread_mutex_unlock(&inter_core_lock);
+}
+
+void tfm_ns_mailbox_hal_enter_critical_isr(void)
+{
+    (void)pthread_mutex_lock(&inter_core_lock);
+}
+
+void tfm_ns_mailbox_hal_exit_critical_isr(void)
+{
+    (void)pthread_mutex_unlock(&inter_core_lock);
+}
+
+/* NSPE RTOS hooks */
+
+int32_t tfm_ns_mailbox_os_lock_init(void)
+{
+    if (sem_init(&ns_free_slots, 0, NUM_MAILBOX_QUEUE_SLOT) != 0) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_os_lock_acquire(void)
+{
+    mailbox_bench_sem_wait(&ns_free_slots);
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_os_lock_release(void)
+{
+    (void)sem_post(&ns_free_slots);
+
+    return MAILBOX_SUCCESS;
+}
+
+const void *tfm_ns_mailbox_os_get_task_handle(void)
+{
+    if (!ns_task.is_init) {
+        if (sem_init(&ns_task.reply_sem, 0, 0) != 0) {
+            abort();
+        }
+        ns_task.is_init = true;
+    }
+
+    return &ns_task;
+}
+
+void tfm_ns_mailbox_os_wait_reply(void)
+{
+    mailbox_bench_sem_wait(&ns_task.reply_sem);
+}
+
+void tfm_ns_mailbox_os_wake_task_isr(const void *task_handle)
+{
+    struct mailbox_bench_task_t *task =
+                            (struct mailbox_bench_task_t *)task_handle;
+
+    (void)sem_post(&task->reply_sem);
+}
+
+void tfm_ns_mailbox_os_spin_lock(void)
+{
+    (void)pthread_mutex_lock(&ns_spin_lock);
+}
+
+void tfm_ns_mailbox_os_spin_unlock(void)
+{
+    (void)pthread_mutex_unlock(&ns_spin_lock);
+}
+
+/* SPE mailbox HAL */
+
+int32_t tfm_mailbox_hal_init(struct secure_mailbox_queue_t *s_queue)
+{
+    s_queue->ns_status = &ns_queue->status;
+    s_queue->ns_slot_count = NUM_MAILBOX_QUEUE_SLOT;
+    s_queue->ns_slots = ns_queue->slots;
+#ifdef MAILBOX_RING_TRANSPORT
+    s_queue->ns_rings = &ns_queue->rings;
+#endif
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_mailbox_hal_notify_peer(void)
+{
+    nr_ns_notifications++;
+    (void)sem_post(&ns_doorbell);
+
+    return MAILBOX_SUCCESS;
+}
+
+void tfm_mailbox_hal_enter_critical(void)
+{
+    (void)pthread_mutex_lock(&inter_core_lock);
+}
+
+void tfm_mailbox_hal_exit_critical(void)
+{
+    (void)pthread_mutex_unlock(&inter_core_lock);
+}
+
+/* Simulated SPM */
+
+int32_t tfm_rpc_register_ops(const struct tfm_rpc_ops_t *ops_ptr)
+{
+    rpc_ops = *ops_ptr;
+
+    return TFM_RPC_SUCCESS;
+}
+
+void tfm_rpc_unregister_ops(void)
+{
+    (void)memset(&rpc_ops, 0, sizeof(rpc_ops));
+}
+
+uint32_t tfm_rpc_psa_framework_version(void)
+{
+    return PSA_FRAMEWORK_VERSION;
+}
+
+uint32_t tfm_rpc_psa_version(uint32_t sid)
+{
+    (void)sid;
+
+    return PSA_VERSION_NONE;
+}
+
+psa_status_t tfm_rpc_psa_call(psa_handle_t handle, uint32_t control,
+                              const struct client_params_t *params,
+                              const void *client_data_stateless)
+{
+    uint32_t i;
+
+    (void)control;
+    (void)params;
+
+    /*
+     * Each SPE mailbox slot has at most one call in progress. The owner of a
+     * call identifies its SPE mailbox slot.
+     */
+    if (spm_nr_calls >= NUM_MAILBOX_SPE_QUEUE_SLOT) {
+        fprintf(stderr, "More calls in progress than SPE mailbox slots\n");
+        abort();
+    }
+
+    for (i = 0; i < spm_nr_calls; i++) {
+        if (spm_calls[i].owner == client_data_stateless) {
+            fprintf(stderr, "SPE mailbox slot passed in twice\n");
+            abort();
+        }
+    }
+
+    spm_calls[spm_nr_calls].owner = client_data_stateless;
+    spm_calls[spm_nr_calls].handle = handle;
+    spm_nr_calls++;
+
+    return PSA_SUCCESS;
+}
+
+psa_signal_t psa_wait(psa_signal_t signal_mask, uint32_t timeout)
+{
+    (void)timeout;
+
+    /* The calls passed in can be replied at any time */
+    if (spm_nr_calls) {
+        return signal_mask & ASYNC_MSG_REPLY;
+    }
+
+    return 0;
+}
+
+void psa_panic(void)
+{
+    fprintf(stderr, "SPE mailbox panic\n");
+    abort();
+}
+
+int32_t tfm_multi_core_hal_client_id_translate(void *owner,
+                                               int32_t client_id_in,
+                                               int32_t *client_id_out)
+{
+    (void)owner;
+
+    *client_id_out = client_id_in;
+
+    return SPM_SUCCESS;
+}
+
+fih_int tfm_hal_memory_check(uintptr_t boundary, uintptr_t base,
+                             size_t size, uint32_t access_type)
+{
+    (void)boundary;
+    (void)base;
+    (void)size;
+    (void)access_type;
+
+    return fih_int_encode(PSA_SUCCESS);
+}
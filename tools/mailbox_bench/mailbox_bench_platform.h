@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __MAILBOX_BENCH_PLATFORM_H__
+#define __MAILBOX_BENCH_PLATFORM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Waits until NSPE notifies SPE of a new mailbox message, or until
+ *        \ref mailbox_bench_ring_doorbells is called.
+ */
+void mailbox_bench_spe_wait_doorbell(void);
+
+/**
+ * \brief Consumes a notification from NSPE to SPE, if any.
+ *
+ * \return true if NSPE notified SPE, false otherwise.
+ */
+bool mailbox_bench_spe_poll_doorbell(void);
+
+/**
+ * \brief Waits until SPE notifies NSPE of a reply, or until
+ *        \ref mailbox_bench_ring_doorbells is called.
+ */
+void mailbox_bench_ns_wait_doorbell(void);
+
+/**
+ * \brief Wakes up the threads waiting for a notification, so that they can
+ *        check whether the benchmark is over.
+ */
+void mailbox_bench_ring_doorbells(void);
+
+/**
+ * \brief Returns the number of notifications SPE sent to NSPE.
+ */
+uint32_t mailbox_bench_nr_ns_notifications(void);
+
+/**
+ * \brief Returns the number of PSA client calls passed into the simulated SPM
+ *        by SPE mailbox and not replied yet.
+ */
+uint32_t mailbox_bench_spm_nr_calls(void);
+
+/**
+ * \brief Lets SPE mailbox handle the messages NSPE notified it of, as SPM
+ *        does when the mailbox interrupt is signalled.
+ */
+void mailbox_bench_spm_handle_req(void);
+
+/**
+ * \brief Replies to a PSA client call passed into the simulated SPM, then
+ *        lets SPE mailbox resume its work, as SPM does when the service
+ *        replies.
+ *
+ * \details The result of a call is the handle it was made with, so that the
+ *          client can check that it gets the result of its own call.
+ *
+ * \param[in] pos  Position of the call among the calls not replied yet, in
+ *                 the order they were passed in. It must be less than
+ *                 \ref mailbox_bench_spm_nr_calls.
+ */
+void mailbox_bench_spm_reply(uint32_t pos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAILBOX_BENCH_PLATFORM_H__ */
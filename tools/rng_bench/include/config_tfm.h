@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Configuration of the Crypto service in the host RNG benchmark. Any option
+ * of config_base.h can be overridden on the command line, for example with
+ * -DCMAKE_C_FLAGS="-DCRYPTO_RNG_POOL_SIZE=512".
+ */
+
+#ifndef __CONFIG_TFM_H__
+#define __CONFIG_TFM_H__
+
+#include "config_base.h"
+
+#endif /* __CONFIG_TFM_H__ */
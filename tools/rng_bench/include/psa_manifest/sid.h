@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PSA_MANIFEST_SID_H__
+#define __PSA_MANIFEST_SID_H__
+
+/* Host build: only the Crypto service is called */
+#define TFM_CRYPTO_HANDLE                                          (0x40000100U)
+
+#endif /* __PSA_MANIFEST_SID_H__ */
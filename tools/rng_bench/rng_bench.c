@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host benchmark of the random number requests of the Crypto service.
+ *
+ * The random module of the Crypto service, with its random pool, and the
+ * client interface, with its random cache, are built for the host over a
+ * simulated DRBG. Requests of 16, 32 and 64 bytes are made and each one is
+ * checked not to hand out bytes another request got.
+ *
+ * The benchmark has the following modes:
+ *
+ * service: Requests made to the random module, as the secure partitions do.
+ *          They are served from the random pool if CRYPTO_RNG_POOL_SIZE is
+ *          enabled.
+ * client:  Requests made with psa_generate_random() of the client interface,
+ *          as NSPE does. They are served from the random cache if
+ *          CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE is enabled, then from the random
+ *          pool.
+ *
+ * It reports the requests per second, and the calls to the Crypto service
+ * and to the DRBG per request, for each request size.
+ *
+ * Usage: rng_bench [service|client] [iterations]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rng_bench_platform.h"
+
+#include "config_tfm.h"
+#include "tfm_crypto_api.h"
+#include "tfm_crypto_defs.h"
+
+#define RNG_BENCH_DEFAULT_ITERATIONS 1000000
+
+#define RNG_BENCH_MAX_REQUEST_SIZE   64
+
+#ifndef CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE
+#define CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE 0
+#endif
+
+/* The client interface is built with CONFIG_TFM_CRYPTO_API_RENAME */
+psa_status_t tfm_crypto__psa_generate_random(uint8_t *output,
+                                             size_t output_size);
+
+/* A benchmark mode */
+struct rng_bench_mode_t {
+    const char *name;
+    psa_status_t (*request)(uint8_t *output, size_t output_size);
+};
+
+static const size_t rng_bench_request_sizes[] = {16, 32, 64};
+
+static uint64_t rng_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static int rng_bench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static psa_status_t rng_bench_service_request(uint8_t *output,
+                                              size_t output_size)
+{
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_GENERATE_RANDOM_SID,
+    };
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(iov)},
+    };
+    psa_outvec out_vec[] = {
+        {.base = output, .len = output_size},
+    };
+
+    return tfm_crypto_random_interface(in_vec, out_vec);
+}
+
+static psa_status_t rng_bench_client_request(uint8_t *output,
+                                             size_t output_size)
+{
+    return tfm_crypto__psa_generate_random(output, output_size);
+}
+
+/*
+ * A byte handed out twice makes two requests start with the same 8 bytes,
+ * which random requests do not otherwise in a run of the benchmark.
+ */
+static int rng_bench_check_unique(uint64_t *prefixes, uint32_t iterations)
+{
+    uint32_t i;
+
+    qsort(prefixes, iterations, sizeof(*prefixes), rng_bench_cmp_u64);
+
+    for (i = 1; i < iterations; i++) {
+        if (prefixes[i] == prefixes[i - 1]) {
+            fprintf(stderr, "Random bytes handed out twice\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int rng_bench_run(const struct rng_bench_mode_t *mode,
+                         uint32_t iterations)
+{
+    uint8_t output[RNG_BENCH_MAX_REQUEST_SIZE];
+    struct rng_bench_stats_t stats;
+    uint64_t *prefixes;
+    uint64_t start, elapsed;
+    size_t size_idx, size;
+    psa_status_t status;
+    uint32_t i;
+
+    prefixes = calloc(iterations, sizeof(*prefixes));
+    if (!prefixes) {
+        return EXIT_FAILURE;
+    }
+
+    printf("%6s %12s %14s %14s\n", "bytes", "requests/s", "service/req",
+           "DRBG/req");
+
+    for (size_idx = 0;
+         size_idx < (sizeof(rng_bench_request_sizes) /
+                     sizeof(rng_bench_request_sizes[0]));
+         size_idx++) {
+        size = rng_bench_request_sizes[size_idx];
+
+        /* Start each size from empty pool and cache */
+        tfm_crypto_random_cache_flush();
+        (void)tfm_crypto_init_rng();
+        rng_bench_reset();
+
+        start = rng_bench_now_ns();
+
+        for (i = 0; i < iterations; i++) {
+            status = mode->request(output, size);
+            if (status != PSA_SUCCESS) {
+                fprintf(stderr, "Request %" PRIu32 " failed: %d\n",
+                        i, (int)status);
+                free(prefixes);
+                return EXIT_FAILURE;
+            }
+            (void)memcpy(&prefixes[i], output, sizeof(prefixes[i]));
+        }
+
+        elapsed = rng_bench_now_ns() - start;
+        stats = rng_bench_get_stats();
+
+        printf("%6zu %12.0f %14.3f %14.3f\n", size,
+               (double)iterations * 1e9 / (double)elapsed,
+               (double)stats.service_calls / (double)iterations,
+               (double)stats.drbg_calls / (double)iterations);
+
+        if (rng_bench_check_unique(prefixes, iterations) != EXIT_SUCCESS) {
+            free(prefixes);
+            return EXIT_FAILURE;
+        }
+    }
+
+    free(prefixes);
+
+    return EXIT_SUCCESS;
+}
+
+/* Benchmark modes, the first one is the default */
+static const struct rng_bench_mode_t rng_bench_modes[] = {
+    {"service", rng_bench_service_request},
+    {"client", rng_bench_client_request},
+};
+
+#define RNG_BENCH_NUM_MODES \
+    (sizeof(rng_bench_modes) / sizeof(rng_bench_modes[0]))
+
+int main(int argc, char *argv[])
+{
+    size_t mode = 0;
+    uint32_t iterations = RNG_BENCH_DEFAULT_ITERATIONS;
+    int arg = 1;
+
+    if ((arg < argc) && ((argv[arg][0] < '0') || (argv[arg][0] > '9'))) {
+        for (mode = 0; mode < RNG_BENCH_NUM_MODES; mode++) {
+            if (strcmp(argv[arg], rng_bench_modes[mode].name) == 0) {
+                break;
+            }
+        }
+        arg++;
+    }
+
+    if (arg < argc) {
+        iterations = (uint32_t)strtoul(argv[arg], NULL, 0);
+        arg++;
+    }
+
+    if ((mode == RNG_BENCH_NUM_MODES) || (iterations == 0) || (arg < argc)) {
+        fprintf(stderr, "Usage: %s [service|client] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("Random pool: %u bytes, random cache: %u bytes, "
+           "%" PRIu32 " requests per size\n",
+           (unsigned int)CRYPTO_RNG_POOL_SIZE,
+           (unsigned int)CONFIG_TFM_CRYPTO_RNG_CACHE_SIZE, iterations);
+
+    return rng_bench_run(&rng_bench_modes[mode], iterations);
+}
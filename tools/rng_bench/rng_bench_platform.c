@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host implementations of the services the random module of the Crypto
+ * service and its client interface depend on: the DRBG of the crypto library
+ * and the PSA client call into the Crypto service.
+ *
+ * The DRBG is a ChaCha20 generator which re-keys itself at the end of each
+ * call, so that a call costs the blocks it outputs plus one, as a CTR_DRBG
+ * call costs the blocks it outputs plus its update step. The PSA client call
+ * passes the vectors straight to the service, with no IPC cost: the number of
+ * service calls per request is reported instead.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rng_bench_platform.h"
+
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+#include "tfm_crypto_api.h"
+#include "tfm_crypto_defs.h"
+
+#define RNG_BENCH_CHACHA_BLOCK_SIZE 64
+
+/* Fixed seed, so that runs are comparable */
+static const uint32_t drbg_seed[8] = {
+    0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c,
+    0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c,
+};
+
+static uint32_t drbg_key[8];
+static uint64_t drbg_counter;
+static struct rng_bench_stats_t stats;
+static bool is_cache_locked;
+
+#define RNG_BENCH_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define RNG_BENCH_QUARTER_ROUND(a, b, c, d)                 \
+    do {                                                    \
+        a += b; d ^= a; d = RNG_BENCH_ROTL(d, 16);          \
+        c += d; b ^= c; b = RNG_BENCH_ROTL(b, 12);          \
+        a += b; d ^= a; d = RNG_BENCH_ROTL(d, 8);           \
+        c += d; b ^= c; b = RNG_BENCH_ROTL(b, 7);           \
+    } while (0)
+
+static void rng_bench_chacha20_block(uint8_t out[RNG_BENCH_CHACHA_BLOCK_SIZE])
+{
+    uint32_t in[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        drbg_key[0], drbg_key[1], drbg_key[2], drbg_key[3],
+        drbg_key[4], drbg_key[5], drbg_key[6], drbg_key[7],
+        (uint32_t)drbg_counter, (uint32_t)(drbg_counter >> 32), 0, 0,
+    };
+    uint32_t x[16];
+    uint32_t i;
+
+    (void)memcpy(x, in, sizeof(x));
+
+    for (i = 0; i < 10; i++) {
+        RNG_BENCH_QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        RNG_BENCH_QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        RNG_BENCH_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        RNG_BENCH_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        RNG_BENCH_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        RNG_BENCH_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        RNG_BENCH_QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        RNG_BENCH_QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+
+    for (i = 0; i < 16; i++) {
+        x[i] += in[i];
+    }
+
+    (void)memcpy(out, x, RNG_BENCH_CHACHA_BLOCK_SIZE);
+    drbg_counter++;
+}
+
+struct rng_bench_stats_t rng_bench_get_stats(void)
+{
+    return stats;
+}
+
+void rng_bench_reset(void)
+{
+    (void)memcpy(drbg_key, drbg_seed, sizeof(drbg_key));
+    drbg_counter = 0;
+    (void)memset(&stats, 0, sizeof(stats));
+}
+
+void rng_bench_cache_lock(void)
+{
+    if (is_cache_locked) {
+        fprintf(stderr, "Random cache locked twice\n");
+        abort();
+    }
+    is_cache_locked = true;
+}
+
+void rng_bench_cache_unlock(void)
+{
+    if (!is_cache_locked) {
+        fprintf(stderr, "Random cache unlocked while not locked\n");
+        abort();
+    }
+    is_cache_locked = false;
+}
+
+/* DRBG of the crypto library, as renamed by crypto_spe.h */
+
+psa_status_t mbedcrypto__psa_generate_random(uint8_t *output,
+                                             size_t output_size)
+{
+    uint8_t block[RNG_BENCH_CHACHA_BLOCK_SIZE];
+    size_t length;
+
+    stats.drbg_calls++;
+
+    while (output_size > 0) {
+        rng_bench_chacha20_block(block);
+        length = (output_size < sizeof(block)) ? output_size : sizeof(block);
+        (void)memcpy(output, block, length);
+        output += length;
+        output_size -= length;
+    }
+
+    /* Re-key, so that the output of this call cannot be recovered */
+    rng_bench_chacha20_block(block);
+    (void)memcpy(drbg_key, block, sizeof(drbg_key));
+    (void)memset(block, 0, sizeof(block));
+
+    return PSA_SUCCESS;
+}
+
+/* PSA client call into the Crypto service */
+
+psa_status_t psa_call(psa_handle_t handle, int32_t type,
+                      const psa_invec *in_vec,
+                      size_t in_len,
+                      psa_outvec *out_vec,
+                      size_t out_len)
+{
+    const struct tfm_crypto_pack_iovec *iov;
+
+    stats.service_calls++;
+
+    if ((handle != TFM_CRYPTO_HANDLE) || (type != PSA_IPC_CALL) ||
+        (in_len < 1) || (out_len < 1) ||
+        (in_vec[0].len != sizeof(*iov))) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    iov = in_vec[0].base;
+    if (iov->function_id != TFM_CRYPTO_GENERATE_RANDOM_SID) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    return tfm_crypto_random_interface((psa_invec *)in_vec, out_vec);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __RNG_BENCH_PLATFORM_H__
+#define __RNG_BENCH_PLATFORM_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of calls to the Crypto service and to the DRBG */
+struct rng_bench_stats_t {
+    uint64_t service_calls;
+    uint64_t drbg_calls;
+};
+
+/**
+ * \brief Returns the number of calls to the Crypto service and to the DRBG
+ *        since the last reset.
+ */
+struct rng_bench_stats_t rng_bench_get_stats(void);
+
+/**
+ * \brief Resets the call counters and restarts the DRBG from its seed, so
+ *        that runs are comparable.
+ */
+void rng_bench_reset(void);
+
+/**
+ * \brief Serialises the accesses to the random cache of the client interface.
+ *        The benchmark is single-threaded, so they only check the lock is
+ *        taken and released in turn.
+ */
+void rng_bench_cache_lock(void);
+void rng_bench_cache_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RNG_BENCH_PLATFORM_H__ */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host replacement of the architecture layer seen by the SPM scheduler. The
+ * interrupt mask is a flag and the return codes set in the thread contexts
+ * are recorded instead of being written to their stacks.
+ */
+
+#ifndef __TFM_ARCH_H__
+#define __TFM_ARCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Context control, as on the target */
+struct context_ctrl_t {
+    uint32_t                sp;
+    uint32_t                exc_ret;
+    uint32_t                sp_limit;
+    uint32_t                sp_base;
+};
+
+/* Count leading zeros, which gives 32 for zero as the instruction does */
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return (value != 0) ? (uint32_t)__builtin_clz(value) : 32U;
+}
+
+uint32_t __save_disable_irq(void);
+void __restore_irq(uint32_t status);
+
+void tfm_arch_set_context_ret_code(const struct context_ctrl_t *p_ctx_ctrl,
+                                   uint32_t ret_code);
+
+void tfm_arch_init_context(struct context_ctrl_t *p_ctx_ctrl,
+                           uintptr_t pfn, void *param, uintptr_t pfnlr);
+
+uint32_t tfm_arch_refresh_hardware_context(const struct context_ctrl_t *p_ctx_ctrl);
+
+uint32_t arch_attempt_schedule(void);
+
+#endif /* __TFM_ARCH_H__ */
@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host simulation and benchmark of the SPM scheduler.
+ *
+ * The thread list and ready bitmap of SPM are built for the host, with
+ * partitions modelled as in the IPC backend: a partition either runs or waits
+ * for some of its signals, and asserting a signal it waits for wakes its
+ * thread up with thrd_wake_up(). At each step, signals are asserted at random
+ * partitions, thrd_next() selects the thread to run, and that thread may wait
+ * for signals again. An idle thread of the lowest priority never waits.
+ *
+ * The steps are run with 4, 16 and 64 threads, the threads being added
+ * between rounds.
+ *
+ * The benchmark has the following modes:
+ *
+ * check: Partitions of random priorities. Threads are also woken up when none
+ *        of the signals they wait for is asserted. Each thread selected is
+ *        checked against the first runnable thread in priority order, and the
+ *        signals it is woken up with against those it waits for.
+ * bench: Partitions of the priorities of the manifests. It reports the steps
+ *        per second, and the thread states queried per thrd_next() against
+ *        those a scan of the thread list from its head would query.
+ *
+ * The number of steps of each round is given by the iterations.
+ *
+ * Usage: sched_bench [check|bench] [iterations]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sched_bench_platform.h"
+
+#include "critical_section.h"
+#include "load/partition_defs.h"
+#include "thread.h"
+#include "utilities.h"
+
+#define SCHED_BENCH_DEFAULT_ITERATIONS 1000000
+
+#define SCHED_BENCH_MAX_THREADS        64
+
+/* Signals the partitions wait for */
+#define SCHED_BENCH_SIGNAL_NUM         4
+#define SCHED_BENCH_SIGNAL_MASK        ((1U << SCHED_BENCH_SIGNAL_NUM) - 1)
+
+/* The idle thread is the first one started */
+#define SCHED_BENCH_IDLE_THREAD        0
+
+/* A partition and its thread */
+struct sched_bench_thread_t {
+    struct context_ctrl_t ctx_ctrl;
+    struct thread_t       thrd;
+    uint32_t              signals_waiting;
+    uint32_t              signals_asserted;
+};
+
+/* Scheduler activity of a round */
+struct sched_bench_stats_t {
+    uint64_t nexts;          /* Calls to thrd_next()                      */
+    uint64_t queries;        /* Thread states queried                     */
+    uint64_t scan_queries;   /* Thread states a scan from the head queries */
+    uint64_t wake_ups;       /* Calls to thrd_wake_up()                   */
+};
+
+/* A benchmark mode */
+struct sched_bench_mode_t {
+    const char *name;
+    bool is_check;
+    uint8_t (*priority)(void);
+};
+
+static const size_t sched_bench_rounds[] = {4, 16, 64};
+
+static struct sched_bench_thread_t threads[SCHED_BENCH_MAX_THREADS];
+static size_t nr_threads;
+
+/* Threads in the order the scheduler is expected to consider them */
+static size_t thread_order[SCHED_BENCH_MAX_THREADS];
+
+static struct sched_bench_stats_t stats;
+
+/* Set when a thread state is queried outside of a critical section */
+static bool is_query_unmasked;
+
+static uint32_t rand_state = 1;
+
+static uint32_t sched_bench_rand(void)
+{
+    /* Fixed seed xorshift, so that runs are reproducible */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static uint64_t sched_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static uint8_t sched_bench_random_priority(void)
+{
+    /* Any priority above the idle thread */
+    return (uint8_t)(sched_bench_rand() % THRD_PRIOR_LOWEST);
+}
+
+static uint8_t sched_bench_manifest_priority(void)
+{
+    static const uint8_t priorities[] = {
+        PARTITION_PRI_HIGH,
+        PARTITION_PRI_NORMAL,
+        PARTITION_PRI_NORMAL,
+        PARTITION_PRI_LOW,
+    };
+
+    return priorities[sched_bench_rand() % (sizeof(priorities) /
+                                            sizeof(priorities[0]))];
+}
+
+static void sched_bench_thread_entry(void *param)
+{
+    (void)param;
+}
+
+/* The state query of the IPC backend, over the modelled signals */
+static uint32_t sched_bench_query_state(const struct thread_t *p_thrd,
+                                        uint32_t *p_retval)
+{
+    struct sched_bench_thread_t *p_t = TO_CONTAINER(p_thrd->p_context_ctrl,
+                                                    struct sched_bench_thread_t,
+                                                    ctx_ctrl);
+    uint32_t signals = p_t->signals_waiting & p_t->signals_asserted;
+    uint32_t state = p_thrd->state;
+
+    stats.queries++;
+
+    if (!sched_bench_is_irq_masked()) {
+        is_query_unmasked = true;
+    }
+
+    if (signals) {
+        *p_retval = signals;
+        p_t->signals_waiting = 0;
+        state = THRD_STATE_RET_VAL_AVAIL;
+    } else if (p_t->signals_waiting != 0) {
+        state = THRD_STATE_BLOCK;
+    }
+
+    return state;
+}
+
+/* Asserts a signal of a partition, as backend_assert_signal() does */
+static void sched_bench_assert_signal(struct sched_bench_thread_t *p_t,
+                                      uint32_t signal)
+{
+    struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_signal);
+    p_t->signals_asserted |= signal;
+
+    if (p_t->signals_asserted & p_t->signals_waiting) {
+        thrd_wake_up(&p_t->thrd);
+        stats.wake_ups++;
+    }
+    CRITICAL_SECTION_LEAVE(cs_signal);
+}
+
+/* Wakes a thread up whatever its signals, which the scheduler must allow */
+static void sched_bench_spurious_wake_up(struct sched_bench_thread_t *p_t)
+{
+    struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_signal);
+    thrd_wake_up(&p_t->thrd);
+    stats.wake_ups++;
+    CRITICAL_SECTION_LEAVE(cs_signal);
+}
+
+/*
+ * Starts threads up to the given number. Threads are ordered by priority,
+ * the last started first among those of the same priority.
+ */
+static void sched_bench_add_threads(size_t total, uint8_t (*priority)(void))
+{
+    struct sched_bench_thread_t *p_t;
+    size_t pos;
+
+    for (; nr_threads < total; nr_threads++) {
+        p_t = &threads[nr_threads];
+
+        THRD_INIT(&p_t->thrd, &p_t->ctx_ctrl,
+                  (nr_threads == SCHED_BENCH_IDLE_THREAD) ?
+                  THRD_PRIOR_LOWEST : priority());
+        p_t->signals_waiting = 0;
+        p_t->signals_asserted = 0;
+
+        for (pos = 0; pos < nr_threads; pos++) {
+            if (p_t->thrd.priority <=
+                threads[thread_order[pos]].thrd.priority) {
+                break;
+            }
+        }
+        (void)memmove(&thread_order[pos + 1], &thread_order[pos],
+                      (nr_threads - pos) * sizeof(thread_order[0]));
+        thread_order[pos] = nr_threads;
+
+        thrd_start(&p_t->thrd, sched_bench_thread_entry, THRD_GENERAL_EXIT,
+                   NULL);
+    }
+}
+
+/*
+ * Returns the first runnable thread in priority order, the signals it is to
+ * be woken up with, and its position in the order.
+ */
+static size_t sched_bench_expected_next(uint32_t *p_signals, size_t *p_pos)
+{
+    struct sched_bench_thread_t *p_t;
+    size_t pos;
+
+    for (pos = 0; pos < nr_threads; pos++) {
+        p_t = &threads[thread_order[pos]];
+
+        if ((p_t->signals_waiting == 0) ||
+            (p_t->signals_waiting & p_t->signals_asserted)) {
+            break;
+        }
+    }
+
+    /* The idle thread is always runnable */
+    p_t = &threads[thread_order[pos]];
+    *p_signals = p_t->signals_waiting & p_t->signals_asserted;
+    *p_pos = pos;
+
+    return thread_order[pos];
+}
+
+/*
+ * Runs the selected partition: it handles the signals it was woken up with,
+ * and may wait for signals again. psa_wait() returns at once if some of them
+ * are asserted already.
+ */
+static void sched_bench_run_thread(struct sched_bench_thread_t *p_t,
+                                   uint32_t signals)
+{
+    uint32_t waiting;
+
+    p_t->signals_asserted &= ~signals;
+
+    if ((p_t == &threads[SCHED_BENCH_IDLE_THREAD]) ||
+        ((sched_bench_rand() & 0x3) == 0)) {
+        return;
+    }
+
+    waiting = sched_bench_rand() & SCHED_BENCH_SIGNAL_MASK;
+    if (waiting == 0) {
+        waiting = SCHED_BENCH_SIGNAL_MASK;
+    }
+
+    if (p_t->signals_asserted & waiting) {
+        p_t->signals_asserted &= ~waiting;
+    } else {
+        p_t->signals_waiting = waiting;
+    }
+}
+
+static int sched_bench_round(const struct sched_bench_mode_t *mode,
+                             uint32_t iterations)
+{
+    struct sched_bench_ret_codes_t before, after;
+    struct sched_bench_thread_t *p_t;
+    struct thread_t *p_next;
+    uint32_t r, signals, ret_signals;
+    size_t expected, pos;
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++) {
+        r = sched_bench_rand();
+
+        /* Signals are asserted at about every other step */
+        if (r & 0x1) {
+            p_t = &threads[1 + ((r >> 8) % (nr_threads - 1))];
+            sched_bench_assert_signal(p_t,
+                                      1U << ((r >> 4) % SCHED_BENCH_SIGNAL_NUM));
+        }
+
+        if (mode->is_check && ((r & 0x6) == 0)) {
+            sched_bench_spurious_wake_up(&threads[(r >> 16) % nr_threads]);
+        }
+
+        expected = sched_bench_expected_next(&signals, &pos);
+        before = sched_bench_get_ret_codes();
+
+        p_next = thrd_next();
+
+        after = sched_bench_get_ret_codes();
+        stats.nexts++;
+        stats.scan_queries += pos + 1;
+
+        if (!p_next) {
+            fprintf(stderr, "Step %" PRIu32 ": no thread selected\n", i);
+            return EXIT_FAILURE;
+        }
+
+        p_t = TO_CONTAINER(p_next->p_context_ctrl,
+                           struct sched_bench_thread_t, ctx_ctrl);
+        ret_signals = (after.count != before.count) ? after.ret_code : 0;
+
+        if (mode->is_check) {
+            if (p_t != &threads[expected]) {
+                fprintf(stderr, "Step %" PRIu32 ": thread %zu selected "
+                        "instead of thread %zu with %zu threads\n", i,
+                        (size_t)(p_t - threads), expected, nr_threads);
+                return EXIT_FAILURE;
+            }
+
+            if ((after.count - before.count != ((signals != 0) ? 1 : 0)) ||
+                ((signals != 0) && ((after.p_ctx != &p_t->ctx_ctrl) ||
+                                    (ret_signals != signals)))) {
+                fprintf(stderr, "Step %" PRIu32 ": thread %zu not woken up "
+                        "with signals 0x%" PRIx32 "\n", i,
+                        (size_t)(p_t - threads), signals);
+                return EXIT_FAILURE;
+            }
+
+            if (is_query_unmasked || sched_bench_is_irq_masked()) {
+                fprintf(stderr, "Step %" PRIu32 ": thread states queried "
+                        "outside of a critical section\n", i);
+                return EXIT_FAILURE;
+            }
+        }
+
+        sched_bench_run_thread(p_t, ret_signals);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int sched_bench_run(const struct sched_bench_mode_t *mode,
+                           uint32_t iterations)
+{
+    uint64_t start, elapsed;
+    size_t round;
+
+    thrd_set_query_callback(sched_bench_query_state);
+
+    printf("%8s %12s %14s %14s %14s\n", "threads", "steps/s", "queries/next",
+           "scan/next", "wake ups/step");
+
+    for (round = 0;
+         round < (sizeof(sched_bench_rounds) / sizeof(sched_bench_rounds[0]));
+         round++) {
+        sched_bench_add_threads(sched_bench_rounds[round], mode->priority);
+        (void)memset(&stats, 0, sizeof(stats));
+
+        start = sched_bench_now_ns();
+
+        if (sched_bench_round(mode, iterations) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+
+        elapsed = sched_bench_now_ns() - start;
+
+        printf("%8zu %12.0f %14.3f %14.3f %14.3f\n", nr_threads,
+               (double)iterations * 1e9 / (double)elapsed,
+               (double)stats.queries / (double)stats.nexts,
+               (double)stats.scan_queries / (double)stats.nexts,
+               (double)stats.wake_ups / (double)iterations);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* Benchmark modes, the first one is the default */
+static const struct sched_bench_mode_t sched_bench_modes[] = {
+    {"check", true, sched_bench_random_priority},
+    {"bench", false, sched_bench_manifest_priority},
+};
+
+#define SCHED_BENCH_NUM_MODES \
+    (sizeof(sched_bench_modes) / sizeof(sched_bench_modes[0]))
+
+int main(int argc, char *argv[])
+{
+    size_t mode = 0;
+    uint32_t iterations = SCHED_BENCH_DEFAULT_ITERATIONS;
+    int arg = 1;
+
+    if ((arg < argc) && ((argv[arg][0] < '0') || (argv[arg][0] > '9'))) {
+        for (mode = 0; mode < SCHED_BENCH_NUM_MODES; mode++) {
+            if (strcmp(argv[arg], sched_bench_modes[mode].name) == 0) {
+                break;
+            }
+        }
+        arg++;
+    }
+
+    if (arg < argc) {
+        iterations = (uint32_t)strtoul(argv[arg], NULL, 0);
+        arg++;
+    }
+
+    if ((mode == SCHED_BENCH_NUM_MODES) || (iterations == 0) ||
+        (arg < argc)) {
+        fprintf(stderr, "Usage: %s [check|bench] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%" PRIu32 " steps per round\n", iterations);
+
+    return sched_bench_run(&sched_bench_modes[mode], iterations);
+}
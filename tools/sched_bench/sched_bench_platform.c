@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host implementation of the architecture layer the SPM scheduler depends
+ * on. The threads are never switched to, so the contexts are left untouched.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sched_bench_platform.h"
+
+#include "tfm_arch.h"
+
+static bool is_irq_masked;
+static struct sched_bench_ret_codes_t ret_codes;
+
+struct sched_bench_ret_codes_t sched_bench_get_ret_codes(void)
+{
+    return ret_codes;
+}
+
+bool sched_bench_is_irq_masked(void)
+{
+    return is_irq_masked;
+}
+
+uint32_t __save_disable_irq(void)
+{
+    uint32_t status = is_irq_masked ? 1U : 0U;
+
+    is_irq_masked = true;
+
+    return status;
+}
+
+void __restore_irq(uint32_t status)
+{
+    is_irq_masked = (status != 0);
+}
+
+void tfm_arch_set_context_ret_code(const struct context_ctrl_t *p_ctx_ctrl,
+                                   uint32_t ret_code)
+{
+    ret_codes.count++;
+    ret_codes.p_ctx = p_ctx_ctrl;
+    ret_codes.ret_code = ret_code;
+}
+
+void tfm_arch_init_context(struct context_ctrl_t *p_ctx_ctrl,
+                           uintptr_t pfn, void *param, uintptr_t pfnlr)
+{
+    (void)pfn;
+    (void)param;
+    (void)pfnlr;
+
+    p_ctx_ctrl->sp = 0;
+    p_ctx_ctrl->exc_ret = 0;
+}
+
+uint32_t tfm_arch_refresh_hardware_context(const struct context_ctrl_t *p_ctx_ctrl)
+{
+    return p_ctx_ctrl->exc_ret;
+}
+
+uint32_t arch_attempt_schedule(void)
+{
+    return 0;
+}
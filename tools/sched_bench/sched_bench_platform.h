@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SCHED_BENCH_PLATFORM_H__
+#define __SCHED_BENCH_PLATFORM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tfm_arch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Return codes set in the thread contexts */
+struct sched_bench_ret_codes_t {
+    uint64_t                     count;     /* Number of return codes set  */
+    const struct context_ctrl_t *p_ctx;     /* Context of the last one     */
+    uint32_t                     ret_code;  /* Value of the last one       */
+};
+
+/**
+ * \brief Returns the return codes set in the thread contexts so far.
+ */
+struct sched_bench_ret_codes_t sched_bench_get_ret_codes(void);
+
+/**
+ * \brief Returns whether the interrupts are masked, that is whether the
+ *        caller is in a critical section.
+ */
+bool sched_bench_is_irq_masked(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCHED_BENCH_PLATFORM_H__ */
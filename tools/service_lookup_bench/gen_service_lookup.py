@@ -0,0 +1,154 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2026, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+import argparse
+import io
+import os
+import random
+import sys
+
+TFM_ROOT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            '..', '..')
+
+sys.path.insert(0, os.path.join(TFM_ROOT_DIR, 'tools'))
+import tfm_parse_manifest_list as manifest_tool
+
+CONFIG_IMPL_TEMPLATE = os.path.join(TFM_ROOT_DIR, 'interface', 'include',
+                                    'config_impl.h.template')
+
+# Services are grouped into partitions of up to this number
+SERVICES_PER_PARTITION = 4
+
+def gen_sids(num):
+    """
+    Generate the SIDs of the services with a fixed seed. Half of them follow
+    each other, as the SIDs of the services of a vendor often do, the others
+    are random.
+    """
+
+    rng = random.Random(num)
+    base = rng.randrange(0, 1 << 31)
+    sids = [base + i for i in range(0, num // 2)]
+
+    while len(sids) < num:
+        sid = rng.randrange(0, 1 << 32)
+        if sid not in sids:
+            sids.append(sid)
+
+    return sids
+
+def gen_partitions(sids):
+    """
+    Describe the services as the manifest tool sees the partitions.
+    """
+
+    partitions = []
+    for i in range(0, len(sids), SERVICES_PER_PARTITION):
+        services = [{'sid': '0x{0:08X}'.format(sid)}
+                    for sid in sids[i:i + SERVICES_PER_PARTITION]]
+        partitions.append({'manifest': {'type': 'PSA-ROT',
+                                        'stack_size': '0x400',
+                                        'services': services}})
+
+    return partitions
+
+def check_service_lookup(sids, service_lookup):
+    """
+    Check that every SID gets a slot of the lookup table of its own, with the
+    calculation of SERVICE_LOOKUP_SLOT() in service_defs.h.
+    """
+
+    mult = int(service_lookup['mult'], 0)
+    bucket_bits = service_lookup['bucket_bits']
+    table_size = 1 << service_lookup['table_bits']
+    disp = service_lookup['disp']
+
+    if len(disp) != (1 << bucket_bits):
+        raise Exception('{} displacements for {} buckets'
+                        .format(len(disp), 1 << bucket_bits))
+
+    slots = {}
+    for sid in sids:
+        hash = manifest_tool.service_lookup_hash(sid, mult)
+        slot = ((hash >> 16) + disp[hash >> (32 - bucket_bits)]) \
+               & (table_size - 1)
+        if slot in slots:
+            raise Exception('SIDs 0x{0:08X} and 0x{1:08X} share slot {2}'
+                            .format(slots[slot], sid, slot))
+        slots[slot] = sid
+
+def gen_service_lookup(num, outdir):
+    """
+    Generate the service lookup of the benchmark for the given number of
+    services into the output directory: config_impl.h from the template of
+    the build and service_lookup_sids.h with the SIDs of the services.
+    """
+
+    sids = gen_sids(num)
+    partitions = gen_partitions(sids)
+
+    service_lookup = manifest_tool.process_service_lookup(partitions)
+    check_service_lookup(sids, service_lookup)
+
+    context = {
+        'partitions': partitions,
+        'config_impl': {
+            'CONFIG_TFM_SPM_BACKEND_IPC': '0',
+            'CONFIG_TFM_SPM_BACKEND_SFN': '1',
+            'CONFIG_TFM_CONNECTION_BASED_SERVICE_API': 0,
+            'CONFIG_TFM_MMIO_REGION_ENABLE': 0,
+            'CONFIG_TFM_FLIH_API': 0,
+            'CONFIG_TFM_SLIH_API': 0,
+        },
+        'service_lookup': service_lookup,
+        'utilities': {'donotedit_warning': manifest_tool.donotedit_warning},
+    }
+
+    os.makedirs(outdir, exist_ok=True)
+
+    template = manifest_tool.ENV.get_template(CONFIG_IMPL_TEMPLATE)
+    with io.open(os.path.join(outdir, 'config_impl.h'), 'w') as f:
+        f.write(template.render(context))
+
+    with io.open(os.path.join(outdir, 'service_lookup_sids.h'), 'w') as f:
+        f.write('/*{}*/\n\n'.format(manifest_tool.donotedit_warning))
+        f.write('#define SERVICE_LOOKUP_BENCH_SERVICES_PER_PARTITION {}\n'
+                .format(SERVICES_PER_PARTITION))
+        f.write('#define SERVICE_LOOKUP_BENCH_SIDS { \\\n')
+        for i in range(0, len(sids), 4):
+            f.write('    {}, \\\n'.format(', '.join(
+                    '0x{0:08X}U'.format(sid) for sid in sids[i:i + 4])))
+        f.write('}\n')
+
+    print('{} services: {} slots, multiplier {}, {} buckets'
+          .format(num, 1 << service_lookup['table_bits'],
+                  service_lookup['mult'], len(service_lookup['disp'])))
+
+def parse_args():
+    parser = argparse.ArgumentParser(description='Generate the service lookup of the host benchmark with the manifest tool, for services of random SIDs, and check that each SID gets a slot of its own')
+
+    parser.add_argument('-n', '--num-services'
+                        , dest='num'
+                        , required=True
+                        , type=int
+                        , help='The number of services')
+
+    parser.add_argument('-o', '--outdir'
+                        , dest='outdir'
+                        , required=True
+                        , metavar='out_dir'
+                        , help='The root directory for generated files')
+
+    return parser.parse_args()
+
+def main():
+    args = parse_args()
+
+    gen_service_lookup(args.num, args.outdir)
+
+if __name__ == '__main__':
+    main()
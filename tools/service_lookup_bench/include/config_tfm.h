@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Configuration of SPM in the host service lookup benchmark */
+
+#ifndef __CONFIG_TFM_H__
+#define __CONFIG_TFM_H__
+
+#include "config_base.h"
+
+#endif /* __CONFIG_TFM_H__ */
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Framework features of SPM in the host service lookup benchmark */
+
+#ifndef __PSA_FRAMEWORK_FEATURE_H__
+#define __PSA_FRAMEWORK_FEATURE_H__
+
+#define PSA_FRAMEWORK_HAS_MM_IOVEC 0
+
+#endif /* __PSA_FRAMEWORK_FEATURE_H__ */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* No partition is referred to by its ID in the service lookup benchmark */
+
+#ifndef __PSA_MANIFEST_PID_H__
+#define __PSA_MANIFEST_PID_H__
+
+#endif /* __PSA_MANIFEST_PID_H__ */
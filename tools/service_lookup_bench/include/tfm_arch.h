@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host replacement of the architecture layer seen by SPM in the service
+ * lookup benchmark, which runs no thread and takes no interrupt.
+ */
+
+#ifndef __TFM_ARCH_H__
+#define __TFM_ARCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* As the architecture headers of the target do */
+#include "utilities.h"
+
+/* Context control, as on the target */
+struct context_ctrl_t {
+    uint32_t                sp;
+    uint32_t                exc_ret;
+    uint32_t                sp_limit;
+    uint32_t                sp_base;
+};
+
+static inline uint32_t __save_disable_irq(void)
+{
+    return 0;
+}
+
+static inline void __restore_irq(uint32_t status)
+{
+    (void)status;
+}
+
+#endif /* __TFM_ARCH_H__ */
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* No peripheral is assigned to the partitions of the service lookup
+ * benchmark
+ */
+
+#ifndef __TFM_PERIPHERALS_DEF_H__
+#define __TFM_PERIPHERALS_DEF_H__
+
+#endif /* __TFM_PERIPHERALS_DEF_H__ */
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host test and benchmark of the service lookup by SID of SPM.
+ *
+ * SPM initialisation is built for the host over a stub loader, which loads
+ * services of SIDs generated by gen_service_lookup.py. The lookup table
+ * parameters come from the manifest tool, in config_impl.h rendered from the
+ * template of the build.
+ *
+ * The benchmark has the following modes:
+ *
+ * check: Looks up every SID, which must resolve to its own service, and as
+ *        many random SIDs as the iterations, which must not resolve to any
+ *        service unless they are one of the SIDs.
+ * bench: Reports the time of a lookup with the lookup table, and with a walk
+ *        of the service list for comparison, over random SIDs of the
+ *        services.
+ *
+ * Usage: service_lookup_bench [check|bench] [iterations]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "service_lookup_bench_platform.h"
+
+#include "config_impl.h"
+#include "load/service_defs.h"
+#include "spm.h"
+
+#define SERVICE_LOOKUP_BENCH_DEFAULT_ITERATIONS 10000000
+
+/* SIDs looked up in turn in bench mode */
+#define SERVICE_LOOKUP_BENCH_NUM_QUERIES        4096
+
+/* A benchmark mode */
+struct service_lookup_bench_mode_t {
+    const char *name;
+    int (*run)(uint32_t iterations);
+};
+
+static uint32_t queries[SERVICE_LOOKUP_BENCH_NUM_QUERIES];
+
+static uint32_t rand_state = 1;
+
+static uint32_t service_lookup_bench_rand(void)
+{
+    /* Fixed seed xorshift, so that runs are reproducible */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static uint64_t service_lookup_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/* Returns the service of the given SID as generated, NULL if there is none */
+static const struct service_t *service_lookup_bench_expected(uint32_t sid)
+{
+    size_t i;
+
+    for (i = 0; i < service_lookup_bench_num_services(); i++) {
+        if (service_lookup_bench_get_sid(i) == sid) {
+            return service_lookup_bench_get_service(i);
+        }
+    }
+
+    return NULL;
+}
+
+static int service_lookup_bench_check(uint32_t iterations)
+{
+    const struct service_t *p_service;
+    uint32_t sid;
+    size_t i;
+
+    for (i = 0; i < service_lookup_bench_num_services(); i++) {
+        sid = service_lookup_bench_get_sid(i);
+        p_service = tfm_spm_get_service_by_sid(sid);
+
+        if ((p_service != service_lookup_bench_get_service(i)) ||
+            (p_service->p_ldinf->sid != sid)) {
+            fprintf(stderr, "SID 0x%08" PRIx32 " does not resolve to its "
+                    "service\n", sid);
+            return EXIT_FAILURE;
+        }
+
+        /* The SIDs next to it land on other slots */
+        if ((tfm_spm_get_service_by_sid(sid + 1) !=
+             service_lookup_bench_expected(sid + 1)) ||
+            (tfm_spm_get_service_by_sid(sid - 1) !=
+             service_lookup_bench_expected(sid - 1))) {
+            fprintf(stderr, "A SID next to 0x%08" PRIx32 " resolves to "
+                    "another service\n", sid);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (i = 0; i < iterations; i++) {
+        sid = service_lookup_bench_rand();
+
+        if (tfm_spm_get_service_by_sid(sid) !=
+            service_lookup_bench_expected(sid)) {
+            fprintf(stderr, "SID 0x%08" PRIx32 " resolves to another "
+                    "service\n", sid);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%zu services and %" PRIu32 " random SIDs checked\n",
+           service_lookup_bench_num_services(), iterations);
+
+    return EXIT_SUCCESS;
+}
+
+/* Time of a lookup in ns */
+static double service_lookup_bench_time(
+                        const struct service_t *(*lookup)(uint32_t sid),
+                        uint32_t iterations)
+{
+    uint64_t start = service_lookup_bench_now_ns();
+    uint32_t i;
+
+    for (i = 0; i < iterations; i++) {
+        if (!lookup(queries[i % SERVICE_LOOKUP_BENCH_NUM_QUERIES])) {
+            return -1.0;
+        }
+    }
+
+    return (double)(service_lookup_bench_now_ns() - start) /
+           (double)iterations;
+}
+
+static int service_lookup_bench_bench(uint32_t iterations)
+{
+    double table_ns, walk_ns;
+    size_t i;
+
+    for (i = 0; i < SERVICE_LOOKUP_BENCH_NUM_QUERIES; i++) {
+        queries[i] = service_lookup_bench_get_sid(
+                        service_lookup_bench_rand() %
+                        service_lookup_bench_num_services());
+    }
+
+    table_ns = service_lookup_bench_time(tfm_spm_get_service_by_sid,
+                                         iterations);
+    walk_ns = service_lookup_bench_time(service_lookup_bench_walk,
+                                        iterations);
+
+    if ((table_ns < 0) || (walk_ns < 0)) {
+        fprintf(stderr, "A SID of the services is not found\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%9s %12s %12s\n", "services", "table ns", "list ns");
+    printf("%9zu %12.1f %12.1f\n", service_lookup_bench_num_services(),
+           table_ns, walk_ns);
+
+    return EXIT_SUCCESS;
+}
+
+/* Benchmark modes, the first one is the default */
+static const struct service_lookup_bench_mode_t service_lookup_bench_modes[] = {
+    {"check", service_lookup_bench_check},
+    {"bench", service_lookup_bench_bench},
+};
+
+#define SERVICE_LOOKUP_BENCH_NUM_MODES \
+    (sizeof(service_lookup_bench_modes) / sizeof(service_lookup_bench_modes[0]))
+
+int main(int argc, char *argv[])
+{
+    size_t mode = 0;
+    uint32_t iterations = SERVICE_LOOKUP_BENCH_DEFAULT_ITERATIONS;
+    int arg = 1;
+
+    if ((arg < argc) && ((argv[arg][0] < '0') || (argv[arg][0] > '9'))) {
+        for (mode = 0; mode < SERVICE_LOOKUP_BENCH_NUM_MODES; mode++) {
+            if (strcmp(argv[arg], service_lookup_bench_modes[mode].name) == 0) {
+                break;
+            }
+        }
+        arg++;
+    }
+
+    if (arg < argc) {
+        iterations = (uint32_t)strtoul(argv[arg], NULL, 0);
+        arg++;
+    }
+
+    if ((mode == SERVICE_LOOKUP_BENCH_NUM_MODES) || (iterations == 0) ||
+        (arg < argc)) {
+        fprintf(stderr, "Usage: %s [check|bench] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Loads the services and fills the lookup table, or panics */
+    (void)tfm_spm_init();
+
+    printf("%zu services, %lu table slots, %" PRIu32 " iterations\n",
+           service_lookup_bench_num_services(),
+           (unsigned long)SERVICE_LOOKUP_TABLE_SIZE, iterations);
+
+    return service_lookup_bench_modes[mode].run(iterations);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host implementations of the loader, backend and platform services SPM
+ * initialisation depends on. The partitions hold the services of the SIDs
+ * generated by gen_service_lookup.py, and are loaded into the lists as the
+ * ROM loader does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "service_lookup_bench_platform.h"
+#include "service_lookup_sids.h"
+
+#include "ffm/backend.h"
+#include "load/spm_load_api.h"
+#include "lists.h"
+#include "tfm_hal_isolation.h"
+#include "tfm_nspm.h"
+
+static const uint32_t sids[] = SERVICE_LOOKUP_BENCH_SIDS;
+
+#define SERVICE_LOOKUP_BENCH_NUM_SERVICES   (sizeof(sids) / sizeof(sids[0]))
+#define SERVICE_LOOKUP_BENCH_NUM_PARTITIONS                        \
+    ((SERVICE_LOOKUP_BENCH_NUM_SERVICES +                          \
+      SERVICE_LOOKUP_BENCH_SERVICES_PER_PARTITION - 1) /           \
+     SERVICE_LOOKUP_BENCH_SERVICES_PER_PARTITION)
+
+static struct partition_load_info_t
+                        partition_ldinfs[SERVICE_LOOKUP_BENCH_NUM_PARTITIONS];
+static struct partition_t partitions[SERVICE_LOOKUP_BENCH_NUM_PARTITIONS];
+static size_t nr_partitions_loaded;
+
+static struct service_load_info_t
+                        service_ldinfs[SERVICE_LOOKUP_BENCH_NUM_SERVICES];
+static struct service_t services[SERVICE_LOOKUP_BENCH_NUM_SERVICES];
+
+static struct service_head_t *p_services_head;
+
+struct partition_head_t partition_listhead;
+struct partition_t *p_current_partition;
+
+size_t service_lookup_bench_num_services(void)
+{
+    return SERVICE_LOOKUP_BENCH_NUM_SERVICES;
+}
+
+uint32_t service_lookup_bench_get_sid(size_t idx)
+{
+    return sids[idx];
+}
+
+const struct service_t *service_lookup_bench_get_service(size_t idx)
+{
+    return &services[idx];
+}
+
+const struct service_t *service_lookup_bench_walk(uint32_t sid)
+{
+    struct service_t *p_service;
+
+    UNI_LIST_FOREACH(p_service, p_services_head, next) {
+        if (p_service->p_ldinf->sid == sid) {
+            return p_service;
+        }
+    }
+
+    return NULL;
+}
+
+/* Loader */
+
+struct partition_t *load_a_partition_assuredly(struct partition_head_t *head)
+{
+    struct partition_load_info_t *p_ptldinf;
+    struct partition_t *partition;
+    size_t idx = nr_partitions_loaded;
+
+    if (idx == SERVICE_LOOKUP_BENCH_NUM_PARTITIONS) {
+        return NO_MORE_PARTITION;
+    }
+
+    p_ptldinf = &partition_ldinfs[idx];
+    p_ptldinf->pid = (int32_t)(256 + idx);
+    p_ptldinf->nservices = SERVICE_LOOKUP_BENCH_SERVICES_PER_PARTITION;
+    if ((idx + 1) * SERVICE_LOOKUP_BENCH_SERVICES_PER_PARTITION >
+        SERVICE_LOOKUP_BENCH_NUM_SERVICES) {
+        p_ptldinf->nservices = SERVICE_LOOKUP_BENCH_NUM_SERVICES -
+                               (idx * SERVICE_LOOKUP_BENCH_SERVICES_PER_PARTITION);
+    }
+
+    partition = &partitions[idx];
+    partition->p_ldinf = p_ptldinf;
+    nr_partitions_loaded++;
+
+    UNI_LIST_INSERT_AFTER(head, partition, next);
+
+    return partition;
+}
+
+uint32_t load_services_assuredly(struct partition_t *p_partition,
+                                 struct service_head_t *services_listhead,
+                                 struct service_t **stateless_services_ref_tbl,
+                                 size_t ref_tbl_size)
+{
+    size_t first = (size_t)(p_partition - partitions) *
+                   SERVICE_LOOKUP_BENCH_SERVICES_PER_PARTITION;
+    size_t i;
+
+    (void)stateless_services_ref_tbl;
+    (void)ref_tbl_size;
+
+    p_services_head = services_listhead;
+
+    for (i = first; i < first + p_partition->p_ldinf->nservices; i++) {
+        service_ldinfs[i].sid = sids[i];
+        services[i].p_ldinf = &service_ldinfs[i];
+        services[i].partition = p_partition;
+        services[i].next = NULL;
+
+        UNI_LIST_INSERT_AFTER(services_listhead, &services[i], next);
+    }
+
+    return 0;
+}
+
+void load_irqs_assuredly(struct partition_t *p_partition)
+{
+    (void)p_partition;
+}
+
+/* Backend */
+
+void backend_init_comp_assuredly(struct partition_t *p_pt,
+                                 uint32_t service_setting)
+{
+    (void)p_pt;
+    (void)service_setting;
+}
+
+uint32_t backend_system_run(void)
+{
+    return 0;
+}
+
+/* Platform and NS agent */
+
+FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_bind_boundary(
+                                    const struct partition_load_info_t *p_ldinf,
+                                    uintptr_t *p_boundary)
+{
+    (void)p_ldinf;
+
+    *p_boundary = 0;
+
+    FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
+}
+
+void tfm_nspm_ctx_init(void)
+{
+}
+
+int32_t tfm_nspm_get_current_client_id(void)
+{
+    return -1;
+}
+
+/* Connections, which no service lookup makes */
+
+void spm_init_connection_space(void)
+{
+}
+
+struct connection_t *spm_allocate_connection(int32_t client_id)
+{
+    (void)client_id;
+
+    return NULL;
+}
+
+psa_status_t spm_validate_connection(const struct connection_t *p_connection)
+{
+    (void)p_connection;
+
+    return PSA_ERROR_GENERIC_ERROR;
+}
+
+psa_handle_t connection_to_handle(struct connection_t *p_connection)
+{
+    (void)p_connection;
+
+    return PSA_NULL_HANDLE;
+}
+
+struct connection_t *handle_to_connection(psa_handle_t handle)
+{
+    (void)handle;
+
+    return NULL;
+}
+
+/* SPM panics when two services share a slot of the lookup table */
+void tfm_core_panic(void)
+{
+    fprintf(stderr, "SPM panic\n");
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SERVICE_LOOKUP_BENCH_PLATFORM_H__
+#define __SERVICE_LOOKUP_BENCH_PLATFORM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "spm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Returns the number of services loaded by SPM.
+ */
+size_t service_lookup_bench_num_services(void);
+
+/**
+ * \brief Returns the SID of the service of the given index, in the order the
+ *        manifest tool was given the services.
+ */
+uint32_t service_lookup_bench_get_sid(size_t idx);
+
+/**
+ * \brief Returns the service SPM loaded with the given index.
+ */
+const struct service_t *service_lookup_bench_get_service(size_t idx);
+
+/**
+ * \brief Looks a service up by walking the service list SPM loaded, as SPM
+ *        did before the lookup table, for comparison.
+ */
+const struct service_t *service_lookup_bench_walk(uint32_t sid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SERVICE_LOOKUP_BENCH_PLATFORM_H__ */
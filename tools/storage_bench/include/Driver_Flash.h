@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Subset of the CMSIS flash driver interface used by the storage services
+ * when the filesystems are emulated in RAM.
+ */
+
+#ifndef __DRIVER_FLASH_H__
+#define __DRIVER_FLASH_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _ARM_FLASH_INFO {
+    void     *sector_info;  /* Sector layout information (NULL = uniform) */
+    uint32_t  sector_count; /* Number of sectors */
+    uint32_t  sector_size;  /* Uniform sector size in bytes */
+    uint32_t  page_size;    /* Optimal programming page size in bytes */
+    uint32_t  program_unit; /* Smallest programmable unit in bytes */
+    uint8_t   erased_value; /* Contents of erased memory */
+    uint8_t   reserved[3];  /* Reserved (must be zero) */
+} ARM_FLASH_INFO;
+
+typedef struct _ARM_DRIVER_FLASH {
+    ARM_FLASH_INFO * (*GetInfo)(void); /* Pointer to \ref ARM_Flash_GetInfo */
+} const ARM_DRIVER_FLASH;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRIVER_FLASH_H__ */
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Configuration of the ITS and PS services in the host storage benchmark.
+ * Any option of config_base.h can be overridden on the command line, for
+ * example with -DCMAKE_C_FLAGS="-DITS_LOG_STRUCTURED=1".
+ */
+
+#ifndef __CONFIG_TFM_H__
+#define __CONFIG_TFM_H__
+
+/* Both filesystems are emulated in RAM, with the operation counters */
+#define ITS_RAM_FS                             1
+#define PS_RAM_FS                              1
+#define ITS_RAM_FS_STATS                       1
+
+/* The NV counters of the PS rollback protection are not emulated */
+#define PS_ROLLBACK_PROTECTION                 0
+
+#include "config_base.h"
+
+#endif /* __CONFIG_TFM_H__ */
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __FLASH_LAYOUT_H__
+#define __FLASH_LAYOUT_H__
+
+/* Flash layout of the host storage benchmark. The ITS and PS areas are
+ * emulated in RAM. The sizes can be overridden on the command line.
+ */
+
+#ifndef STORAGE_BENCH_SECTOR_SIZE
+#define STORAGE_BENCH_SECTOR_SIZE     0x1000 /* 4 kB */
+#endif
+
+/* Internal Trusted Storage (ITS) Service definitions */
+#ifndef ITS_RAM_FS_SIZE
+#define ITS_RAM_FS_SIZE               (8 * STORAGE_BENCH_SECTOR_SIZE)
+#endif
+#define TFM_HAL_ITS_SECTORS_PER_BLOCK (0x1)
+#define TFM_HAL_ITS_FLASH_DRIVER      storage_bench_flash_driver
+#define TFM_HAL_ITS_PROGRAM_UNIT      (0x1)
+#define TFM_HAL_ITS_FLASH_AREA_ADDR   (0x0)
+#define TFM_HAL_ITS_FLASH_AREA_SIZE   ITS_RAM_FS_SIZE
+
+/* Protected Storage (PS) Service definitions */
+#ifndef PS_RAM_FS_SIZE
+#define PS_RAM_FS_SIZE                (16 * STORAGE_BENCH_SECTOR_SIZE)
+#endif
+#define TFM_HAL_PS_SECTORS_PER_BLOCK  (0x1)
+#define TFM_HAL_PS_FLASH_DRIVER       storage_bench_flash_driver
+#define TFM_HAL_PS_PROGRAM_UNIT       (0x1)
+#define TFM_HAL_PS_FLASH_AREA_ADDR    (0x0)
+#define TFM_HAL_PS_FLASH_AREA_SIZE    PS_RAM_FS_SIZE
+
+#endif /* __FLASH_LAYOUT_H__ */
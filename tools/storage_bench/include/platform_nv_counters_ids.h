@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PLATFORM_NV_COUNTERS_IDS_H__
+#define __PLATFORM_NV_COUNTERS_IDS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* NV counters of the benchmark platform. They are not emulated, as the PS
+ * rollback protection is disabled.
+ */
+enum tfm_nv_counter_t {
+    PLAT_NV_COUNTER_PS_0 = 0,  /* Used by PS service */
+    PLAT_NV_COUNTER_PS_1,      /* Used by PS service */
+    PLAT_NV_COUNTER_PS_2,      /* Used by PS service */
+
+    PLAT_NV_COUNTER_MAX,
+    PLAT_NV_COUNTER_BOUNDARY = UINT32_MAX  /* Fix  tfm_nv_counter_t size
+                                              to 4 bytes */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PLATFORM_NV_COUNTERS_IDS_H__ */
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PSA_FRAMEWORK_FEATURE_H__
+#define __PSA_FRAMEWORK_FEATURE_H__
+
+/* The benchmark passes the asset data through the request manager copies */
+#define PSA_FRAMEWORK_HAS_MM_IOVEC 0
+
+#endif /* __PSA_FRAMEWORK_FEATURE_H__ */
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SP_LOG_H__
+#define __TFM_SP_LOG_H__
+
+/* The log of the storage services is discarded in the benchmark */
+#define LOG_DBGFMT(...)
+#define LOG_INFFMT(...)
+#define LOG_ERRFMT(...)
+
+#endif /* __TFM_SP_LOG_H__ */
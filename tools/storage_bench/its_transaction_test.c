@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host test of the ITS transactions over the RAM flash backend. It checks that
+ * each operation of a transaction applies to the uid as left by the earlier
+ * operations, and that a failed transaction leaves the storage unchanged.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config_tfm.h"
+#include "storage_bench_platform.h"
+#include "tfm_internal_trusted_storage.h"
+#include "tfm_its_defs.h"
+
+/* Client ID of the assets stored by the test, a non-secure client */
+#define ITS_TXN_TEST_CLIENT_ID  (-1)
+
+#define ITS_TXN_TEST_CHECK(cond)                                        \
+    do {                                                                \
+        if (!(cond)) {                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,      \
+                    __LINE__, #cond);                                   \
+            return EXIT_FAILURE;                                        \
+        }                                                               \
+    } while (0)
+
+#define ITS_TXN_TEST_SET(uid, flags, size) \
+    {(uid), TFM_ITS_TRANSACTION_OP_SET, (flags), (size)}
+
+#define ITS_TXN_TEST_REMOVE(uid) \
+    {(uid), TFM_ITS_TRANSACTION_OP_REMOVE, PSA_STORAGE_FLAG_NONE, 0}
+
+#define ITS_TXN_TEST_NUM_OPS(ops)  (sizeof(ops) / sizeof((ops)[0]))
+
+static const uint8_t data_a[] = "first value";
+static const uint8_t data_b[] = "second, longer value";
+
+static psa_status_t its_txn_test_run(const struct tfm_its_transaction_op_t *ops,
+                                     size_t num_ops,
+                                     const uint8_t *data,
+                                     size_t data_length)
+{
+    storage_bench_its_request(data, NULL);
+
+    return tfm_its_transaction(ITS_TXN_TEST_CLIENT_ID, ops, num_ops,
+                               data_length);
+}
+
+static psa_status_t its_txn_test_set(psa_storage_uid_t uid,
+                                     const uint8_t *data,
+                                     size_t size)
+{
+    storage_bench_its_request(data, NULL);
+
+    return tfm_its_set(ITS_TXN_TEST_CLIENT_ID, uid, size,
+                       PSA_STORAGE_FLAG_NONE);
+}
+
+static psa_status_t its_txn_test_get(psa_storage_uid_t uid,
+                                     uint8_t *data,
+                                     size_t size,
+                                     size_t *data_length)
+{
+    storage_bench_its_request(NULL, data);
+
+    return tfm_its_get(ITS_TXN_TEST_CLIENT_ID, uid, 0, size, data_length);
+}
+
+static psa_status_t its_txn_test_get_info(psa_storage_uid_t uid)
+{
+    struct psa_storage_info_t info;
+
+    return tfm_its_get_info(ITS_TXN_TEST_CLIENT_ID, uid, &info);
+}
+
+int main(void)
+{
+    uint8_t data[sizeof(data_a) + sizeof(data_b)];
+    uint8_t get_data[sizeof(data)];
+    size_t data_length;
+
+    ITS_TXN_TEST_CHECK(tfm_its_init() == PSA_SUCCESS);
+
+    /* A uid set and then removed by the same transaction is not stored */
+    {
+        const struct tfm_its_transaction_op_t ops[] = {
+            ITS_TXN_TEST_SET(1, PSA_STORAGE_FLAG_NONE, sizeof(data_a)),
+            ITS_TXN_TEST_REMOVE(1),
+        };
+
+        ITS_TXN_TEST_CHECK(its_txn_test_run(ops, ITS_TXN_TEST_NUM_OPS(ops),
+                                            data_a, sizeof(data_a))
+                           == PSA_SUCCESS);
+        ITS_TXN_TEST_CHECK(its_txn_test_get_info(1)
+                           == PSA_ERROR_DOES_NOT_EXIST);
+    }
+
+    /* A uid removed twice does not exist for the second removal, so the
+     * transaction fails and the uid is kept.
+     */
+    {
+        const struct tfm_its_transaction_op_t ops[] = {
+            ITS_TXN_TEST_REMOVE(2),
+            ITS_TXN_TEST_REMOVE(2),
+        };
+
+        ITS_TXN_TEST_CHECK(its_txn_test_set(2, data_a, sizeof(data_a))
+                           == PSA_SUCCESS);
+        ITS_TXN_TEST_CHECK(its_txn_test_run(ops, ITS_TXN_TEST_NUM_OPS(ops),
+                                            NULL, 0)
+                           == PSA_ERROR_DOES_NOT_EXIST);
+        ITS_TXN_TEST_CHECK(its_txn_test_get_info(2) == PSA_SUCCESS);
+    }
+
+    /* A uid removed and then set again by the same transaction holds the new
+     * value.
+     */
+    {
+        const struct tfm_its_transaction_op_t ops[] = {
+            ITS_TXN_TEST_REMOVE(2),
+            ITS_TXN_TEST_SET(2, PSA_STORAGE_FLAG_NONE, sizeof(data_b)),
+        };
+
+        ITS_TXN_TEST_CHECK(its_txn_test_run(ops, ITS_TXN_TEST_NUM_OPS(ops),
+                                            data_b, sizeof(data_b))
+                           == PSA_SUCCESS);
+        ITS_TXN_TEST_CHECK(its_txn_test_get(2, get_data, sizeof(data_b),
+                                            &data_length) == PSA_SUCCESS);
+        ITS_TXN_TEST_CHECK((data_length == sizeof(data_b)) &&
+                           (memcmp(get_data, data_b, sizeof(data_b)) == 0));
+    }
+
+    /* A uid set with the write once flag cannot be set again, nor removed, by
+     * the later operations of the same transaction. The whole transaction
+     * fails, so the uid is not stored.
+     */
+    {
+        const struct tfm_its_transaction_op_t set_ops[] = {
+            ITS_TXN_TEST_SET(3, PSA_STORAGE_FLAG_WRITE_ONCE, sizeof(data_a)),
+            ITS_TXN_TEST_SET(3, PSA_STORAGE_FLAG_NONE, sizeof(data_b)),
+        };
+        const struct tfm_its_transaction_op_t remove_ops[] = {
+            ITS_TXN_TEST_SET(3, PSA_STORAGE_FLAG_WRITE_ONCE, sizeof(data_a)),
+            ITS_TXN_TEST_REMOVE(3),
+        };
+
+        (void)memcpy(data, data_a, sizeof(data_a));
+        (void)memcpy(data + sizeof(data_a), data_b, sizeof(data_b));
+
+        ITS_TXN_TEST_CHECK(its_txn_test_run(set_ops,
+                                            ITS_TXN_TEST_NUM_OPS(set_ops),
+                                            data, sizeof(data))
+                           == PSA_ERROR_NOT_PERMITTED);
+        ITS_TXN_TEST_CHECK(its_txn_test_get_info(3)
+                           == PSA_ERROR_DOES_NOT_EXIST);
+
+        ITS_TXN_TEST_CHECK(its_txn_test_run(remove_ops,
+                                            ITS_TXN_TEST_NUM_OPS(remove_ops),
+                                            data_a, sizeof(data_a))
+                           == PSA_ERROR_NOT_PERMITTED);
+        ITS_TXN_TEST_CHECK(its_txn_test_get_info(3)
+                           == PSA_ERROR_DOES_NOT_EXIST);
+    }
+
+    /* When a uid is set twice, the last value applies */
+    {
+        const struct tfm_its_transaction_op_t ops[] = {
+            ITS_TXN_TEST_SET(4, PSA_STORAGE_FLAG_NONE, sizeof(data_a)),
+            ITS_TXN_TEST_SET(4, PSA_STORAGE_FLAG_NONE, sizeof(data_b)),
+        };
+
+        (void)memcpy(data, data_a, sizeof(data_a));
+        (void)memcpy(data + sizeof(data_a), data_b, sizeof(data_b));
+
+        ITS_TXN_TEST_CHECK(its_txn_test_run(ops, ITS_TXN_TEST_NUM_OPS(ops),
+                                            data, sizeof(data))
+                           == PSA_SUCCESS);
+        ITS_TXN_TEST_CHECK(its_txn_test_get(4, get_data, sizeof(data_b),
+                                            &data_length) == PSA_SUCCESS);
+        ITS_TXN_TEST_CHECK((data_length == sizeof(data_b)) &&
+                           (memcmp(get_data, data_b, sizeof(data_b)) == 0));
+    }
+
+    printf("ITS transaction test passed\n");
+
+    return EXIT_SUCCESS;
+}
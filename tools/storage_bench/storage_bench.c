@@ -0,0 +1,630 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host benchmark of the ITS and PS services over the RAM flash backend.
+ *
+ * The flash traffic is counted by the RAM flash backend. The benchmark has the
+ * following modes:
+ *
+ * ops:    For each service, asset size and fill level, stores the assets, then
+ *         measures overwrites, reads, info lookups, removals and creations of
+ *         random assets. It reports the operations per second, the flash bytes
+ *         read and programmed per operation and the block erases per 1000
+ *         operations.
+ * lookup: For an increasing number of stored assets, measures the info
+ *         lookups of stored and of absent UIDs. It reports the time and the
+ *         flash bytes read per lookup.
+ * wa:     For each service and asset size, with half of the assets stored,
+ *         measures a stream of overwrites of random assets. It reports the
+ *         write amplification, that is the flash bytes programmed per byte of
+ *         asset data written, and the block erases per 1000 overwrites.
+ *
+ * Usage: storage_bench [ops|lookup|wa] [iterations]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config_tfm.h"
+#include "flash/its_flash_ram.h"
+#include "flash_layout.h"
+#include "storage_bench_platform.h"
+#include "tfm_internal_trusted_storage.h"
+#include "ps_object_system.h"
+
+#define STORAGE_BENCH_DEFAULT_ITERATIONS 1000
+
+/* Client ID of the assets stored by the benchmark, a non-secure client */
+#define STORAGE_BENCH_CLIENT_ID          (-1)
+
+/* Size of the assets stored by the lookup mode */
+#define STORAGE_BENCH_LOOKUP_ASSET_SIZE  16
+
+/* Percentage of the maximum number of assets stored by the wa mode */
+#define STORAGE_BENCH_WA_FILL_LEVEL      50
+
+#define STORAGE_BENCH_MAX_ASSET_SIZE \
+    ((ITS_MAX_ASSET_SIZE > PS_MAX_ASSET_SIZE) ? ITS_MAX_ASSET_SIZE \
+                                              : PS_MAX_ASSET_SIZE)
+
+enum storage_bench_op_t {
+    STORAGE_BENCH_OP_OVERWRITE = 0,
+    STORAGE_BENCH_OP_GET,
+    STORAGE_BENCH_OP_GET_INFO,
+    STORAGE_BENCH_OP_REMOVE,
+    STORAGE_BENCH_OP_CREATE,
+    STORAGE_BENCH_OP_COUNT
+};
+
+static const char *const storage_bench_op_names[STORAGE_BENCH_OP_COUNT] = {
+    "overwrite", "get", "get_info", "remove", "create"
+};
+
+/* Operations of a storage service */
+struct storage_bench_service_t {
+    const char *name;
+    size_t max_asset_size;
+    size_t num_assets;
+    psa_status_t (*set)(psa_storage_uid_t uid, const uint8_t *data,
+                        size_t size);
+    psa_status_t (*get)(psa_storage_uid_t uid, uint8_t *data, size_t size);
+    psa_status_t (*get_info)(psa_storage_uid_t uid);
+    psa_status_t (*remove)(psa_storage_uid_t uid);
+};
+
+/* Accumulated measurements of an operation */
+struct storage_bench_result_t {
+    uint32_t ops;
+    uint64_t ns;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+    uint64_t erases;
+};
+
+static uint8_t set_data[STORAGE_BENCH_MAX_ASSET_SIZE];
+static uint8_t get_data[STORAGE_BENCH_MAX_ASSET_SIZE];
+static uint32_t rand_state = 1;
+
+static uint32_t storage_bench_rand(void)
+{
+    /* Fixed seed xorshift, so that runs are comparable */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return rand_state;
+}
+
+static uint64_t storage_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static psa_status_t its_set(psa_storage_uid_t uid, const uint8_t *data,
+                            size_t size)
+{
+    storage_bench_its_request(data, NULL);
+
+    return tfm_its_set(STORAGE_BENCH_CLIENT_ID, uid, size,
+                       PSA_STORAGE_FLAG_NONE);
+}
+
+static psa_status_t its_get(psa_storage_uid_t uid, uint8_t *data, size_t size)
+{
+    size_t data_length;
+
+    storage_bench_its_request(NULL, data);
+
+    return tfm_its_get(STORAGE_BENCH_CLIENT_ID, uid, 0, size, &data_length);
+}
+
+static psa_status_t its_get_info(psa_storage_uid_t uid)
+{
+    struct psa_storage_info_t info;
+
+    return tfm_its_get_info(STORAGE_BENCH_CLIENT_ID, uid, &info);
+}
+
+static psa_status_t its_remove(psa_storage_uid_t uid)
+{
+    return tfm_its_remove(STORAGE_BENCH_CLIENT_ID, uid);
+}
+
+static psa_status_t ps_set(psa_storage_uid_t uid, const uint8_t *data,
+                           size_t size)
+{
+    storage_bench_ps_request(data, NULL);
+
+    return ps_object_create(uid, STORAGE_BENCH_CLIENT_ID,
+                            PSA_STORAGE_FLAG_NONE, size);
+}
+
+static psa_status_t ps_get(psa_storage_uid_t uid, uint8_t *data, size_t size)
+{
+    size_t data_length;
+
+    storage_bench_ps_request(NULL, data);
+
+    return ps_object_read(uid, STORAGE_BENCH_CLIENT_ID, 0, size,
+                          &data_length);
+}
+
+static psa_status_t ps_get_info(psa_storage_uid_t uid)
+{
+    struct psa_storage_info_t info;
+
+    return ps_object_get_info(uid, STORAGE_BENCH_CLIENT_ID, &info);
+}
+
+static psa_status_t ps_remove(psa_storage_uid_t uid)
+{
+    return ps_object_delete(uid, STORAGE_BENCH_CLIENT_ID);
+}
+
+static const struct storage_bench_service_t storage_bench_services[] = {
+    {
+        .name = "ITS",
+        .max_asset_size = ITS_MAX_ASSET_SIZE,
+        .num_assets = ITS_NUM_ASSETS,
+        .set = its_set,
+        .get = its_get,
+        .get_info = its_get_info,
+        .remove = its_remove,
+    },
+    {
+        .name = "PS",
+        .max_asset_size = PS_MAX_ASSET_SIZE,
+        .num_assets = PS_NUM_ASSETS,
+        .set = ps_set,
+        .get = ps_get,
+        .get_info = ps_get_info,
+        .remove = ps_remove,
+    },
+};
+
+#define STORAGE_BENCH_NUM_SERVICES \
+    (sizeof(storage_bench_services) / sizeof(storage_bench_services[0]))
+
+/* Percentages of the maximum number of assets stored during a measurement.
+ * A PS holding PS_NUM_ASSETS objects cannot replace one, as the object table
+ * update needs a file beyond the spare file kept by ITS, so the highest level
+ * stays below full.
+ */
+static const uint32_t storage_bench_fill_levels[] = {25, 50, 90};
+
+/**
+ * \brief Runs one operation and adds its duration and flash traffic to the
+ *        result.
+ */
+static psa_status_t storage_bench_run_op(
+                                    const struct storage_bench_service_t *svc,
+                                    enum storage_bench_op_t op,
+                                    psa_storage_uid_t uid,
+                                    size_t size,
+                                    struct storage_bench_result_t *result)
+{
+    struct its_flash_ram_stats_t stats;
+    psa_status_t status;
+    uint64_t start;
+
+    its_flash_ram_reset_stats();
+    start = storage_bench_now_ns();
+
+    switch (op) {
+    case STORAGE_BENCH_OP_OVERWRITE:
+    case STORAGE_BENCH_OP_CREATE:
+        status = svc->set(uid, set_data, size);
+        break;
+    case STORAGE_BENCH_OP_GET:
+        status = svc->get(uid, get_data, size);
+        break;
+    case STORAGE_BENCH_OP_GET_INFO:
+        status = svc->get_info(uid);
+        break;
+    case STORAGE_BENCH_OP_REMOVE:
+    default:
+        status = svc->remove(uid);
+        break;
+    }
+
+    result->ns += storage_bench_now_ns() - start;
+    its_flash_ram_get_stats(&stats);
+
+    result->ops++;
+    result->read_bytes += stats.read_bytes;
+    result->write_bytes += stats.write_bytes;
+    result->erases += stats.erases;
+
+    return status;
+}
+
+/**
+ * \brief Measures the operations of a service on assets of the given size,
+ *        with num_stored assets stored in an empty service.
+ */
+static psa_status_t storage_bench_run_case(
+                                    const struct storage_bench_service_t *svc,
+                                    size_t size,
+                                    uint32_t num_stored,
+                                    uint32_t iterations,
+                                    struct storage_bench_result_t *results)
+{
+    psa_status_t status;
+    psa_storage_uid_t uid;
+    uint32_t i;
+
+    for (uid = 1; uid <= num_stored; uid++) {
+        status = svc->set(uid, set_data, size);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    for (i = 0; i < iterations; i++) {
+        uid = 1 + (storage_bench_rand() % num_stored);
+        status = storage_bench_run_op(svc, STORAGE_BENCH_OP_OVERWRITE, uid,
+                                      size,
+                                      &results[STORAGE_BENCH_OP_OVERWRITE]);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    for (i = 0; i < iterations; i++) {
+        uid = 1 + (storage_bench_rand() % num_stored);
+        status = storage_bench_run_op(svc, STORAGE_BENCH_OP_GET, uid, size,
+                                      &results[STORAGE_BENCH_OP_GET]);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        if (memcmp(get_data, set_data, size) != 0) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+    }
+
+    for (i = 0; i < iterations; i++) {
+        uid = 1 + (storage_bench_rand() % num_stored);
+        status = storage_bench_run_op(svc, STORAGE_BENCH_OP_GET_INFO, uid,
+                                      size,
+                                      &results[STORAGE_BENCH_OP_GET_INFO]);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    for (i = 0; i < iterations; i++) {
+        uid = 1 + (storage_bench_rand() % num_stored);
+        status = storage_bench_run_op(svc, STORAGE_BENCH_OP_REMOVE, uid, size,
+                                      &results[STORAGE_BENCH_OP_REMOVE]);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        status = storage_bench_run_op(svc, STORAGE_BENCH_OP_CREATE, uid, size,
+                                      &results[STORAGE_BENCH_OP_CREATE]);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+static void storage_bench_print_result(
+                                    const struct storage_bench_service_t *svc,
+                                    enum storage_bench_op_t op,
+                                    size_t size,
+                                    uint32_t fill_level,
+                                    const struct storage_bench_result_t *result)
+{
+    double ops = (double)result->ops;
+
+    printf("%-4s %-9s %6zu %4" PRIu32 "%% %12.0f %12.1f %12.1f %10.2f\n",
+           svc->name, storage_bench_op_names[op], size, fill_level,
+           (result->ns != 0) ? (ops * 1e9) / (double)result->ns : 0.0,
+           (double)result->read_bytes / ops,
+           (double)result->write_bytes / ops,
+           ((double)result->erases * 1000.0) / ops);
+}
+
+/**
+ * \brief Removes all the assets of a service.
+ */
+static void storage_bench_remove_all(const struct storage_bench_service_t *svc)
+{
+    psa_storage_uid_t uid;
+
+    for (uid = 1; uid <= svc->num_assets; uid++) {
+        (void)svc->remove(uid);
+    }
+}
+
+/**
+ * \brief Runs the ops mode.
+ */
+static psa_status_t storage_bench_ops(uint32_t iterations)
+{
+    struct storage_bench_result_t results[STORAGE_BENCH_OP_COUNT];
+    const struct storage_bench_service_t *svc;
+    uint32_t num_stored;
+    psa_status_t status;
+    size_t sizes[3];
+    size_t s, f, i;
+    int op;
+
+    printf("%-4s %-9s %6s %5s %12s %12s %12s %10s\n",
+           "svc", "op", "size", "fill", "ops/s", "read B/op", "prog B/op",
+           "erases/1k");
+
+    for (i = 0; i < STORAGE_BENCH_NUM_SERVICES; i++) {
+        svc = &storage_bench_services[i];
+
+        /* A small, a medium and the largest asset size */
+        sizes[0] = 16;
+        sizes[1] = svc->max_asset_size / 4;
+        sizes[2] = svc->max_asset_size;
+
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            for (f = 0; f < sizeof(storage_bench_fill_levels) /
+                            sizeof(storage_bench_fill_levels[0]); f++) {
+                num_stored = (uint32_t)((svc->num_assets *
+                                         storage_bench_fill_levels[f]) / 100);
+                if (num_stored == 0) {
+                    num_stored = 1;
+                }
+
+                (void)memset(results, 0, sizeof(results));
+
+                storage_bench_remove_all(svc);
+                status = storage_bench_run_case(svc, sizes[s], num_stored,
+                                                iterations, results);
+                if (status != PSA_SUCCESS) {
+                    fprintf(stderr, "%s: %zu byte assets at %" PRIu32
+                            "%% failed: %d\n", svc->name, sizes[s],
+                            storage_bench_fill_levels[f], (int)status);
+                    return status;
+                }
+
+                for (op = 0; op < STORAGE_BENCH_OP_COUNT; op++) {
+                    storage_bench_print_result(svc,
+                                               (enum storage_bench_op_t)op,
+                                               sizes[s],
+                                               storage_bench_fill_levels[f],
+                                               &results[op]);
+                }
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Runs the lookup mode.
+ */
+static psa_status_t storage_bench_lookup(uint32_t iterations)
+{
+    struct storage_bench_result_t hit;
+    struct storage_bench_result_t miss;
+    const struct storage_bench_service_t *svc;
+    psa_storage_uid_t uid;
+    uint32_t num_stored;
+    psa_status_t status;
+    size_t i;
+    uint32_t n;
+
+    printf("%-4s %6s %12s %12s %12s %12s\n",
+           "svc", "stored", "hit ns", "hit read B", "miss ns", "miss read B");
+
+    for (i = 0; i < STORAGE_BENCH_NUM_SERVICES; i++) {
+        svc = &storage_bench_services[i];
+
+        storage_bench_remove_all(svc);
+        num_stored = 0;
+
+        /* Double the number of stored assets up to the maximum */
+        while (num_stored < svc->num_assets) {
+            n = (num_stored == 0) ? 1 : (num_stored * 2);
+            if (n > svc->num_assets) {
+                n = (uint32_t)svc->num_assets;
+            }
+
+            for (uid = num_stored + 1; uid <= n; uid++) {
+                status = svc->set(uid, set_data,
+                                  STORAGE_BENCH_LOOKUP_ASSET_SIZE);
+                if (status != PSA_SUCCESS) {
+                    fprintf(stderr, "%s: storing asset %" PRIu32
+                            " failed: %d\n", svc->name, (uint32_t)uid,
+                            (int)status);
+                    return status;
+                }
+            }
+            num_stored = n;
+
+            (void)memset(&hit, 0, sizeof(hit));
+            (void)memset(&miss, 0, sizeof(miss));
+
+            for (n = 0; n < iterations; n++) {
+                uid = 1 + (storage_bench_rand() % num_stored);
+                status = storage_bench_run_op(svc, STORAGE_BENCH_OP_GET_INFO,
+                                              uid, 0, &hit);
+                if (status != PSA_SUCCESS) {
+                    return status;
+                }
+
+                /* UIDs above the maximum number of assets are never stored */
+                uid = svc->num_assets + 1 + (storage_bench_rand() % 1000);
+                status = storage_bench_run_op(svc, STORAGE_BENCH_OP_GET_INFO,
+                                              uid, 0, &miss);
+                if (status != PSA_ERROR_DOES_NOT_EXIST) {
+                    return (status == PSA_SUCCESS) ? PSA_ERROR_GENERIC_ERROR
+                                                   : status;
+                }
+            }
+
+            printf("%-4s %6" PRIu32 " %12.0f %12.1f %12.0f %12.1f\n",
+                   svc->name, num_stored,
+                   (double)hit.ns / (double)hit.ops,
+                   (double)hit.read_bytes / (double)hit.ops,
+                   (double)miss.ns / (double)miss.ops,
+                   (double)miss.read_bytes / (double)miss.ops);
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Runs the wa mode.
+ */
+static psa_status_t storage_bench_wa(uint32_t iterations)
+{
+    struct storage_bench_result_t result;
+    const struct storage_bench_service_t *svc;
+    psa_storage_uid_t uid;
+    uint32_t num_stored;
+    psa_status_t status;
+    size_t sizes[3];
+    size_t s, i;
+    uint32_t n;
+
+    printf("%-4s %6s %5s %12s %12s %8s %10s\n",
+           "svc", "size", "fill", "data B/op", "prog B/op", "WA", "erases/1k");
+
+    for (i = 0; i < STORAGE_BENCH_NUM_SERVICES; i++) {
+        svc = &storage_bench_services[i];
+
+        sizes[0] = 16;
+        sizes[1] = svc->max_asset_size / 4;
+        sizes[2] = svc->max_asset_size;
+
+        num_stored = (uint32_t)((svc->num_assets *
+                                 STORAGE_BENCH_WA_FILL_LEVEL) / 100);
+        if (num_stored == 0) {
+            num_stored = 1;
+        }
+
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            storage_bench_remove_all(svc);
+
+            for (uid = 1; uid <= num_stored; uid++) {
+                status = svc->set(uid, set_data, sizes[s]);
+                if (status != PSA_SUCCESS) {
+                    fprintf(stderr, "%s: storing asset %" PRIu32
+                            " failed: %d\n", svc->name, (uint32_t)uid,
+                            (int)status);
+                    return status;
+                }
+            }
+
+            (void)memset(&result, 0, sizeof(result));
+
+            for (n = 0; n < iterations; n++) {
+                uid = 1 + (storage_bench_rand() % num_stored);
+                status = storage_bench_run_op(svc, STORAGE_BENCH_OP_OVERWRITE,
+                                              uid, sizes[s], &result);
+                if (status != PSA_SUCCESS) {
+                    fprintf(stderr, "%s: %zu byte overwrite failed: %d\n",
+                            svc->name, sizes[s], (int)status);
+                    return status;
+                }
+            }
+
+            printf("%-4s %6zu %4d%% %12zu %12.1f %8.2f %10.2f\n",
+                   svc->name, sizes[s], STORAGE_BENCH_WA_FILL_LEVEL,
+                   sizes[s],
+                   (double)result.write_bytes / (double)result.ops,
+                   (double)result.write_bytes /
+                   ((double)result.ops * (double)sizes[s]),
+                   ((double)result.erases * 1000.0) / (double)result.ops);
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Benchmark modes, the first one is the default */
+static const struct {
+    const char *name;
+    psa_status_t (*run)(uint32_t iterations);
+} storage_bench_modes[] = {
+    {"ops", storage_bench_ops},
+    {"lookup", storage_bench_lookup},
+    {"wa", storage_bench_wa},
+};
+
+#define STORAGE_BENCH_NUM_MODES \
+    (sizeof(storage_bench_modes) / sizeof(storage_bench_modes[0]))
+
+int main(int argc, char *argv[])
+{
+    size_t mode = 0;
+    uint32_t iterations = STORAGE_BENCH_DEFAULT_ITERATIONS;
+    psa_status_t status;
+    int arg = 1;
+    size_t i;
+
+    if ((arg < argc) && ((argv[arg][0] < '0') || (argv[arg][0] > '9'))) {
+        for (mode = 0; mode < STORAGE_BENCH_NUM_MODES; mode++) {
+            if (strcmp(argv[arg], storage_bench_modes[mode].name) == 0) {
+                break;
+            }
+        }
+        arg++;
+    }
+
+    if (arg < argc) {
+        iterations = (uint32_t)strtoul(argv[arg], NULL, 0);
+        arg++;
+    }
+
+    if ((mode == STORAGE_BENCH_NUM_MODES) || (iterations == 0) ||
+        (arg < argc)) {
+        fprintf(stderr, "Usage: %s [ops|lookup|wa] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < sizeof(set_data); i++) {
+        set_data[i] = (uint8_t)storage_bench_rand();
+    }
+
+    /* Create the ITS and PS filesystems and the PS object table */
+    status = tfm_its_init();
+    if (status == PSA_SUCCESS) {
+        status = ps_system_prepare();
+        if (status != PSA_SUCCESS) {
+            status = ps_system_wipe_all();
+            if (status == PSA_SUCCESS) {
+                status = ps_system_prepare();
+            }
+        }
+    }
+    if (status != PSA_SUCCESS) {
+        fprintf(stderr, "Storage initialisation failed: %d\n", (int)status);
+        return EXIT_FAILURE;
+    }
+
+    printf("ITS: %u kB in %u kB blocks, PS: %u kB in %u kB blocks, "
+           "%" PRIu32 " iterations\n",
+           (unsigned int)(ITS_RAM_FS_SIZE / 1024),
+           (unsigned int)(STORAGE_BENCH_SECTOR_SIZE / 1024),
+           (unsigned int)(PS_RAM_FS_SIZE / 1024),
+           (unsigned int)(STORAGE_BENCH_SECTOR_SIZE / 1024),
+           iterations);
+
+    status = storage_bench_modes[mode].run(iterations);
+
+    return (status == PSA_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host implementations of the platform and framework services the ITS and PS
+ * partitions depend on: the flash driver information, the request managers
+ * and the PS calls to ITS.
+ */
+
+#include <string.h>
+
+#include "storage_bench_platform.h"
+
+#include "Driver_Flash.h"
+#include "flash_layout.h"
+#include "psa/internal_trusted_storage.h"
+#include "psa_manifest/pid.h"
+#include "tfm_internal_trusted_storage.h"
+#include "tfm_its_req_mngr.h"
+#include "tfm_ps_req_mngr.h"
+
+static ARM_FLASH_INFO storage_bench_flash_info = {
+    .sector_info = NULL,
+    .sector_count = 0,
+    .sector_size = STORAGE_BENCH_SECTOR_SIZE,
+    .page_size = STORAGE_BENCH_SECTOR_SIZE,
+    .program_unit = 1,
+    .erased_value = 0xFF,
+};
+
+static ARM_FLASH_INFO *storage_bench_flash_get_info(void)
+{
+    return &storage_bench_flash_info;
+}
+
+/* Only used for its information, as the filesystems are emulated in RAM */
+ARM_DRIVER_FLASH storage_bench_flash_driver = {
+    .GetInfo = storage_bench_flash_get_info,
+};
+
+/* Client buffers of the current ITS and PS requests */
+static const uint8_t *its_in_data;
+static uint8_t *its_out_data;
+static const uint8_t *ps_in_data;
+static uint8_t *ps_out_data;
+
+void storage_bench_its_request(const uint8_t *in_data, uint8_t *out_data)
+{
+    its_in_data = in_data;
+    its_out_data = out_data;
+}
+
+void storage_bench_ps_request(const uint8_t *in_data, uint8_t *out_data)
+{
+    ps_in_data = in_data;
+    ps_out_data = out_data;
+}
+
+size_t its_req_mngr_read(uint8_t *buf, size_t num_bytes)
+{
+    (void)memcpy(buf, its_in_data, num_bytes);
+    its_in_data += num_bytes;
+
+    return num_bytes;
+}
+
+void its_req_mngr_write(const uint8_t *buf, size_t num_bytes)
+{
+    (void)memcpy(its_out_data, buf, num_bytes);
+    its_out_data += num_bytes;
+}
+
+psa_status_t ps_req_mngr_read_asset_data(uint8_t *out_data, uint32_t size)
+{
+    (void)memcpy(out_data, ps_in_data, size);
+    ps_in_data += size;
+
+    return PSA_SUCCESS;
+}
+
+void ps_req_mngr_write_asset_data(const uint8_t *in_data, uint32_t size)
+{
+    (void)memcpy(ps_out_data, in_data, size);
+    ps_out_data += size;
+}
+
+/* PS stores its objects in ITS, as the PS partition client */
+psa_status_t psa_its_set(psa_storage_uid_t uid,
+                         size_t data_length,
+                         const void *p_data,
+                         psa_storage_create_flags_t create_flags)
+{
+    storage_bench_its_request(p_data, NULL);
+
+    return tfm_its_set(TFM_SP_PS, uid, data_length, create_flags);
+}
+
+psa_status_t psa_its_get(psa_storage_uid_t uid,
+                         size_t data_offset,
+                         size_t data_size,
+                         void *p_data,
+                         size_t *p_data_length)
+{
+    storage_bench_its_request(NULL, p_data);
+
+    return tfm_its_get(TFM_SP_PS, uid, data_offset, data_size, p_data_length);
+}
+
+psa_status_t psa_its_get_info(psa_storage_uid_t uid,
+                              struct psa_storage_info_t *p_info)
+{
+    return tfm_its_get_info(TFM_SP_PS, uid, p_info);
+}
+
+psa_status_t psa_its_remove(psa_storage_uid_t uid)
+{
+    return tfm_its_remove(TFM_SP_PS, uid);
+}
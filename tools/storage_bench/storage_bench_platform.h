@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __STORAGE_BENCH_PLATFORM_H__
+#define __STORAGE_BENCH_PLATFORM_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Sets the client buffers of the next ITS request.
+ *
+ * \details The ITS request manager reads the asset data of a set request from
+ *          in_data, and writes the asset data of a get request to out_data,
+ *          as it would from/to the client iovecs.
+ *
+ * \param[in]  in_data   Asset data to be set, or NULL
+ * \param[out] out_data  Buffer for the asset data to be read, or NULL
+ */
+void storage_bench_its_request(const uint8_t *in_data, uint8_t *out_data);
+
+/**
+ * \brief Sets the client buffers of the next PS request.
+ *
+ * \details Same as \ref storage_bench_its_request, for the PS request manager.
+ *
+ * \param[in]  in_data   Asset data to be set, or NULL
+ * \param[out] out_data  Buffer for the asset data to be read, or NULL
+ */
+void storage_bench_ps_request(const uint8_t *in_data, uint8_t *out_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STORAGE_BENCH_PLATFORM_H__ */
@@ -531,6 +531,7 @@ def process_partition_manifests(manifest_lists, configs):
     context['partitions'] = partition_list
     context['config_impl'] = config_impl
     context['stateless_services'] = process_stateless_services(partition_list)
+    context['service_lookup'] = process_service_lookup(partition_list)
 
     return context
 
@@ -718,6 +719,93 @@ def process_stateless_services(partitions):
 
     return reordered_stateless_services
 
+def service_lookup_hash(sid, mult):
+    """
+    Keep the same as SERVICE_LOOKUP_HASH() in service_defs.h
+    """
+    return (sid * mult) & 0xFFFFFFFF
+
+def place_service_lookup_buckets(buckets, table_size):
+    """
+    Find a displacement for each bucket which moves all its hashes to free
+    slots. Return None if a bucket cannot be placed.
+    """
+
+    disp = [0] * len(buckets)
+    used_slots = set()
+
+    # Place the largest buckets first while most slots are free
+    for bucket in sorted(range(0, len(buckets)),
+                         key=lambda i: len(buckets[i]), reverse=True):
+        if len(buckets[bucket]) == 0:
+            break
+
+        for d in range(0, table_size):
+            slots = set((h + d) & (table_size - 1) for h in buckets[bucket])
+            if len(slots) == len(buckets[bucket]) and not (slots & used_slots):
+                break
+        else:
+            return None
+
+        disp[bucket] = d
+        used_slots |= slots
+
+    return disp
+
+def process_service_lookup(partitions):
+    """
+    This function generates a perfect hash of the SIDs of all the services, so
+    that SPM looks up a service by SID in constant time.
+    A SID is hashed into a bucket, and the displacement of the bucket moves the
+    SID to a slot that no other SID occupies:
+
+        hash   = SID * mult
+        bucket = hash >> (32 - bucket_bits)
+        slot   = ((hash >> 16) + disp[bucket]) & ((1 << table_bits) - 1)
+
+    Keep the calculation the same as SERVICE_LOOKUP_SLOT() in service_defs.h.
+    """
+
+    SERVICE_LOOKUP_TABLE_BITS_LIMIT = 16
+    SERVICE_LOOKUP_MULT_ATTEMPTS = 1000
+
+    sids = []
+    for partition in partitions:
+        for service in partition['manifest'].get('services', []):
+            sids.append(int(str(service['sid']), 0))
+
+    # The lookup table has no fewer slots than the services
+    min_table_bits = 1
+    while (1 << min_table_bits) < len(sids):
+        min_table_bits += 1
+
+    # Try a table twice as large if no hash fits in the smaller one
+    for table_bits in range(min_table_bits, min_table_bits + 2):
+        if table_bits > SERVICE_LOOKUP_TABLE_BITS_LIMIT:
+            break
+
+        table_size = 1 << table_bits
+        bucket_bits = max(table_bits - 1, 1)
+
+        for attempt in range(0, SERVICE_LOOKUP_MULT_ATTEMPTS):
+            # Odd multipliers derived from the golden ratio
+            mult = ((0x9E3779B1 + attempt * 0x6A09E668) & 0xFFFFFFFF) | 1
+
+            buckets = [[] for i in range(0, 1 << bucket_bits)]
+            for sid in sids:
+                hash = service_lookup_hash(sid, mult)
+                buckets[hash >> (32 - bucket_bits)].append(hash >> 16)
+
+            disp = place_service_lookup_buckets(buckets, table_size)
+            if disp is not None:
+                return {'mult': '0x{0:08x}'.format(mult),
+                        'bucket_bits': bucket_bits,
+                        'table_bits': table_bits,
+                        'disp': disp}
+
+    raise Exception('Failed to generate the service lookup table of {} services.'
+                    .format(len(sids)))
+
 def parse_args():
     parser = argparse.ArgumentParser(description='Parse secure partition manifest list and generate files listed by the file list',
                                      epilog='Note that environment variables in template files will be replaced with their values',